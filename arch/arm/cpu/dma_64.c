@@ -13,3 +13,8 @@ void arch_sync_dma_for_device(void *vaddr, size_t size,
 	else
 		v8_flush_dcache_range(start, end);
 }
+
+void arch_sync_dma_all_for_device(void)
+{
+	v8_flush_dcache_all();
+}
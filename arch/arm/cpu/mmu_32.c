@@ -606,6 +606,61 @@ void mmu_disable(void)
 	__mmu_cache_off();
 }
 
+#ifdef __PBL__
+void v7_mmu_cache_on(void);
+
+/*
+ * Enable the MMU before the PBL is relocated, so that copying and relocating
+ * it already runs with caches enabled. This can't access global variables,
+ * so it only creates 1MiB sections: sections completely inside of SDRAM are
+ * cached. Sections the PBL currently runs from outside of that, e.g. in
+ * SRAM or flash, may share the 1MiB with peripherals, so they stay uncached
+ * and are only executable. Everything else is uncached and not executable.
+ * The caller is expected to replace this mapping by disabling the MMU again
+ * and calling mmu_early_enable() once the PBL is relocated.
+ *
+ * Returns true if the MMU has been enabled.
+ */
+bool __prereloc mmu_early_enable_prereloc(unsigned long membase,
+					  unsigned long memsize)
+{
+	uint32_t *ttb = (uint32_t *)arm_mem_ttb(membase + memsize);
+	unsigned long image_start, image_end, addr;
+	unsigned long cached = memsize - OPTEE_SIZE;
+	unsigned int i;
+
+	if (arm_early_get_cpu_architecture() != CPU_ARCH_ARMv7)
+		return false;
+
+	if (get_cr() & CR_M)
+		return false;
+
+	image_start = (unsigned long)runtime_address(_text);
+	image_end = (unsigned long)runtime_address(__image_end);
+
+	for (i = 0; i <= pgd_index(0xffffffff); i++) {
+		uint32_t flags = PMD_SECT_DEF_UNCACHED | PMD_SECT_XN;
+
+		addr = i << PGDIR_SHIFT;
+
+		if (addr >= membase && addr - membase < cached &&
+		    cached - (addr - membase) >= PGDIR_SIZE)
+			flags = PMD_SECT_DEF_CACHED;
+		else if (addr + (PGDIR_SIZE - 1) >= image_start && addr < image_end)
+			flags = PMD_SECT_DEF_UNCACHED;
+
+		ttb[i] = addr | flags;
+	}
+
+	set_ttbr(ttb);
+	set_domain(DOMAIN_CLIENT);
+
+	v7_mmu_cache_on();
+
+	return true;
+}
+#endif
+
 void mmu_early_enable(unsigned long membase, unsigned long memsize)
 {
 	uint32_t *ttb = (uint32_t *)arm_mem_ttb(membase + memsize);
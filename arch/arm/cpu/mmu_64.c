@@ -20,7 +20,9 @@
 #include <memory.h>
 #include <asm/system_info.h>
 #include <linux/pagemap.h>
+#include <range.h>
 #include <tee/optee.h>
+#include <asm/sections.h>
 
 #include "mmu_64.h"
 
@@ -173,7 +175,7 @@ static unsigned long get_pte_attrs(maptype_t map_type)
 /* Splits a block PTE into table with subpages spanning the old block */
 static void split_block(uint64_t *pte, int level, bool bbm)
 {
-	uint64_t old_pte = *pte;
+	uint64_t old_pte = *pte & ~PTE_BLOCK_CONT;
 	uint64_t *new_table;
 	u64 flags = 0;
 
@@ -192,6 +194,241 @@ static void split_block(uint64_t *pte, int level, bool bbm)
 	set_pte_range(level, pte, (uint64_t)new_table, 1, PTE_TYPE_TABLE, bbm);
 }
 
+#ifndef __PBL__
+/*
+ * Tables allocated in PBL live in the early page table area and must not
+ * be passed to free()
+ */
+static void free_pte(uint64_t *table)
+{
+	unsigned long ttb = (unsigned long)get_ttb();
+
+	if ((unsigned long)table - ttb < ARM_EARLY_PAGETABLE_SIZE)
+		return;
+
+	free(table);
+}
+
+/* Number of entries which share a TLB entry when the contiguous bit is set */
+#define PTE_CONT_ENTRIES 16
+
+static bool pte_is_leaf(uint64_t pte, int level)
+{
+	return (pte & PTE_TYPE_MASK) ==
+		(level == 3 ? PTE_TYPE_PAGE : PTE_TYPE_BLOCK);
+}
+
+static uint64_t pte_attrs(uint64_t pte)
+{
+	return pte & ~(XLAT_ADDR_MASK | PTE_BLOCK_CONT | PTE_TYPE_MASK);
+}
+
+/*
+ * Check if @count entries starting at @pte are leaves with identical
+ * attributes mapping a physically contiguous range which is aligned to
+ * the size of the whole range
+ */
+static bool ptes_are_uniform(uint64_t *pte, int level, int count)
+{
+	uint64_t granularity = granule_size(level);
+	uint64_t phys = pte[0] & XLAT_ADDR_MASK;
+	uint64_t attrs = pte_attrs(pte[0]);
+	int i;
+
+	if (!IS_ALIGNED(phys, count * granularity))
+		return false;
+
+	for (i = 0; i < count; i++, phys += granularity) {
+		if (!pte_is_leaf(pte[i], level) ||
+		    pte_attrs(pte[i]) != attrs ||
+		    (pte[i] & XLAT_ADDR_MASK) != phys)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Check if the group of entries at @group mapping [virt, virt + size) is
+ * needed while it is being rewritten: it maps our code, our stack or the
+ * page table which contains the group itself.
+ */
+static bool group_in_use(const uint64_t *group, uint64_t virt, uint64_t size)
+{
+	unsigned long sp = get_sp();
+
+	return region_overlap_size(virt, size, (ulong)_stext, _etext - _stext) ||
+	       region_overlap_size(virt, size, sp - CONFIG_STACK_SIZE,
+				   2 * CONFIG_STACK_SIZE) ||
+	       region_overlap_size(virt, size, (ulong)group,
+				   PTE_CONT_ENTRIES * sizeof(*group));
+}
+
+/*
+ * Set or clear the contiguous bit on all entries of a group. Changing it
+ * on a live mapping requires break-before-make: the group is invalidated
+ * and the TLB flushed before the new entries are written. A group which
+ * is in use while doing so can't be broken. The contiguous bit is never
+ * set on such a group and only cleared in place.
+ */
+static void set_contiguous(uint64_t *group, int level, uint64_t virt,
+			   bool cont, bool bbm)
+{
+	uint64_t size = PTE_CONT_ENTRIES * granule_size(level);
+	uint64_t ptes[PTE_CONT_ENTRIES];
+	int i;
+
+	if (bbm && group_in_use(group, virt, size)) {
+		if (cont)
+			return;
+		bbm = false;
+	}
+
+	for (i = 0; i < PTE_CONT_ENTRIES; i++)
+		ptes[i] = cont ? group[i] | PTE_BLOCK_CONT :
+				 group[i] & ~PTE_BLOCK_CONT;
+
+	if (bbm) {
+		for (i = 0; i < PTE_CONT_ENTRIES; i++)
+			set_pte(&group[i], 0);
+
+		dma_flush_range(group, PTE_CONT_ENTRIES * sizeof(*group));
+		tlb_invalidate();
+	}
+
+	for (i = 0; i < PTE_CONT_ENTRIES; i++)
+		set_pte(&group[i], ptes[i]);
+
+	dma_flush_range(group, PTE_CONT_ENTRIES * sizeof(*group));
+}
+
+/*
+ * The contiguous bit must be consistent over all entries of a group, so
+ * clear it on the whole group before changing the entry @pte which maps
+ * @virt. It's set again by update_contiguous() if the group is still
+ * uniform afterwards.
+ */
+static void clear_contiguous(uint64_t *pte, int level, uint64_t virt, bool bbm)
+{
+	uint64_t *group;
+
+	if (level < 2)
+		return;
+
+	group = PTR_ALIGN_DOWN(pte, PTE_CONT_ENTRIES * sizeof(*pte));
+	if (!(*group & PTE_BLOCK_CONT))
+		return;
+
+	virt = ALIGN_DOWN(virt, PTE_CONT_ENTRIES * granule_size(level));
+	set_contiguous(group, level, virt, false, bbm);
+}
+
+/* @virt is the start of the range mapped by @table */
+static void update_contiguous(uint64_t *table, int level, uint64_t virt,
+			      bool bbm)
+{
+	unsigned idx;
+
+	for (idx = 0; idx < MAX_PTE_ENTRIES; idx += PTE_CONT_ENTRIES) {
+		uint64_t *group = &table[idx];
+		bool cont = ptes_are_uniform(group, level, PTE_CONT_ENTRIES);
+
+		if (cont == !!(*group & PTE_BLOCK_CONT))
+			continue;
+
+		set_contiguous(group, level, virt + idx * granule_size(level),
+			       cont, bbm);
+	}
+}
+
+/*
+ * Replaces a table with a block PTE if all of its entries map a uniform
+ * range, i.e. reverts a split_block() after the sub-range which caused it
+ * has been remapped to the attributes of its surroundings again.
+ */
+static bool coalesce_table(uint64_t *pte, int level, uint64_t virt, bool bbm)
+{
+	uint64_t *table = get_level_table(pte);
+
+	if (!ptes_are_uniform(table, level + 1, MAX_PTE_ENTRIES))
+		return false;
+
+	clear_contiguous(pte, level, virt, bbm);
+	set_pte_range(level, pte, table[0] & XLAT_ADDR_MASK, 1,
+		      pte_attrs(table[0]) | PTE_TYPE_BLOCK, bbm);
+
+	/* the table walker may still use the old table until invalidated */
+	tlb_invalidate();
+	free_pte(table);
+
+	return true;
+}
+
+static inline unsigned pte_index(uint64_t addr, int level)
+{
+	return (addr & level2mask(level)) >> level2shift(level);
+}
+
+/*
+ * Merge page tables covering [virt, virt + size) back into blocks where
+ * possible and set the contiguous bit on uniform runs of 16 entries in the
+ * remaining tables, so that large regions need few TLB entries even after
+ * being split.
+ */
+static void optimize_range(uint64_t virt, uint64_t size, bool bbm)
+{
+	uint64_t *ttb = get_ttb();
+	uint64_t end = virt + size;
+	uint64_t addr, next;
+
+	for (addr = virt; addr < end; addr = next) {
+		uint64_t *l0 = &ttb[pte_index(addr, 0)];
+		uint64_t *l1, *l2table;
+		uint64_t l2addr, l2next;
+
+		next = min(ALIGN_DOWN(addr, L1_XLAT_SIZE) + L1_XLAT_SIZE, end);
+
+		if (pte_type(l0) != PTE_TYPE_TABLE)
+			continue;
+
+		l1 = get_level_table(l0) + pte_index(addr, 1);
+		if (pte_type(l1) != PTE_TYPE_TABLE)
+			continue;
+
+		l2table = get_level_table(l1);
+
+		for (l2addr = addr; l2addr < next; l2addr = l2next) {
+			uint64_t *l2 = &l2table[pte_index(l2addr, 2)];
+
+			l2next = min(ALIGN_DOWN(l2addr, L2_XLAT_SIZE) + L2_XLAT_SIZE, next);
+
+			if (pte_type(l2) != PTE_TYPE_TABLE)
+				continue;
+
+			if (coalesce_table(l2, 2, l2addr, bbm))
+				continue;
+
+			update_contiguous(get_level_table(l2), 3,
+					  ALIGN_DOWN(l2addr, L2_XLAT_SIZE), bbm);
+		}
+
+		if (coalesce_table(l1, 1, addr, bbm))
+			continue;
+
+		update_contiguous(l2table, 2, ALIGN_DOWN(addr, L1_XLAT_SIZE), bbm);
+	}
+}
+#else
+/* PBL only sets up the initial mapping, which it doesn't optimize */
+static void clear_contiguous(uint64_t *pte, int level, uint64_t virt, bool bbm)
+{
+}
+
+static void optimize_range(uint64_t virt, uint64_t size, bool bbm)
+{
+}
+#endif
+
 static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 			      maptype_t map_type, bool bbm)
 {
@@ -204,6 +441,7 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 	uint64_t addr;
 	uint64_t *table;
 	uint64_t type;
+	uint64_t total;
 	int level;
 
 	addr = virt;
@@ -222,6 +460,8 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 	if (!size)
 		return 0;
 
+	total = size;
+
 	while (size) {
 		table = ttb;
 		for (level = 0; level < 4; level++) {
@@ -236,6 +476,8 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 				        IS_ALIGNED(addr, block_size) &&
 				        IS_ALIGNED(phys, block_size);
 
+			clear_contiguous(pte, level, addr, bbm);
+
 			if (block_aligned) {
 				type = (level == 3) ?
 					PTE_TYPE_PAGE : PTE_TYPE_BLOCK;
@@ -254,6 +496,8 @@ static int __arch_remap_range(uint64_t virt, uint64_t phys, uint64_t size,
 
 	}
 
+	optimize_range(virt, total, bbm);
+
 	tlb_invalidate();
 	return 0;
 }
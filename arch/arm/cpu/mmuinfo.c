@@ -22,13 +22,30 @@ int mmuinfo(void *addr)
 	return -ENOSYS;
 }
 
+int mmuinfo_count_tables(void)
+{
+	if (IS_ENABLED(CONFIG_CPU_V8))
+		return mmuinfo_v8_count_tables();
+
+	return -ENOSYS;
+}
+
+static int mmuinfo_stats(void)
+{
+	if (IS_ENABLED(CONFIG_CPU_V8))
+		return mmuinfo_v8_stats();
+
+	return -ENOSYS;
+}
+
 static __maybe_unused int do_mmuinfo(int argc, char *argv[])
 {
 	unsigned long addr;
 	int access_zero_page = -1;
+	bool stats = false;
 	int opt;
 
-	while ((opt = getopt(argc, argv, "zZ")) > 0) {
+	while ((opt = getopt(argc, argv, "zZs")) > 0) {
 		switch (opt) {
 		case 'z':
 			access_zero_page = true;
@@ -36,6 +53,9 @@ static __maybe_unused int do_mmuinfo(int argc, char *argv[])
 		case 'Z':
 			access_zero_page = false;
 			break;
+		case 's':
+			stats = true;
+			break;
 		default:
 			return COMMAND_ERROR_USAGE;
 		}
@@ -58,6 +78,13 @@ static __maybe_unused int do_mmuinfo(int argc, char *argv[])
 		return 0;
 	}
 
+	if (stats) {
+		if (argc - optind != 0)
+			return COMMAND_ERROR_USAGE;
+
+		return mmuinfo_stats();
+	}
+
 	if (argc - optind != 1)
 		return COMMAND_ERROR_USAGE;
 
@@ -72,13 +99,14 @@ BAREBOX_CMD_HELP_TEXT("")
 BAREBOX_CMD_HELP_TEXT("Options:")
 BAREBOX_CMD_HELP_OPT ("-z",  "enable access to zero page")
 BAREBOX_CMD_HELP_OPT ("-Z",  "disable access to zero page")
+BAREBOX_CMD_HELP_OPT ("-s",  "show page table statistics")
 BAREBOX_CMD_HELP_END
 
 #ifdef CONFIG_COMMAND_SUPPORT
 BAREBOX_CMD_START(mmuinfo)
 	.cmd            = do_mmuinfo,
 	BAREBOX_CMD_DESC("show MMU/cache information of an address")
-	BAREBOX_CMD_OPTS("[-zZ | ADDRESS]")
+	BAREBOX_CMD_OPTS("[-zZ | -s | ADDRESS]")
 	BAREBOX_CMD_GROUP(CMD_GRP_INFO)
 	BAREBOX_CMD_HELP(cmd_mmuinfo_help)
 BAREBOX_CMD_END
@@ -8,8 +8,11 @@
 #include <asm/mmuinfo.h>
 #include <asm/system.h>
 #include <asm/sysreg.h>
+#include <asm/pgtable64.h>
 #include <linux/bitfield.h>
 
+#include "mmu_64.h"
+
 #define at_par(reg, addr) ({ \
 		asm volatile("at " reg ", %0\n" :: "r" (addr)); \
 		isb(); \
@@ -213,3 +216,79 @@ int mmuinfo_v8(void *_addr)
 
 	return 0;
 }
+
+struct pt_stats {
+	unsigned tables[4];
+	unsigned leaves[4];
+	unsigned cont[4];
+};
+
+static void pt_count(const uint64_t *table, int level, struct pt_stats *st)
+{
+	int i;
+
+	st->tables[level]++;
+
+	for (i = 0; i < GRANULE_SIZE / sizeof(*table); i++) {
+		uint64_t pte = table[i];
+
+		if ((pte & PTE_TYPE_MASK) == PTE_TYPE_FAULT)
+			continue;
+
+		if (level < 3 && (pte & PTE_TYPE_MASK) == PTE_TYPE_TABLE) {
+			pt_count((void *)(pte & XLAT_ADDR_MASK), level + 1, st);
+			continue;
+		}
+
+		st->leaves[level]++;
+		if (pte & PTE_BLOCK_CONT)
+			st->cont[level]++;
+	}
+}
+
+int mmuinfo_v8_count_tables(void)
+{
+	struct pt_stats st = {};
+	int level, tables = 0;
+
+	if (!(get_cr() & CR_M))
+		return -ENODEV;
+
+	pt_count((void *)get_ttbr(current_el()), 0, &st);
+
+	for (level = 0; level < 4; level++)
+		tables += st.tables[level];
+
+	return tables;
+}
+
+int mmuinfo_v8_stats(void)
+{
+	static const char * const granule[] = { "512G", "1G", "2M", "4K" };
+	struct pt_stats st = {};
+	unsigned tables = 0, tlb = 0;
+	int level;
+
+	if (!(get_cr() & CR_M)) {
+		printf("MMU is disabled\n");
+		return 0;
+	}
+
+	pt_count((void *)get_ttbr(current_el()), 0, &st);
+
+	printf("level  granule  tables  mappings  contiguous\n");
+
+	for (level = 0; level < 4; level++) {
+		printf("%5d  %7s  %6u  %8u  %10u\n", level, granule[level],
+		       st.tables[level], st.leaves[level], st.cont[level]);
+
+		tables += st.tables[level];
+		/* 16 entries with the contiguous bit share one TLB entry */
+		tlb += st.leaves[level] - st.cont[level] + st.cont[level] / 16;
+	}
+
+	printf("page tables: %u (%u KiB), TLB entries to map everything: %u\n",
+	       tables, tables * GRANULE_SIZE / SZ_1K, tlb);
+
+	return 0;
+}
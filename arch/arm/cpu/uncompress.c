@@ -41,12 +41,16 @@ void __noreturn barebox_pbl_start(unsigned long membase, unsigned long memsize,
 	unsigned long pc = get_pc();
 	void *handoff_data;
 	struct elf_image elf;
+	bool early_mmu = false;
 	int ret;
 
 	/* piggy data is not relocated, so determine the bounds now */
 	pg_start = runtime_address(input_data);
 	pg_end = runtime_address(input_data_end);
 
+	if (IS_ENABLED(CONFIG_ARM_PBL_EARLY_MMU))
+		early_mmu = mmu_early_enable_prereloc(membase, memsize);
+
 	/*
 	 * If we run from inside the memory just relocate the binary
 	 * to the current address. Otherwise it may be a readonly location.
@@ -58,7 +62,7 @@ void __noreturn barebox_pbl_start(unsigned long membase, unsigned long memsize,
 		relocate_to_adr(membase);
 
 	pg_len = pg_end - pg_start;
-	uncompressed_len = get_unaligned((const u32 *)(pg_start + pg_len - 4));
+	uncompressed_len = pbl_barebox_uncompressed_len(pg_start, pg_len);
 
 	setup_c();
 
@@ -84,6 +88,10 @@ void __noreturn barebox_pbl_start(unsigned long membase, unsigned long memsize,
 #ifdef DEBUG
 	print_pbl_mem_layout(membase, endmem, barebox_base);
 #endif
+	/* replace the mapping used for relocation with the regular one */
+	if (early_mmu)
+		mmu_disable();
+
 	if (IS_ENABLED(CONFIG_MMU))
 		mmu_early_enable(membase, memsize);
 	else if (IS_ENABLED(CONFIG_ARMV7R_MPU))
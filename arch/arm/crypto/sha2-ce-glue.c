@@ -9,6 +9,7 @@
 #include <digest.h>
 #include <init.h>
 #include <crypto/sha.h>
+#include <crypto/pbl-sha.h>
 #include <crypto/sha256_base.h>
 #include <crypto/internal.h>
 #include <linux/linkage.h>
@@ -73,6 +74,7 @@ static int sha256_ce_final(struct digest *desc, u8 *out)
 	return sha256_base_finish(desc, out);
 }
 
+#ifndef __PBL__
 static struct digest_algo sha224 = {
 	.base = {
 		.name		=	"sha224",
@@ -95,6 +97,7 @@ static int sha224_ce_digest_register(void)
 	return digest_algo_register(&sha224);
 }
 coredevice_initcall(sha224_ce_digest_register);
+#endif
 
 static struct digest_algo sha256 = {
 	.base = {
@@ -113,14 +116,29 @@ static struct digest_algo sha256 = {
 	.ctx_length =	sizeof(struct sha256_ce_state),
 };
 
-static int sha256_ce_digest_register(void)
+static bool sha256_ce_supported(void)
 {
 	uint64_t isar0;
 
 	isar0 = read_sysreg(ID_AA64ISAR0_EL1);
-	if (!(isar0 & ID_AA64ISAR0_EL1_SHA2_MASK))
+
+	return isar0 & ID_AA64ISAR0_EL1_SHA2_MASK;
+}
+
+#ifdef __PBL__
+struct digest_algo *pbl_sha256_algo(void)
+{
+	BUILD_BUG_ON(sizeof(struct sha256_ce_state) > PBL_SHA256_CTX_SIZE);
+
+	return sha256_ce_supported() ? &sha256 : &m256;
+}
+#else
+static int sha256_ce_digest_register(void)
+{
+	if (!sha256_ce_supported())
 		return -EOPNOTSUPP;
 
 	return digest_algo_register(&sha256);
 }
 coredevice_initcall(sha256_ce_digest_register);
+#endif
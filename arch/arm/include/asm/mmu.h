@@ -70,5 +70,6 @@ void __dma_flush_range(unsigned long, unsigned long);
 void __dma_inv_range(unsigned long, unsigned long);
 
 void mmu_early_enable(unsigned long membase, unsigned long memsize);
+bool mmu_early_enable_prereloc(unsigned long membase, unsigned long memsize);
 
 #endif /* __ASM_MMU_H */
@@ -5,5 +5,7 @@
 
 int mmuinfo_v7(void *addr);
 int mmuinfo_v8(void *addr);
+int mmuinfo_v8_stats(void);
+int mmuinfo_v8_count_tables(void);
 
 #endif
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * CRC32 using the ARMv8 CRC32 instructions
+ *
+ * The crc32{b,h,w,x} instructions implement the reflected IEEE 802.3
+ * polynomial without pre- and post-inversion, which matches the
+ * semantics of crc32_no_comp().
+ */
+
+#include <common.h>
+#include <init.h>
+#include <crc.h>
+#include <asm/sysreg.h>
+#include <asm/unaligned.h>
+
+static bool have_crc32;
+
+#define __CRC32(insn, reg)						\
+static inline u32 __crc32##insn(u32 crc, u64 val)			\
+{									\
+	asm(".arch_extension crc\n\t"					\
+	    "crc32" #insn " %w0, %w0, %" #reg "1"			\
+	    : "+r" (crc) : "r" (val));					\
+	return crc;							\
+}
+
+__CRC32(b, w)
+__CRC32(h, w)
+__CRC32(w, w)
+__CRC32(x, x)
+
+uint32_t crc32_no_comp_arch(uint32_t crc, const void *_buf, unsigned int len)
+{
+	const u8 *buf = _buf;
+
+	while (len && !IS_ALIGNED((unsigned long)buf, 8)) {
+		crc = __crc32b(crc, *buf++);
+		len--;
+	}
+
+	while (len >= 32) {
+		crc = __crc32x(crc, get_unaligned_le64(buf));
+		crc = __crc32x(crc, get_unaligned_le64(buf + 8));
+		crc = __crc32x(crc, get_unaligned_le64(buf + 16));
+		crc = __crc32x(crc, get_unaligned_le64(buf + 24));
+		buf += 32;
+		len -= 32;
+	}
+
+	while (len >= 8) {
+		crc = __crc32x(crc, get_unaligned_le64(buf));
+		buf += 8;
+		len -= 8;
+	}
+
+	if (len & 4) {
+		crc = __crc32w(crc, get_unaligned_le32(buf));
+		buf += 4;
+	}
+
+	if (len & 2) {
+		crc = __crc32h(crc, get_unaligned_le16(buf));
+		buf += 2;
+	}
+
+	if (len & 1)
+		crc = __crc32b(crc, *buf);
+
+	return crc;
+}
+EXPORT_SYMBOL(crc32_no_comp_arch);
+
+bool crc32_arch_available(void)
+{
+	return have_crc32;
+}
+EXPORT_SYMBOL(crc32_arch_available);
+
+static int crc32_arm64_init(void)
+{
+	have_crc32 = read_sysreg(ID_AA64ISAR0_EL1) & ID_AA64ISAR0_EL1_CRC32_MASK;
+
+	return 0;
+}
+core_initcall(crc32_arm64_init);
@@ -3,6 +3,7 @@
 #include <common.h>
 #include <asm/stacktrace.h>
 #include <asm/unwind.h>
+#include <linux/stacktrace.h>
 
 #define THREAD_SIZE 16384
 
@@ -37,6 +38,28 @@ int unwind_frame(struct stackframe *frame)
 	return 0;
 }
 
+noinline unsigned int stack_trace_save(unsigned long *store, unsigned int size,
+				      unsigned int skipnr)
+{
+	struct stackframe frame = {};
+	register unsigned long current_sp asm ("sp");
+	unsigned int n = 0;
+
+	frame.fp = (unsigned long)__builtin_frame_address(0);
+	frame.sp = current_sp;
+
+	while (n < size && unwind_frame(&frame) == 0) {
+		if (skipnr) {
+			skipnr--;
+			continue;
+		}
+
+		store[n++] = frame.pc;
+	}
+
+	return n;
+}
+
 static void dump_backtrace_entry(unsigned long where, unsigned long from)
 {
 #ifdef CONFIG_KALLSYMS
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* dmastat - show statistics about DMA cache maintenance */
+
+#include <common.h>
+#include <command.h>
+#include <getopt.h>
+#include <dma.h>
+#include <linux/math64.h>
+
+static int do_dmastat(int argc, char *argv[])
+{
+	struct dma_sync_stats stats;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "r")) > 0) {
+		switch (opt) {
+		case 'r':
+			dma_sync_stats_reset();
+			return 0;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	dma_sync_stats_get(&stats);
+
+	printf("sync requests:        %llu\n", stats.requests);
+	printf("maintenance ops:      %llu\n", stats.ops);
+	printf("merged requests:      %llu\n", stats.merged);
+	printf("full cache flushes:   %llu\n", stats.full_flushes);
+	printf("bytes maintained:     %llu\n", stats.bytes);
+	printf("time:                 %llu us\n", div_u64(stats.time_ns, 1000));
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(dmastat)
+BAREBOX_CMD_HELP_TEXT("Show how many DMA sync requests drivers issued, how many cache")
+BAREBOX_CMD_HELP_TEXT("maintenance operations they resulted in and how long those took.")
+BAREBOX_CMD_HELP_TEXT("Reset the counters before a transfer, e.g. tftp or fastboot, to")
+BAREBOX_CMD_HELP_TEXT("see its share.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT("-r", "reset the counters")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(dmastat)
+	.cmd		= do_dmastat,
+	BAREBOX_CMD_DESC("show DMA cache maintenance statistics")
+	BAREBOX_CMD_OPTS("[-r]")
+	BAREBOX_CMD_GROUP(CMD_GRP_INFO)
+	BAREBOX_CMD_HELP(cmd_dmastat_help)
+BAREBOX_CMD_END
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* membench - measure memory bandwidth and latency */
+
+#include <common.h>
+#include <command.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <membench.h>
+#include <mmu.h>
+#include <linux/sizes.h>
+
+static const struct {
+	const char *name;
+	maptype_t map_type;
+} membench_maps[] = {
+	{ "cached", MAP_CACHED },
+	{ "uncached", MAP_UNCACHED },
+	{ "writecombine", MAP_WRITECOMBINE },
+};
+
+static int do_membench_map(void *buf, size_t maxsize, int map, unsigned int loops,
+			   bool json, bool *first)
+{
+	struct membench_result res;
+	size_t size;
+	int ret = 0;
+
+	if (map && remap_range(buf, maxsize, membench_maps[map].map_type)) {
+		printf("Cannot map %s\n", membench_maps[map].name);
+		return -EINVAL;
+	}
+
+	if (!json)
+		printf("%-12s %10s %10s %10s %10s %10s %10s\n",
+		       membench_maps[map].name, "size", "copy", "scale",
+		       "add", "triad", "latency");
+
+	for (size = SZ_16K; size <= maxsize; size *= 4) {
+		ret = membench_run(buf, size, loops, &res);
+		if (ret)
+			break;
+
+		if (json) {
+			printf("%s{\"map\": \"%s\", \"size\": %zu, \"copy\": %llu, "
+			       "\"scale\": %llu, \"add\": %llu, \"triad\": %llu, "
+			       "\"latency_ps\": %llu}", *first ? "" : ",\n",
+			       membench_maps[map].name, res.size, res.copy,
+			       res.scale, res.add, res.triad, res.latency_ps);
+			*first = false;
+		} else {
+			printf("%-12s %9zuK %5llu MB/s %5llu MB/s %5llu MB/s "
+			       "%5llu MB/s %7llu ps\n", "", res.size / SZ_1K,
+			       res.copy, res.scale, res.add, res.triad,
+			       res.latency_ps);
+		}
+	}
+
+	if (map)
+		remap_range(buf, maxsize, MAP_CACHED);
+
+	return ret;
+}
+
+static int do_membench(int argc, char *argv[])
+{
+	size_t maxsize = SZ_64M;
+	unsigned int loops = 0;
+	bool json = false, first = true;
+	unsigned int maps = 0;
+	void *buf;
+	int opt, i, ret = 0;
+
+	while ((opt = getopt(argc, argv, "s:l:cuwj")) > 0) {
+		switch (opt) {
+		case 's':
+			maxsize = strtoull_suffix(optarg, NULL, 0);
+			break;
+		case 'l':
+			loops = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			maps |= BIT(0);
+			break;
+		case 'u':
+			maps |= BIT(1);
+			break;
+		case 'w':
+			maps |= BIT(2);
+			break;
+		case 'j':
+			json = true;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	if (!maps)
+		maps = BIT(0);
+
+	if ((maps & ~BIT(0)) && !arch_can_remap()) {
+		printf("Cannot map uncached or writecombine\n");
+		return COMMAND_ERROR;
+	}
+
+	if (maxsize < SZ_16K)
+		return COMMAND_ERROR_USAGE;
+
+	maxsize = PAGE_ALIGN(maxsize);
+
+	buf = memalign(PAGE_SIZE, maxsize);
+	if (!buf) {
+		printf("Cannot allocate %zu bytes\n", maxsize);
+		return COMMAND_ERROR;
+	}
+
+	if (json)
+		printf("[\n");
+
+	for (i = 0; i < ARRAY_SIZE(membench_maps); i++) {
+		if (!(maps & BIT(i)))
+			continue;
+
+		ret = do_membench_map(buf, maxsize, i, loops, json, &first);
+		if (ret)
+			break;
+	}
+
+	if (json)
+		printf("\n]\n");
+
+	free(buf);
+
+	if (ret) {
+		printf("membench: %pe\n", ERR_PTR(ret));
+		return COMMAND_ERROR;
+	}
+
+	return 0;
+}
+
+BAREBOX_CMD_HELP_START(membench)
+BAREBOX_CMD_HELP_TEXT("Measure STREAM style copy, scale, add and triad bandwidth and the")
+BAREBOX_CMD_HELP_TEXT("latency of dependent loads for working sets from 16KiB up to SIZE,")
+BAREBOX_CMD_HELP_TEXT("growing by a factor of 4.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT("-s SIZE", "maximum working set size (default 64M)")
+BAREBOX_CMD_HELP_OPT("-l LOOPS", "run each kernel LOOPS times (default: 64M / working set size)")
+BAREBOX_CMD_HELP_OPT("-c", "measure with cached mapping (default)")
+BAREBOX_CMD_HELP_OPT("-u", "measure with uncached mapping")
+BAREBOX_CMD_HELP_OPT("-w", "measure with write-combine mapping")
+BAREBOX_CMD_HELP_OPT("-j", "JSON output")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(membench)
+	.cmd		= do_membench,
+	BAREBOX_CMD_DESC("memory bandwidth and latency benchmark")
+	BAREBOX_CMD_OPTS("[-slcuwj]")
+	BAREBOX_CMD_GROUP(CMD_GRP_MEM)
+	BAREBOX_CMD_HELP(cmd_membench_help)
+BAREBOX_CMD_END
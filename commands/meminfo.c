@@ -7,10 +7,12 @@
 #include <command.h>
 #include <complete.h>
 #include <malloc.h>
+#include <arena.h>
 
 static int do_meminfo(int argc, char *argv[])
 {
 	malloc_stats();
+	arena_print_stats();
 
 	return 0;
 }
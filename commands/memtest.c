@@ -12,10 +12,13 @@
 #include <memtest.h>
 #include <mmu.h>
 
+static int bandwidth;
+
 static int do_test_one_area(struct mem_test_resource *r, int bus_only,
 		maptype_t cache_flag)
 {
 	unsigned flags = MEMTEST_VERBOSE;
+	struct mem_test_bandwidth bw;
 	int ret;
 
 	printf("Testing memory space: %pa -> %pa:\n",
@@ -33,6 +36,16 @@ static int do_test_one_area(struct mem_test_resource *r, int bus_only,
 	ret = mem_test_moving_inversions(r->r->start, r->r->end, flags);
 	if (ret < 0)
 		return ret;
+
+	if (bandwidth) {
+		ret = mem_test_bandwidth(r->r->start, r->r->end, flags, &bw);
+		if (ret < 0)
+			return ret;
+
+		printf("write: %llu MB/s, read: %llu MB/s, copy: %llu MB/s\n",
+		       bw.write, bw.read, bw.copy);
+	}
+
 	printf("done.\n\n");
 
 	return 0;
@@ -74,8 +87,9 @@ static int do_memtest(int argc, char *argv[])
 	int cached = 0, uncached = 0;
 
 	memtest = do_memtest_biggest;
+	bandwidth = 0;
 
-	while ((opt = getopt(argc, argv, "i:btcu")) > 0) {
+	while ((opt = getopt(argc, argv, "i:btcup")) > 0) {
 		switch (opt) {
 		case 'i':
 			max_i = simple_strtoul(optarg, NULL, 0);
@@ -92,6 +106,9 @@ static int do_memtest(int argc, char *argv[])
 		case 'u':
 			uncached = 1;
 			break;
+		case 'p':
+			bandwidth = 1;
+			break;
 		default:
 			return COMMAND_ERROR_USAGE;
 		}
@@ -169,12 +186,13 @@ BAREBOX_CMD_HELP_OPT("-b", "perform only a test on bus lines")
 BAREBOX_CMD_HELP_OPT("-c", "cached. Test using cached memory")
 BAREBOX_CMD_HELP_OPT("-u", "uncached. Test using uncached memory")
 BAREBOX_CMD_HELP_OPT("-t", "thorough. test all free areas. If unset, only test biggest free area")
+BAREBOX_CMD_HELP_OPT("-p", "measure and report write, read and copy bandwidth")
 BAREBOX_CMD_HELP_END
 
 BAREBOX_CMD_START(memtest)
 	.cmd		= do_memtest,
 	BAREBOX_CMD_DESC("extensive memory test")
-	BAREBOX_CMD_OPTS("[-ibcut]")
+	BAREBOX_CMD_OPTS("[-ibcutp]")
 	BAREBOX_CMD_GROUP(CMD_GRP_MEM)
 	BAREBOX_CMD_HELP(cmd_memtest_help)
 BAREBOX_CMD_END
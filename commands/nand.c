@@ -22,6 +22,7 @@
 #define NAND_MARKBAD	3
 #define NAND_MARKGOOD	4
 #define NAND_INFO	5
+#define NAND_REGEN_BBT	6
 
 static int do_nand(int argc, char *argv[])
 {
@@ -32,7 +33,7 @@ static int do_nand(int argc, char *argv[])
 	int ret = 0;
 	struct mtd_info_user mtdinfo;
 
-	while((opt = getopt(argc, argv, "adb:g:i")) > 0) {
+	while((opt = getopt(argc, argv, "adb:g:ir")) > 0) {
 		if (command) {
 			printf("only one command may be given\n");
 			return 1;
@@ -56,6 +57,9 @@ static int do_nand(int argc, char *argv[])
 		case 'i':
 			command = NAND_INFO;
 			break;
+		case 'r':
+			command = NAND_REGEN_BBT;
+			break;
 		default:
 			return COMMAND_ERROR_USAGE;
 		}
@@ -127,6 +131,17 @@ static int do_nand(int argc, char *argv[])
 		goto out;
 	}
 
+	if (command == NAND_REGEN_BBT) {
+		printf("rescanning %s for bad blocks\n", argv[optind]);
+
+		ret = nand_regenerate_bbt(mtdinfo.mtd);
+		if (ret)
+			printf("cannot regenerate bad block table: %pe\n",
+			       ERR_PTR(ret));
+
+		goto out;
+	}
+
 	if (command == NAND_INFO) {
 		loff_t ofs;
 		int bad = 0;
@@ -160,12 +175,13 @@ BAREBOX_CMD_HELP_OPT ("-d",  "deregister a bad block aware device")
 BAREBOX_CMD_HELP_OPT ("-b OFFS",  "mark block at OFFSet as bad")
 BAREBOX_CMD_HELP_OPT ("-g OFFS",  "mark block at OFFSet as good")
 BAREBOX_CMD_HELP_OPT ("-i",  "info. Show information about bad blocks")
+BAREBOX_CMD_HELP_OPT ("-r",  "rescan device for bad blocks and rewrite the bad block table cache")
 BAREBOX_CMD_HELP_END
 
 BAREBOX_CMD_START(nand)
 	.cmd		= do_nand,
 	BAREBOX_CMD_DESC("NAND flash handling")
-	BAREBOX_CMD_OPTS("[-adbgi] NANDDEV")
+	BAREBOX_CMD_OPTS("[-adbgir] NANDDEV")
 	BAREBOX_CMD_GROUP(CMD_GRP_HWMANIP)
 	BAREBOX_CMD_HELP(cmd_nand_help)
 BAREBOX_CMD_END
@@ -254,8 +254,10 @@ static int do_of_property_set_now(struct device_node *root, const char *path,
 	pp = of_find_property(node, propname, NULL);
 
 	if (pp) {
-		free(pp->value);
+		if (!(pp->arena_flags & OF_ARENA_VALUE))
+			free(pp->value);
 		pp->value_const = NULL;
+		pp->arena_flags &= ~OF_ARENA_VALUE;
 
 		if (len)
 			pp->value = xmemdup(data, len);
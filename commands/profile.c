@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+/* profile - find out where a command spends its time */
+
+#include <common.h>
+#include <command.h>
+#include <clock.h>
+#include <getopt.h>
+#include <malloc.h>
+#include <profile.h>
+
+static int do_profile(int argc, char *argv[])
+{
+	unsigned int period_us = 100, nstacks = 4096, top = 20;
+	const char *outfile = NULL;
+	char *buf;
+	int opt, ret;
+
+	while ((opt = getopt(argc, argv, "+p:s:n:o:")) > 0) {
+		switch (opt) {
+		case 'p':
+			period_us = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			nstacks = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			top = simple_strtoul(optarg, NULL, 0);
+			break;
+		case 'o':
+			outfile = optarg;
+			break;
+		default:
+			return COMMAND_ERROR_USAGE;
+		}
+	}
+
+	argv += optind;
+	argc -= optind;
+
+	if (argc < 1)
+		return COMMAND_ERROR_USAGE;
+
+	buf = strjoin(" ", argv, argc);
+
+	ret = profile_start(period_us * USECOND, nstacks);
+	if (ret) {
+		printf("cannot start profiler: %pe\n", ERR_PTR(ret));
+		goto out;
+	}
+
+	run_command("%s", buf);
+
+	profile_stop();
+
+	profile_report(top);
+
+	if (outfile) {
+		ret = profile_write_folded(outfile);
+		if (ret)
+			printf("cannot write %s: %pe\n", outfile, ERR_PTR(ret));
+	}
+
+	profile_free();
+out:
+	free(buf);
+
+	return ret ? COMMAND_ERROR : COMMAND_SUCCESS;
+}
+
+BAREBOX_CMD_HELP_START(profile)
+BAREBOX_CMD_HELP_TEXT("Run COMMAND and sample its call chains whenever barebox reschedules,")
+BAREBOX_CMD_HELP_TEXT("then print the functions most time was spent in. Code that doesn't")
+BAREBOX_CMD_HELP_TEXT("poll, delay or check for ctrl-c is only seen when it returns to code")
+BAREBOX_CMD_HELP_TEXT("that does.")
+BAREBOX_CMD_HELP_TEXT("")
+BAREBOX_CMD_HELP_TEXT("Options:")
+BAREBOX_CMD_HELP_OPT ("-p US", "minimum sampling period in microseconds (default 100)")
+BAREBOX_CMD_HELP_OPT ("-s NUM", "number of distinct call chains to record (default 4096)")
+BAREBOX_CMD_HELP_OPT ("-n NUM", "number of functions to print (default 20)")
+BAREBOX_CMD_HELP_OPT ("-o FILE", "write call chains in folded format for flamegraph.pl")
+BAREBOX_CMD_HELP_END
+
+BAREBOX_CMD_START(profile)
+	.cmd		= do_profile,
+	BAREBOX_CMD_DESC("profile execution of a command")
+	BAREBOX_CMD_OPTS("[-psno] COMMAND")
+	BAREBOX_CMD_GROUP(CMD_GRP_MISC)
+	BAREBOX_CMD_HELP(cmd_profile_help)
+BAREBOX_CMD_END
@@ -5,6 +5,7 @@
 #include <globalvar.h>
 #include <firmware.h>
 #include <malloc.h>
+#include <arena.h>
 #include <fcntl.h>
 #include <libfile.h>
 #include <libbb.h>
@@ -18,6 +19,7 @@
 #include <linux/err.h>
 #include <uapi/spec/dps.h>
 #include <boot.h>
+#include <blspec.h>
 
 #include <bootscan.h>
 
@@ -31,6 +33,135 @@ struct blspec_entry {
 	char *sortkey;
 };
 
+static LIST_HEAD(blspec_cache);
+/* the barebox compatible the cached devicetree verdicts are valid for */
+static char *blspec_cache_compat;
+
+static void blspec_cache_entry_free(struct blspec_cache_entry *c)
+{
+	list_del(&c->list);
+	of_delete_node(c->node);
+	free(c->sortkey);
+	free(c->partuuid);
+	free(c->path);
+	free(c);
+}
+
+/*
+ * blspec_cache_lookup - get the cache entry for a file
+ *
+ * Returns the cache entry for @path on the partition with @partuuid. If there
+ * is none or the file's @mtime or @size have changed since, a new empty entry
+ * is returned. Returns NULL if caching is disabled.
+ */
+struct blspec_cache_entry *blspec_cache_lookup(const char *partuuid,
+					       const char *path,
+					       time_t mtime, loff_t size)
+{
+	struct blspec_cache_entry *c;
+
+	if (!IS_ENABLED(CONFIG_BLSPEC_CACHE))
+		return NULL;
+
+	list_for_each_entry(c, &blspec_cache, list) {
+		if (strcmp(c->partuuid, partuuid) || strcmp(c->path, path))
+			continue;
+
+		if (c->mtime == mtime && c->size == size) {
+			c->seen = true;
+			return c;
+		}
+
+		blspec_cache_entry_free(c);
+		break;
+	}
+
+	c = xzalloc(sizeof(*c));
+	c->partuuid = xstrdup(partuuid);
+	c->path = xstrdup(path);
+	c->mtime = mtime;
+	c->size = size;
+	c->seen = true;
+	list_add(&c->list, &blspec_cache);
+
+	return c;
+}
+
+/*
+ * blspec_cache_get - get the cache entry for a file on a cdev
+ *
+ * Like blspec_cache_lookup(), but the key is taken from @cdev and the file
+ * itself. Returns NULL if results for the file can't be cached.
+ */
+static struct blspec_cache_entry *blspec_cache_get(struct cdev *cdev,
+						   const char *path)
+{
+	struct stat s;
+
+	if (!IS_ENABLED(CONFIG_BLSPEC_CACHE))
+		return NULL;
+
+	/* Without a modification time changes can't be detected reliably */
+	if (!cdev || !*cdev->partuuid || stat(path, &s) || !s.st_mtime)
+		return NULL;
+
+	return blspec_cache_lookup(cdev->partuuid, path, s.st_mtime, s.st_size);
+}
+
+static bool blspec_cache_entry_below(struct blspec_cache_entry *c,
+				     const char *partuuid, const char *root)
+{
+	size_t len = strlen(root);
+
+	if (strcmp(c->partuuid, partuuid) || strncmp(c->path, root, len))
+		return false;
+
+	return c->path[len] == '/' || (len && root[len - 1] == '/');
+}
+
+/*
+ * blspec_cache_scan_begin - start a scan of a directory
+ *
+ * Marks all cache entries for files below @root on the partition with
+ * @partuuid as unseen. Entries that are not looked up again until the
+ * matching blspec_cache_scan_end() are dropped then, so that files deleted
+ * in the meantime don't stay in the cache forever.
+ */
+void blspec_cache_scan_begin(const char *partuuid, const char *root)
+{
+	struct blspec_cache_entry *c;
+
+	list_for_each_entry(c, &blspec_cache, list) {
+		if (blspec_cache_entry_below(c, partuuid, root))
+			c->seen = false;
+	}
+}
+
+void blspec_cache_scan_end(const char *partuuid, const char *root)
+{
+	struct blspec_cache_entry *c, *tmp;
+
+	list_for_each_entry_safe(c, tmp, &blspec_cache, list) {
+		if (!c->seen && blspec_cache_entry_below(c, partuuid, root))
+			blspec_cache_entry_free(c);
+	}
+}
+
+void blspec_cache_set_compat(const char *compat)
+{
+	struct blspec_cache_entry *c;
+
+	if (!IS_ENABLED(CONFIG_BLSPEC_CACHE) ||
+	    (blspec_cache_compat && !strcmp(blspec_cache_compat, compat)))
+		return;
+
+	free(blspec_cache_compat);
+	blspec_cache_compat = xstrdup(compat);
+
+	list_for_each_entry(c, &blspec_cache, list)
+		c->checked = false;
+}
+
 /*
  * blspec_entry_var_get - get the value of a variable
  */
@@ -50,8 +181,18 @@ static const char *blspec_entry_var_get(struct blspec_entry *entry, const char *
 static int blspec_entry_var_set(struct blspec_entry *entry, const char *name,
 		const char *val)
 {
-	return of_set_property(entry->node, name, val,
-			val ? strlen(val) + 1 : 0, 1);
+	struct device_node *np = entry->node;
+	struct property *pp = of_find_property(np, name, NULL);
+	/* arena space isn't reclaimed, so put overwritten variables on the heap */
+	struct arena *arena = pp ? NULL : np->arena;
+
+	of_delete_property(pp);
+
+	if (!of_arena_new_property(arena, np, name, val,
+				   val ? strlen(val) + 1 : 0))
+		return -ENOMEM;
+
+	return 0;
 }
 
 static int blspec_overlay_fixup(struct device_node *root, void *ctx)
@@ -185,13 +326,14 @@ static void blspec_entry_free(struct bootentry *be)
 	free(entry);
 }
 
-static struct blspec_entry *blspec_entry_alloc(struct bootentries *bootentries)
+static struct blspec_entry *blspec_entry_alloc(struct bootentries *bootentries,
+					       struct device_node *node)
 {
 	struct blspec_entry *entry;
 
 	entry = xzalloc(sizeof(*entry));
 
-	entry->node = of_new_node(NULL, NULL);
+	entry->node = node;
 	entry->entry.release = blspec_entry_free;
 	entry->entry.boot = blspec_boot;
 
@@ -202,19 +344,32 @@ static struct blspec_entry *blspec_entry_alloc(struct bootentries *bootentries)
  * blspec_entry_open - open an entry given a path
  */
 static struct blspec_entry *blspec_entry_open(struct bootentries *bootentries,
-		const char *abspath)
+		const char *abspath, struct cdev *cdev)
 {
+	struct blspec_cache_entry *cache;
 	struct blspec_entry *entry;
 	char *end, *line, *next;
 	char *buf;
 
 	pr_debug("%s: %s\n", __func__, abspath);
 
+	cache = blspec_cache_get(cdev, abspath);
+	if (cache && cache->node) {
+		entry = blspec_entry_alloc(bootentries, of_dup(cache->node));
+		entry->sortkey = xstrdup(cache->sortkey);
+		return entry;
+	}
+
 	buf = read_file(abspath, NULL);
 	if (!buf)
 		return ERR_PTR(-errno);
 
-	entry = blspec_entry_alloc(bootentries);
+	/*
+	 * The variables of an entry are only freed together with it, so
+	 * allocate them from an arena owned by the root node.
+	 */
+	entry = blspec_entry_alloc(bootentries,
+				   of_arena_new_node(arena_new(), NULL, NULL));
 
 	next = buf;
 
@@ -280,6 +435,11 @@ static struct blspec_entry *blspec_entry_open(struct bootentries *bootentries,
 
 	free(buf);
 
+	if (cache) {
+		cache->node = of_dup(entry->node);
+		cache->sortkey = xstrdup(entry->sortkey);
+	}
+
 	return entry;
 }
 
@@ -319,12 +479,11 @@ static int blspec_have_entry(struct bootentries *bootentries, const char *path)
  */
 static bool entry_is_of_compatible(struct blspec_entry *entry)
 {
+	struct blspec_cache_entry *cache;
 	const char *devicetree;
 	const char *abspath;
 	int ret;
 	struct device_node *barebox_root;
-	size_t size;
-	void *fdt;
 	const char *compat;
 	char *filename;
 
@@ -352,23 +511,22 @@ static bool entry_is_of_compatible(struct blspec_entry *entry)
 
 	filename = basprintf("%s/%s", abspath, devicetree);
 
-	fdt = read_file(filename, &size);
-	if (!fdt) {
-		ret = false;
-		goto out;
-	}
+	blspec_cache_set_compat(compat);
 
-	if (fdt_machine_is_compatible(fdt, size, compat)) {
-		ret = true;
-		goto out;
+	cache = blspec_cache_get(entry->cdev, filename);
+	if (cache && cache->checked) {
+		ret = cache->compatible;
+	} else {
+		ret = fdt_file_machine_is_compatible(filename, compat) != 0;
+		if (cache) {
+			cache->compatible = ret;
+			cache->checked = true;
+		}
 	}
 
-	pr_info("ignoring entry with incompatible devicetree: %s\n", devicetree);
+	if (!ret)
+		pr_info("ignoring entry with incompatible devicetree: %s\n", devicetree);
 
-	ret = false;
-
-out:
-	free(fdt);
 	free(filename);
 
 	return ret;
@@ -476,17 +634,21 @@ static int __blspec_scan_file(struct bootentries *bootentries, const char *root,
 	char *devname = NULL, *hwdevname = NULL;
 	struct blspec_entry *entry;
 
+	struct cdev *cdev;
+
 	if (blspec_have_entry(bootentries, configname))
 		return -EEXIST;
 
-	entry = blspec_entry_open(bootentries, configname);
+	root = root ?: get_blspec_prefix_path(configname);
+	cdev = get_cdev_by_mountpath(root);
+
+	entry = blspec_entry_open(bootentries, configname, cdev);
 	if (IS_ERR(entry))
 		return PTR_ERR(entry);
 
-	root = root ?: get_blspec_prefix_path(configname);
 	entry->rootpath = xstrdup_const(root);
 	entry->entry.path = xstrdup_const(configname);
-	entry->cdev = get_cdev_by_mountpath(root);
+	entry->cdev = cdev;
 
 	if (!entry_is_of_compatible(entry)) {
 		blspec_entry_free(&entry->entry);
@@ -543,10 +705,18 @@ static int blspec_scan_directory(struct bootscanner *bootscanner,
 	char *abspath;
 	int ret, found = 0;
 	const char *dirname = "loader/entries";
+	const char *partuuid = NULL;
+	struct cdev *cdev;
 	int i;
 
 	pr_debug("%s: %s %s\n", __func__, root, dirname);
 
+	cdev = get_cdev_by_mountpath(root);
+	if (cdev && *cdev->partuuid) {
+		partuuid = cdev->partuuid;
+		blspec_cache_scan_begin(partuuid, root);
+	}
+
 	abspath = basprintf("%s/%s/*.conf", root, dirname);
 
 	ret = glob(abspath, 0, NULL, &globb);
@@ -573,6 +743,9 @@ static int blspec_scan_directory(struct bootscanner *bootscanner,
 
 	globfree(&globb);
 err_out:
+	if (partuuid)
+		blspec_cache_scan_end(partuuid, root);
+
 	free(abspath);
 
 	return ret;
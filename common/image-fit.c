@@ -14,6 +14,7 @@
 #include <digest.h>
 #include <of.h>
 #include <fs.h>
+#include <fcntl.h>
 #include <malloc.h>
 #include <linux/ctype.h>
 #include <linux/refcount.h>
@@ -1117,7 +1118,13 @@ struct fit_handle *fit_open(const char *_filename, bool verbose,
 	handle->verbose = verbose;
 	handle->verify = verify;
 
-	fd = open_fdt(filename, &handle->size);
+	/*
+	 * When hashes or signatures are verified, the images are checked
+	 * when they are used, so the storage need not check them as well.
+	 */
+	fd = open_fdt(filename, &handle->size,
+		      verify == BOOTM_VERIFY_HASH ||
+		      verify == BOOTM_VERIFY_SIGNATURE ? O_NOVERIFY : 0);
 	if (fd < 0) {
 		ret = fd;
 		goto free_handle;
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * membench.c - STREAM style memory bandwidth and latency measurement
+ *
+ * The bandwidth kernels follow the STREAM benchmark by John D. McCalpin,
+ * but work on 64bit integers, as barebox doesn't use the FPU.
+ */
+
+#include <common.h>
+#include <clock.h>
+#include <membench.h>
+#include <stdlib.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
+
+#define MEMBENCH_SCALAR		3
+#define MEMBENCH_LINE		64
+/* minimum number of dependent loads for the latency measurement */
+#define MEMBENCH_CHASE_STEPS	SZ_1M
+
+static noinline void membench_copy(u64 *a, const u64 *b, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		a[i] = b[i];
+}
+
+static noinline void membench_scale(u64 *a, const u64 *b, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		a[i] = MEMBENCH_SCALAR * b[i];
+}
+
+static noinline void membench_add(u64 *a, const u64 *b, const u64 *c, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		a[i] = b[i] + c[i];
+}
+
+static noinline void membench_triad(u64 *a, const u64 *b, const u64 *c,
+				    size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		a[i] = b[i] + MEMBENCH_SCALAR * c[i];
+}
+
+static u64 membench_mbps(u64 bytes, u64 ns)
+{
+	/* bytes per microsecond is (decimal) MB/s */
+	return ns ? div64_u64(bytes * 1000, ns) : 0;
+}
+
+/*
+ * The order of the cache lines is kept in the lines themselves, behind
+ * the link pointer, so that no extra memory is needed.
+ */
+static u32 *membench_order(void *buf, size_t line)
+{
+	return buf + line * MEMBENCH_LINE + sizeof(void *);
+}
+
+/*
+ * Link all cache lines of the buffer in random order into a single cycle,
+ * so that following it defeats the prefetchers.
+ */
+static void membench_chase_init(void *buf, size_t nlines)
+{
+	size_t i, j;
+	u32 tmp;
+
+	for (i = 0; i < nlines; i++)
+		*membench_order(buf, i) = i;
+
+	for (i = nlines - 1; i > 0; i--) {
+		j = prandom_u32_max(i + 1);
+		tmp = *membench_order(buf, i);
+		*membench_order(buf, i) = *membench_order(buf, j);
+		*membench_order(buf, j) = tmp;
+	}
+
+	for (i = 0; i < nlines; i++) {
+		size_t from = *membench_order(buf, i);
+		size_t to = *membench_order(buf, (i + 1) % nlines);
+
+		*(void **)(buf + from * MEMBENCH_LINE) = buf + to * MEMBENCH_LINE;
+	}
+}
+
+static noinline void *membench_chase(void *p, size_t steps)
+{
+	while (steps--)
+		p = *(void **)p;
+
+	return p;
+}
+
+/**
+ * membench_run - measure memory bandwidth and latency
+ * @buf: buffer to work on, contents are destroyed
+ * @size: working set size in bytes
+ * @loops: number of times each bandwidth kernel is run, 0 for automatic
+ * @res: returns the results
+ *
+ * The results depend on the mapping of @buf, so this can be used to
+ * compare cached, uncached and write-combined mappings of the same memory.
+ *
+ * Return: 0 for success, negative error code otherwise
+ */
+int membench_run(void *buf, size_t size, unsigned int loops,
+		 struct membench_result *res)
+{
+	size_t n = size / (3 * sizeof(u64));
+	size_t nlines = size / MEMBENCH_LINE;
+	u64 *a = buf, *b = a + n, *c = b + n;
+	u64 t, ns[4] = {};
+	size_t steps, i;
+	unsigned int k, l;
+	void *p;
+
+	if (n < 1 || nlines < 2 || nlines > U32_MAX)
+		return -EINVAL;
+
+	if (!loops)
+		loops = max_t(size_t, SZ_64M / size, 1);
+
+	for (i = 0; i < n; i++) {
+		a[i] = 1;
+		b[i] = 2;
+		c[i] = 0;
+	}
+
+	/*
+	 * Time all loops of a kernel at once, a single run over a working set
+	 * that fits into the caches takes only microseconds.
+	 */
+	for (k = 0; k < ARRAY_SIZE(ns); k++) {
+		if (ctrlc())
+			return -EINTR;
+
+		t = get_time_ns();
+
+		for (l = 0; l < loops; l++) {
+			switch (k) {
+			case 0:
+				membench_copy(c, a, n);
+				break;
+			case 1:
+				membench_scale(b, c, n);
+				break;
+			case 2:
+				membench_add(c, a, b, n);
+				break;
+			case 3:
+				membench_triad(a, b, c, n);
+				break;
+			}
+		}
+
+		ns[k] = get_time_ns() - t;
+	}
+
+	res->size = size;
+	res->copy = membench_mbps(2 * sizeof(u64) * n * loops, ns[0]);
+	res->scale = membench_mbps(2 * sizeof(u64) * n * loops, ns[1]);
+	res->add = membench_mbps(3 * sizeof(u64) * n * loops, ns[2]);
+	res->triad = membench_mbps(3 * sizeof(u64) * n * loops, ns[3]);
+
+	if (ctrlc())
+		return -EINTR;
+
+	membench_chase_init(buf, nlines);
+	steps = max_t(size_t, nlines, MEMBENCH_CHASE_STEPS);
+
+	/* warm up, then measure */
+	p = membench_chase(buf, nlines);
+	t = get_time_ns();
+	p = membench_chase(p, steps);
+	t = get_time_ns() - t;
+	OPTIMIZER_HIDE_VAR(p);
+
+	res->latency_ps = div64_u64(t * 1000, steps);
+
+	return 0;
+}
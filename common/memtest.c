@@ -17,6 +17,8 @@
 #include <memtest.h>
 #include <malloc.h>
 #include <mmu.h>
+#include <clock.h>
+#include <linux/math64.h>
 
 static int alloc_memtest_region(struct list_head *list,
 		resource_size_t start, resource_size_t size)
@@ -344,12 +346,13 @@ int mem_test_bus_integrity(resource_size_t _start,
 	return 0;
 }
 
+/* the tests below work on chunks of this size between polling for ctrl-c */
+#define MEMTEST_CHUNK_WORDS	(SZ_1M / sizeof(resource_size_t))
+/* the inner loops are unrolled over blocks of cache line size */
+#define MEMTEST_LINE_WORDS	(64 / sizeof(resource_size_t))
+
 static int update_progress(resource_size_t offset, unsigned flags)
 {
-	/* Only check every 4k to reduce overhead */
-	if (offset & (SZ_4K - 1))
-		return 0;
-
 	if (ctrlc())
 		return -EINTR;
 
@@ -359,11 +362,63 @@ static int update_progress(resource_size_t offset, unsigned flags)
 	return 0;
 }
 
+/*
+ * The helpers below access memory through ordinary pointers, so that the
+ * compiler can use wide loads and stores. They are noinline and separated
+ * by barriers, so that the accesses of one pass can't be combined with the
+ * ones of the next pass.
+ */
+static noinline void mem_test_fill(resource_size_t *p, resource_size_t n,
+				   resource_size_t pattern)
+{
+	resource_size_t i, j;
+
+	for (i = 0; i + MEMTEST_LINE_WORDS <= n; i += MEMTEST_LINE_WORDS)
+		for (j = 0; j < MEMTEST_LINE_WORDS; j++)
+			p[i + j] = pattern + i + j;
+
+	for (; i < n; i++)
+		p[i] = pattern + i;
+}
+
+/*
+ * Check that p[i] == pattern + i and invert it or, if inverted is set,
+ * check that p[i] == ~(pattern + i) and zero it. Returns the index of the
+ * first mismatch, or n if all words matched.
+ */
+static noinline resource_size_t mem_test_check(resource_size_t *p,
+					       resource_size_t n,
+					       resource_size_t pattern,
+					       bool inverted)
+{
+	resource_size_t invert = inverted ? ~(resource_size_t)0 : 0;
+	resource_size_t i, j, diff;
+
+	for (i = 0; i + MEMTEST_LINE_WORDS <= n; i += MEMTEST_LINE_WORDS) {
+		diff = 0;
+		for (j = 0; j < MEMTEST_LINE_WORDS; j++)
+			diff |= p[i + j] ^ (pattern + i + j) ^ invert;
+		if (diff)
+			break;
+
+		for (j = 0; j < MEMTEST_LINE_WORDS; j++)
+			p[i + j] = inverted ? 0 : ~(pattern + i + j);
+	}
+
+	for (; i < n; i++) {
+		if (p[i] != ((pattern + i) ^ invert))
+			return i;
+		p[i] = inverted ? 0 : ~(pattern + i);
+	}
+
+	return n;
+}
+
 int mem_test_moving_inversions(resource_size_t _start, resource_size_t _end,
 			       unsigned flags)
 {
-	volatile resource_size_t *start, num_words, offset, temp, anti_pattern;
-	int ret;
+	resource_size_t *start, num_words, offset, n, bad;
+	int ret, pass;
 
 	_start = ALIGN(_start, sizeof(resource_size_t));
 	_end = ALIGN_DOWN(_end, sizeof(resource_size_t)) - 1;
@@ -393,51 +448,47 @@ int mem_test_moving_inversions(resource_size_t _start, resource_size_t _end,
 	 */
 
 	/* Fill memory with a known pattern */
-	for (offset = 0; offset < num_words; offset++) {
+	for (offset = 0; offset < num_words; offset += n) {
 		ret = update_progress(offset, flags);
 		if (ret)
 			return ret;
-		start[offset] = offset + 1;
+
+		n = min_t(resource_size_t, num_words - offset, MEMTEST_CHUNK_WORDS);
+		mem_test_fill(&start[offset], n, offset + 1);
 	}
 
-	/* Check each location and invert it for the second pass */
-	for (offset = 0; offset < num_words; offset++) {
-		ret = update_progress(num_words + offset, flags);
-		if (ret)
-			return ret;
+	/*
+	 * Check each location and invert it for the second pass, then check
+	 * for the inverted pattern and zero it.
+	 */
+	for (pass = 0; pass < 2; pass++) {
+		barrier();
 
-		temp = start[offset];
-		if (temp != (offset + 1)) {
-			printf("\n");
-			mem_test_report_failure("read/write",
-						(offset + 1),
-						temp, &start[offset]);
-			return -EIO;
-		}
+		for (offset = 0; offset < num_words; offset += n) {
+			ret = update_progress((pass + 1) * num_words + offset,
+					      flags);
+			if (ret)
+				return ret;
 
-		anti_pattern = ~(offset + 1);
-		start[offset] = anti_pattern;
-	}
+			n = min_t(resource_size_t, num_words - offset,
+				  MEMTEST_CHUNK_WORDS);
 
-	/* Check each location for the inverted pattern and zero it */
-	for (offset = 0; offset < num_words; offset++) {
-		ret = update_progress(2 * num_words + offset, flags);
-		if (ret)
-			return ret;
+			bad = mem_test_check(&start[offset], n, offset + 1, pass);
+			if (bad != n) {
+				resource_size_t expected = offset + bad + 1;
 
-		anti_pattern = ~(offset + 1);
-		temp = start[offset];
+				if (pass)
+					expected = ~expected;
 
-		if (temp != anti_pattern) {
-			printf("\n");
-			mem_test_report_failure("read/write",
-						anti_pattern,
-						temp, &start[offset]);
-			return -EIO;
+				printf("\n");
+				mem_test_report_failure("read/write", expected,
+							start[offset + bad],
+							&start[offset + bad]);
+				return -EIO;
+			}
 		}
-
-		start[offset] = 0;
 	}
+
 	if (flags & MEMTEST_VERBOSE) {
 		show_progress(3 * num_words);
 
@@ -447,3 +498,100 @@ int mem_test_moving_inversions(resource_size_t _start, resource_size_t _end,
 
 	return 0;
 }
+
+static noinline resource_size_t mem_test_read(const resource_size_t *p,
+					      resource_size_t n)
+{
+	resource_size_t i, j, sum = 0;
+
+	for (i = 0; i + MEMTEST_LINE_WORDS <= n; i += MEMTEST_LINE_WORDS)
+		for (j = 0; j < MEMTEST_LINE_WORDS; j++)
+			sum ^= p[i + j];
+
+	for (; i < n; i++)
+		sum ^= p[i];
+
+	return sum;
+}
+
+static u64 mem_test_mbps(u64 bytes, u64 ns)
+{
+	/* bytes per microsecond is (decimal) MB/s */
+	return ns ? div64_u64(bytes * 1000, ns) : 0;
+}
+
+/**
+ * mem_test_bandwidth - measure memory bandwidth
+ * @_start: start of the region to measure
+ * @_end: end of the region to measure (inclusive)
+ * @flags: MEMTEST_* flags
+ * @bw: returns the measured bandwidth
+ *
+ * This writes the whole region once, reads it back once and copies its
+ * first half into its second half. The contents of the region are
+ * destroyed.
+ *
+ * Return: 0 for success, -EINTR if interrupted with ctrl-c
+ */
+int mem_test_bandwidth(resource_size_t _start, resource_size_t _end,
+		       unsigned flags, struct mem_test_bandwidth *bw)
+{
+	resource_size_t *start, num_words, offset, n, half, sum = 0;
+	u64 t, ns;
+
+	_start = ALIGN(_start, sizeof(resource_size_t));
+	_end = ALIGN_DOWN(_end, sizeof(resource_size_t)) - 1;
+
+	if (_end <= _start)
+		return -EINVAL;
+
+	start = (resource_size_t *)_start;
+	num_words = (_end - _start + 1)/sizeof(resource_size_t);
+
+	if (flags & MEMTEST_VERBOSE)
+		printf("Measuring bandwidth of RAM\n");
+
+	ns = 0;
+	for (offset = 0; offset < num_words; offset += n) {
+		if (ctrlc())
+			return -EINTR;
+
+		n = min_t(resource_size_t, num_words - offset, MEMTEST_CHUNK_WORDS);
+		t = get_time_ns();
+		mem_test_fill(&start[offset], n, 0);
+		ns += get_time_ns() - t;
+	}
+	bw->write = mem_test_mbps(num_words * sizeof(*start), ns);
+
+	barrier();
+
+	ns = 0;
+	for (offset = 0; offset < num_words; offset += n) {
+		if (ctrlc())
+			return -EINTR;
+
+		n = min_t(resource_size_t, num_words - offset, MEMTEST_CHUNK_WORDS);
+		t = get_time_ns();
+		sum ^= mem_test_read(&start[offset], n);
+		ns += get_time_ns() - t;
+	}
+	/* keep the reads from being optimized away */
+	OPTIMIZER_HIDE_VAR(sum);
+	bw->read = mem_test_mbps(num_words * sizeof(*start), ns);
+
+	half = num_words / 2;
+
+	ns = 0;
+	for (offset = 0; offset < half; offset += n) {
+		if (ctrlc())
+			return -EINTR;
+
+		n = min_t(resource_size_t, half - offset, MEMTEST_CHUNK_WORDS);
+		t = get_time_ns();
+		memcpy(&start[half + offset], &start[offset], n * sizeof(*start));
+		ns += get_time_ns() - t;
+	}
+	bw->copy = mem_test_mbps(half * sizeof(*start), ns);
+
+	return 0;
+}
@@ -12,6 +12,7 @@
 #include <param.h>
 #include <linux/ktime.h>
 #include <poller.h>
+#include <profile.h>
 #include <clock.h>
 #include <linux/ktime.h>
 
@@ -127,12 +128,16 @@ void poller_call(void)
 	__poller_active = 1;
 
 	list_for_each_entry_safe(poller, tmp, &poller_list, list) {
-		ktime_t start = ktime_get();
+		ktime_t start = ktime_get(), end;
 		s64 duration_ms;
 
 		poller->func(poller);
 
-		duration_ms = ktime_ms_delta(ktime_get(), start);
+		end = ktime_get();
+		profile_account((unsigned long)poller->func,
+				ktime_to_ns(ktime_sub(end, start)));
+
+		duration_ms = ktime_ms_delta(end, start);
 		if (duration_ms > POLLER_MAX_RUNTIME_MS) {
 			if (IS_ENABLED(CONFIG_POLLER_WARN_OVERTIME) &&
 			    poller->overtime == 2)
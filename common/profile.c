@@ -0,0 +1,388 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Cooperative sampling profiler
+ *
+ * barebox runs without interrupts, so samples are taken whenever it
+ * reschedules. Each sample records the call chain and is charged with the
+ * time elapsed since the previous sample, minus the time spent in pollers,
+ * which is charged to the pollers directly. Identical call chains share an
+ * entry in a hash table allocated when profiling starts.
+ */
+
+#define pr_fmt(fmt) "profile: " fmt
+
+#include <common.h>
+#include <clock.h>
+#include <fcntl.h>
+#include <kallsyms.h>
+#include <malloc.h>
+#include <profile.h>
+#include <qsort.h>
+#include <unistd.h>
+#include <linux/hash.h>
+#include <linux/log2.h>
+#include <linux/math64.h>
+#include <linux/stacktrace.h>
+
+#define PROFILE_DEPTH	8
+
+struct profile_stack {
+	u64 ns;
+	u32 hits;
+	u32 depth;
+	/* innermost first */
+	unsigned long pc[PROFILE_DEPTH];
+};
+
+struct profile_func {
+	unsigned long addr;
+	u64 self_ns;
+	u64 total_ns;
+};
+
+static struct profile_stack *profile_table;
+static unsigned int profile_bits;
+static unsigned int profile_used;
+static bool profile_running;
+static u64 profile_period;
+static u64 profile_last;
+static u64 profile_excluded;
+static u64 profile_total;
+static u64 profile_lost;
+
+/*
+ * Functions barebox reschedules from. Time charged to them is really
+ * spent by their callers, so they are skipped when determining the
+ * function a sample is charged to.
+ */
+static const char * const profile_wait_funcs[] = {
+	"resched",
+	"is_timeout",
+	"udelay",
+	"mdelay",
+	"ctrlc",
+};
+
+static unsigned int profile_hash(const unsigned long *pc, unsigned int depth)
+{
+	unsigned long h = depth;
+	int i;
+
+	for (i = 0; i < depth; i++)
+		h = h * 31 + pc[i];
+
+	return hash_long(h, profile_bits);
+}
+
+static void profile_add(const unsigned long *pc, unsigned int depth, u64 ns)
+{
+	unsigned int size = 1 << profile_bits;
+	unsigned int i, n;
+
+	profile_total += ns;
+
+	i = profile_hash(pc, depth);
+
+	for (n = 0; n < size; n++, i = (i + 1) & (size - 1)) {
+		struct profile_stack *s = &profile_table[i];
+
+		if (!s->depth) {
+			/* keep a free slot so that lookups terminate */
+			if (profile_used == size - 1)
+				break;
+
+			s->depth = depth;
+			memcpy(s->pc, pc, depth * sizeof(*pc));
+			profile_used++;
+		} else if (s->depth != depth ||
+			   memcmp(s->pc, pc, depth * sizeof(*pc))) {
+			continue;
+		}
+
+		s->ns += ns;
+		s->hits++;
+		return;
+	}
+
+	profile_lost += ns;
+}
+
+/**
+ * profile_sample - record the current call chain
+ *
+ * Called from resched(). Samples are taken at most once per sampling
+ * period.
+ */
+void profile_sample(void)
+{
+	unsigned long pc[PROFILE_DEPTH];
+	unsigned int i, depth;
+	u64 now, ns;
+
+	if (!profile_running)
+		return;
+
+	now = get_time_ns();
+	if (now - profile_last < profile_period)
+		return;
+
+	ns = now - profile_last;
+	ns = ns > profile_excluded ? ns - profile_excluded : 0;
+
+	profile_last = now;
+	profile_excluded = 0;
+
+	/* skip profile_sample() itself */
+	depth = stack_trace_save(pc, ARRAY_SIZE(pc), 1);
+	if (!depth)
+		return;
+
+	/* return addresses point behind the call, attribute them to it */
+	for (i = 0; i < depth; i++)
+		pc[i]--;
+
+	profile_add(pc, depth, ns);
+}
+
+/**
+ * profile_account - charge time to a function
+ * @pc: address in the function
+ * @ns: time spent in it
+ *
+ * Used for pollers, whose runtime is then not charged to the next sample.
+ */
+void profile_account(unsigned long pc, u64 ns)
+{
+	if (!profile_running)
+		return;
+
+	profile_excluded += ns;
+	profile_add(&pc, 1, ns);
+}
+
+/**
+ * profile_start - start profiling
+ * @period_ns: minimum time between two samples
+ * @nstacks: number of distinct call chains that can be recorded
+ *
+ * Previous results are discarded.
+ *
+ * Return: 0 on success, negative error code otherwise
+ */
+int profile_start(u64 period_ns, unsigned int nstacks)
+{
+	profile_free();
+
+	profile_bits = ilog2(roundup_pow_of_two(max(nstacks, 2U)));
+	profile_table = calloc(1 << profile_bits, sizeof(*profile_table));
+	if (!profile_table)
+		return -ENOMEM;
+
+	profile_period = period_ns;
+	profile_used = 0;
+	profile_total = 0;
+	profile_lost = 0;
+	profile_excluded = 0;
+	profile_last = get_time_ns();
+	profile_running = true;
+
+	return 0;
+}
+
+void profile_stop(void)
+{
+	profile_running = false;
+}
+
+void profile_free(void)
+{
+	profile_stop();
+	free(profile_table);
+	profile_table = NULL;
+}
+
+/* start address of the function containing @pc or @pc if unknown */
+static unsigned long profile_func_addr(unsigned long pc)
+{
+	char namebuf[KSYM_NAME_LEN];
+	unsigned long size, offset;
+
+	if (!kallsyms_lookup(pc, &size, &offset, NULL, namebuf))
+		return pc;
+
+	return pc - offset;
+}
+
+static bool profile_is_wait_func(unsigned long addr)
+{
+	char namebuf[KSYM_NAME_LEN];
+	unsigned long size, offset;
+	int i;
+
+	if (!kallsyms_lookup(addr, &size, &offset, NULL, namebuf))
+		return false;
+
+	for (i = 0; i < ARRAY_SIZE(profile_wait_funcs); i++)
+		if (!strcmp(namebuf, profile_wait_funcs[i]))
+			return true;
+
+	return false;
+}
+
+static struct profile_func *profile_func_get(struct profile_func **funcs,
+					     unsigned int *nfuncs,
+					     unsigned long addr)
+{
+	struct profile_func *f;
+	int i;
+
+	for (i = 0; i < *nfuncs; i++)
+		if ((*funcs)[i].addr == addr)
+			return &(*funcs)[i];
+
+	if (!(*nfuncs & 63)) {
+		f = realloc(*funcs, (*nfuncs + 64) * sizeof(*f));
+		if (!f)
+			return NULL;
+		*funcs = f;
+	}
+
+	f = &(*funcs)[(*nfuncs)++];
+	f->addr = addr;
+	f->self_ns = 0;
+	f->total_ns = 0;
+
+	return f;
+}
+
+static int profile_func_cmp(const void *a, const void *b)
+{
+	const struct profile_func *fa = a, *fb = b;
+
+	if (fa->self_ns == fb->self_ns)
+		return 0;
+
+	return fa->self_ns < fb->self_ns ? 1 : -1;
+}
+
+static unsigned int profile_percent(u64 ns)
+{
+	if (!profile_total)
+		return 0;
+
+	return div64_u64(ns * 1000, profile_total);
+}
+
+/**
+ * profile_report - print the functions most time was charged to
+ * @top: number of functions to print
+ *
+ * The self time of a sample goes to the innermost function that is not a
+ * wait function, the total time to all functions in its call chain.
+ */
+void profile_report(unsigned int top)
+{
+	struct profile_func *funcs = NULL, *f;
+	unsigned int nfuncs = 0, size, i, j, k;
+	u64 samples = 0;
+
+	if (!profile_table)
+		return;
+
+	size = 1 << profile_bits;
+
+	for (i = 0; i < size; i++) {
+		struct profile_stack *s = &profile_table[i];
+		unsigned long addr[PROFILE_DEPTH];
+		bool self = false;
+
+		if (!s->depth)
+			continue;
+
+		samples += s->hits;
+
+		for (j = 0; j < s->depth; j++) {
+			addr[j] = profile_func_addr(s->pc[j]);
+
+			/* count recursive functions only once */
+			for (k = 0; k < j; k++)
+				if (addr[k] == addr[j])
+					break;
+			if (k < j)
+				continue;
+
+			f = profile_func_get(&funcs, &nfuncs, addr[j]);
+			if (!f)
+				goto out;
+
+			f->total_ns += s->ns;
+
+			if (!self && (j == s->depth - 1 ||
+				      !profile_is_wait_func(addr[j]))) {
+				f->self_ns += s->ns;
+				self = true;
+			}
+		}
+	}
+
+	qsort(funcs, nfuncs, sizeof(*funcs), profile_func_cmp);
+
+	printf("%llu samples, %llu ms profiled, %llu ms lost, %u call chains\n",
+	       samples, div_u64(profile_total, MSECOND),
+	       div_u64(profile_lost, MSECOND), profile_used);
+	printf("  self%%    self ms  total%%  function\n");
+
+	for (i = 0; i < min(top, nfuncs); i++) {
+		unsigned int self, total;
+
+		f = &funcs[i];
+		self = profile_percent(f->self_ns);
+		total = profile_percent(f->total_ns);
+
+		printf("%3u.%u%% %10llu %4u.%u%%  %ps\n",
+		       self / 10, self % 10, div_u64(f->self_ns, MSECOND),
+		       total / 10, total % 10, (void *)f->addr);
+	}
+out:
+	free(funcs);
+}
+
+/**
+ * profile_write_folded - write the recorded call chains to a file
+ * @filename: the file
+ *
+ * Uses the folded stack format also produced by stackcollapse-perf.pl
+ * from perf script output, one line per call chain with the outermost
+ * function first and the time in microseconds, so the result can be fed
+ * to flamegraph.pl and similar tools.
+ *
+ * Return: 0 on success, negative error code otherwise
+ */
+int profile_write_folded(const char *filename)
+{
+	unsigned int size, i;
+	int fd, j;
+
+	if (!profile_table)
+		return -ENODATA;
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd < 0)
+		return fd;
+
+	size = 1 << profile_bits;
+
+	for (i = 0; i < size; i++) {
+		struct profile_stack *s = &profile_table[i];
+
+		if (!s->depth)
+			continue;
+
+		for (j = s->depth - 1; j >= 0; j--)
+			dprintf(fd, "%ps%c", (void *)s->pc[j], j ? ';' : ' ');
+
+		dprintf(fd, "%llu\n", div_u64(s->ns, USECOND));
+	}
+
+	return close(fd);
+}
@@ -5,6 +5,7 @@
 #include <work.h>
 #include <slice.h>
 #include <sched.h>
+#include <profile.h>
 
 void resched(void)
 {
@@ -13,6 +14,8 @@ void resched(void)
 	if (poller_active())
 		return;
 
+	profile_sample();
+
 	command_slice_acquire();
 
 	if (run_workqueues) {
@@ -17,6 +17,8 @@
 #include <linux/kasan.h>
 #include <linux/list.h>
 
+#include "tlsf_slab.h"
+
 tlsf_t tlsf_mem_pool;
 static void (*malloc_request_store)(size_t bytes);
 
@@ -36,7 +38,9 @@ void *malloc(size_t bytes)
 {
 	void *mem;
 
-	mem = tlsf_malloc(tlsf_mem_pool, bytes);
+	mem = tlsf_slab_alloc(tlsf_mem_pool, bytes);
+	if (!mem)
+		mem = tlsf_malloc(tlsf_mem_pool, bytes);
 	if (!mem)
 		errno = ENOMEM;
 
@@ -46,19 +50,25 @@ EXPORT_SYMBOL(malloc);
 
 void free(void *mem)
 {
-	tlsf_free(tlsf_mem_pool, mem);
+	if (!tlsf_slab_free(tlsf_mem_pool, mem))
+		tlsf_free(tlsf_mem_pool, mem);
 }
 EXPORT_SYMBOL(free);
 
 size_t malloc_usable_size(void *mem)
 {
-	return tlsf_block_size(mem);
+	return tlsf_slab_size(mem) ?: tlsf_block_size(mem);
 }
 EXPORT_SYMBOL(malloc_usable_size);
 
 void *realloc(void *oldmem, size_t bytes)
 {
-	void *mem = tlsf_realloc(tlsf_mem_pool, oldmem, bytes);
+	void *mem;
+
+	if (tlsf_slab_size(oldmem))
+		mem = tlsf_slab_realloc(tlsf_mem_pool, oldmem, bytes);
+	else
+		mem = tlsf_realloc(tlsf_mem_pool, oldmem, bytes);
 	if (!mem)
 		errno = ENOMEM;
 
@@ -103,6 +113,8 @@ void malloc_stats(void)
 		tlsf_walk_pool(cur_pool->pool, malloc_walker, &s);
 
 	printf("used: %zu\nfree: %zu\n", s.used, s.free);
+
+	tlsf_slab_stats();
 }
 
 void malloc_add_pool(void *mem, size_t bytes)
@@ -123,6 +135,8 @@ void malloc_add_pool(void *mem, size_t bytes)
 	if (!new_pool)
 		return;
 
+	tlsf_slab_add_pool(tlsf_mem_pool, mem, bytes);
+
 	new_pool_entry = malloc(sizeof(*new_pool_entry));
 	if (!new_pool_entry)
 		return;
@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Size-class slab caches in front of TLSF
+ *
+ * Most allocations in barebox are tiny: device and parameter structures,
+ * list nodes and strings. For those the TLSF block header and its two
+ * level search are relatively expensive. Requests up to SLAB_MAX_SIZE are
+ * therefore served from per size-class caches instead. Each cache carves
+ * SLAB_PAGE_SIZE sized pages, allocated aligned from TLSF, into equally
+ * sized objects and keeps freed objects on a per-page free list for reuse.
+ *
+ * Whether a pointer belongs to a slab page is looked up in a per-pool
+ * bitmap with one bit per page, so free() never has to trust the contents
+ * of memory in front of an arbitrary TLSF allocation. Each page in turn
+ * has a bitmap of the objects handed out, which catches double frees and
+ * pointers into the middle of objects before they corrupt the free list.
+ *
+ * Like tlsf.c, this file is not instrumented by KASAN: it reads and writes
+ * the free list inside of freed objects. Objects are poisoned when freed
+ * and unpoisoned up to the requested size when allocated instead.
+ */
+
+#define pr_fmt(fmt) "slab: " fmt
+
+#include <common.h>
+#include <malloc.h>
+#include <string.h>
+#include <linux/bitmap.h>
+#include <linux/kasan.h>
+#include <linux/list.h>
+#include <linux/log2.h>
+#include <linux/sizes.h>
+
+#include "tlsf_slab.h"
+
+#ifndef CONFIG_KASAN
+#define __memcpy memcpy
+#endif
+
+#define SLAB_PAGE_SHIFT		12
+#define SLAB_PAGE_SIZE		(1UL << SLAB_PAGE_SHIFT)
+#define SLAB_MIN_SHIFT		4
+#define SLAB_MAX_SHIFT		7
+#define SLAB_MAX_SIZE		(1 << SLAB_MAX_SHIFT)
+#define SLAB_NR_CACHES		(SLAB_MAX_SHIFT - SLAB_MIN_SHIFT + 1)
+
+struct slab_cache {
+	unsigned int size;
+	unsigned int objs_per_page;
+	struct list_head partial;	/* pages with free objects */
+	unsigned int empty;		/* number of completely free pages */
+
+	/* statistics */
+	unsigned long pages;
+	unsigned long inuse;
+	unsigned long allocs;
+	unsigned long fallbacks;
+};
+
+struct slab_page {
+	struct slab_cache *cache;
+	struct list_head list;
+	void *freelist;
+	unsigned int inuse;
+	unsigned long allocated[BITS_TO_LONGS(SLAB_PAGE_SIZE >> SLAB_MIN_SHIFT)];
+};
+
+#define SLAB_HDR_SIZE		ALIGN(sizeof(struct slab_page), 16)
+
+struct slab_pool {
+	struct list_head list;
+	unsigned long first;		/* page frame number of the first page */
+	unsigned long npages;
+	unsigned long map[];		/* pages used for slabs */
+};
+
+static LIST_HEAD(slab_pools);
+
+#define SLAB_CACHE(shift) {						\
+	.size = 1 << (shift),						\
+	.objs_per_page = (SLAB_PAGE_SIZE - SLAB_HDR_SIZE) >> (shift),	\
+	.partial = LIST_HEAD_INIT(slab_caches[(shift) - SLAB_MIN_SHIFT].partial), \
+}
+
+static struct slab_cache slab_caches[SLAB_NR_CACHES] = {
+	SLAB_CACHE(4), SLAB_CACHE(5), SLAB_CACHE(6), SLAB_CACHE(7),
+};
+
+static inline void *slab_obj(struct slab_page *page, unsigned int i)
+{
+	return (void *)page + SLAB_HDR_SIZE + i * page->cache->size;
+}
+
+/* Index of the object at @mem, or -1 if @mem doesn't point to one */
+static int slab_obj_index(struct slab_page *page, const void *mem)
+{
+	struct slab_cache *cache = page->cache;
+	unsigned long offset = mem - slab_obj(page, 0);
+
+	if (mem < slab_obj(page, 0) || offset & (cache->size - 1) ||
+	    offset / cache->size >= cache->objs_per_page)
+		return -1;
+
+	return offset / cache->size;
+}
+
+void tlsf_slab_add_pool(tlsf_t tlsf, void *mem, size_t bytes)
+{
+	unsigned long first = (unsigned long)mem >> SLAB_PAGE_SHIFT;
+	unsigned long last = ((unsigned long)mem + bytes - 1) >> SLAB_PAGE_SHIFT;
+	struct slab_pool *pool;
+	size_t size;
+
+	size = sizeof(*pool) + BITS_TO_LONGS(last - first + 1) * sizeof(long);
+
+	/* Without a map, pages of this pool are just never used for slabs */
+	pool = tlsf_malloc(tlsf, size);
+	if (!pool)
+		return;
+
+	memset(pool, 0, size);
+	pool->first = first;
+	pool->npages = last - first + 1;
+	list_add(&pool->list, &slab_pools);
+}
+
+static struct slab_pool *slab_pool_of(const void *mem, unsigned long *pfn)
+{
+	struct slab_pool *pool;
+
+	*pfn = (unsigned long)mem >> SLAB_PAGE_SHIFT;
+
+	list_for_each_entry(pool, &slab_pools, list) {
+		if (*pfn - pool->first < pool->npages) {
+			*pfn -= pool->first;
+			return pool;
+		}
+	}
+
+	return NULL;
+}
+
+static struct slab_page *slab_page_of(const void *mem)
+{
+	struct slab_pool *pool;
+	unsigned long pfn;
+
+	if (!mem)
+		return NULL;
+
+	pool = slab_pool_of(mem, &pfn);
+	if (!pool || !test_bit(pfn, pool->map))
+		return NULL;
+
+	return (void *)ALIGN_DOWN((unsigned long)mem, SLAB_PAGE_SIZE);
+}
+
+static struct slab_page *slab_new_page(tlsf_t tlsf, struct slab_cache *cache)
+{
+	struct slab_page *page;
+	struct slab_pool *pool;
+	unsigned long pfn;
+	void **next, **obj;
+	int i;
+
+	page = tlsf_memalign(tlsf, SLAB_PAGE_SIZE, SLAB_PAGE_SIZE);
+	if (!page)
+		return NULL;
+
+	pool = slab_pool_of(page, &pfn);
+	if (!pool) {
+		tlsf_free(tlsf, page);
+		return NULL;
+	}
+
+	__set_bit(pfn, pool->map);
+
+	page->cache = cache;
+	page->inuse = 0;
+	bitmap_zero(page->allocated, cache->objs_per_page);
+
+	next = &page->freelist;
+	for (i = 0; i < cache->objs_per_page; i++) {
+		obj = slab_obj(page, i);
+		*next = obj;
+		next = obj;
+	}
+	*next = NULL;
+
+	kasan_poison_shadow(page, SLAB_HDR_SIZE, KASAN_KMALLOC_REDZONE);
+	kasan_poison_shadow(slab_obj(page, 0), cache->objs_per_page * cache->size,
+			    KASAN_KMALLOC_FREE);
+
+	list_add(&page->list, &cache->partial);
+	cache->pages++;
+	cache->empty++;
+
+	return page;
+}
+
+static void slab_release_page(tlsf_t tlsf, struct slab_page *page)
+{
+	struct slab_cache *cache = page->cache;
+	struct slab_pool *pool;
+	unsigned long pfn;
+
+	list_del(&page->list);
+	cache->pages--;
+	cache->empty--;
+
+	pool = slab_pool_of(page, &pfn);
+	__clear_bit(pfn, pool->map);
+
+	tlsf_free(tlsf, page);
+}
+
+void *tlsf_slab_alloc(tlsf_t tlsf, size_t bytes)
+{
+	struct slab_cache *cache;
+	struct slab_page *page;
+	void **obj;
+
+	if (!bytes || bytes > SLAB_MAX_SIZE)
+		return NULL;
+
+	cache = &slab_caches[max(order_base_2(bytes), SLAB_MIN_SHIFT) - SLAB_MIN_SHIFT];
+
+	if (list_empty(&cache->partial)) {
+		page = slab_new_page(tlsf, cache);
+		if (!page) {
+			cache->fallbacks++;
+			return NULL;
+		}
+	} else {
+		page = list_first_entry(&cache->partial, struct slab_page, list);
+	}
+
+	obj = page->freelist;
+	page->freelist = *obj;
+	__set_bit(slab_obj_index(page, obj), page->allocated);
+
+	if (!page->inuse++)
+		cache->empty--;
+	if (!page->freelist)
+		list_del(&page->list);
+
+	cache->inuse++;
+	cache->allocs++;
+
+	kasan_poison_shadow(obj, cache->size, KASAN_KMALLOC_REDZONE);
+	kasan_unpoison_shadow(obj, bytes);
+
+	return obj;
+}
+
+static void slab_free(tlsf_t tlsf, struct slab_page *page, void *mem)
+{
+	struct slab_cache *cache = page->cache;
+	int i = slab_obj_index(page, mem);
+	void **obj = mem;
+
+	/* leak the object rather than corrupting the free list */
+	if (i < 0 || !__test_and_clear_bit(i, page->allocated)) {
+		tlsf_assert(0 && "invalid or already freed slab object");
+		return;
+	}
+
+	kasan_poison_shadow(obj, cache->size, KASAN_KMALLOC_FREE);
+
+	if (!page->freelist)
+		list_add(&page->list, &cache->partial);
+
+	*obj = page->freelist;
+	page->freelist = obj;
+	cache->inuse--;
+
+	if (--page->inuse)
+		return;
+
+	/* keep one empty page per cache around to avoid thrashing */
+	if (cache->empty++)
+		slab_release_page(tlsf, page);
+}
+
+bool tlsf_slab_free(tlsf_t tlsf, void *mem)
+{
+	struct slab_page *page = slab_page_of(mem);
+
+	if (!page)
+		return false;
+
+	slab_free(tlsf, page, mem);
+
+	return true;
+}
+
+size_t tlsf_slab_size(const void *mem)
+{
+	struct slab_page *page = slab_page_of(mem);
+
+	return page ? page->cache->size : 0;
+}
+
+void *tlsf_slab_realloc(tlsf_t tlsf, void *mem, size_t bytes)
+{
+	struct slab_page *page = slab_page_of(mem);
+	void *new;
+
+	if (!bytes) {
+		slab_free(tlsf, page, mem);
+		return NULL;
+	}
+
+	if (bytes <= page->cache->size) {
+		kasan_poison_shadow(mem, page->cache->size, KASAN_KMALLOC_REDZONE);
+		kasan_unpoison_shadow(mem, bytes);
+		return mem;
+	}
+
+	new = malloc(bytes);
+	if (!new)
+		return NULL;
+
+	__memcpy(new, mem, page->cache->size);
+	slab_free(tlsf, page, mem);
+
+	return new;
+}
+
+void tlsf_slab_stats(void)
+{
+	int i;
+
+	printf("slab   size   pages  objects   in use      allocs  fallbacks\n");
+
+	for (i = 0; i < SLAB_NR_CACHES; i++) {
+		struct slab_cache *cache = &slab_caches[i];
+
+		printf("      %5u  %6lu  %7lu  %7lu  %10lu  %9lu\n",
+		       cache->size, cache->pages,
+		       cache->pages * cache->objs_per_page, cache->inuse,
+		       cache->allocs, cache->fallbacks);
+	}
+}
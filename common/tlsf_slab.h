@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __TLSF_SLAB_H
+#define __TLSF_SLAB_H
+
+#include <linux/types.h>
+#include <tlsf.h>
+
+#ifdef CONFIG_MALLOC_TLSF_SLAB
+void tlsf_slab_add_pool(tlsf_t tlsf, void *mem, size_t bytes);
+void *tlsf_slab_alloc(tlsf_t tlsf, size_t bytes);
+bool tlsf_slab_free(tlsf_t tlsf, void *mem);
+size_t tlsf_slab_size(const void *mem);
+void *tlsf_slab_realloc(tlsf_t tlsf, void *mem, size_t bytes);
+void tlsf_slab_stats(void);
+#else
+static inline void tlsf_slab_add_pool(tlsf_t tlsf, void *mem, size_t bytes)
+{
+}
+
+static inline void *tlsf_slab_alloc(tlsf_t tlsf, size_t bytes)
+{
+	return NULL;
+}
+
+static inline bool tlsf_slab_free(tlsf_t tlsf, void *mem)
+{
+	return false;
+}
+
+static inline size_t tlsf_slab_size(const void *mem)
+{
+	return 0;
+}
+
+static inline void *tlsf_slab_realloc(tlsf_t tlsf, void *mem, size_t bytes)
+{
+	return NULL;
+}
+
+static inline void tlsf_slab_stats(void)
+{
+}
+#endif
+
+#endif /* __TLSF_SLAB_H */
@@ -24,7 +24,20 @@
 #define __efi_runtime
 #endif
 
-static uint32_t crc_table[sizeof(uint32_t) * 256];
+/*
+ * With slice-by-8, seven additional tables are derived from the first one,
+ * so that eight input bytes can be folded into the CRC per iteration.
+ * The PBL sticks to the single byte-wise table to keep its BSS small.
+ */
+#if !defined(__BAREBOX__)
+#define CRC_SLICES	8
+#elif defined(CONFIG_CRC32_SLICEBY8) && !defined(__PBL__)
+#define CRC_SLICES	8
+#else
+#define CRC_SLICES	1
+#endif
+
+static uint32_t crc_table[CRC_SLICES][256];
 
 /*
   Generate a table for a byte-wise 32-bit CRC calculation on the polynomial:
@@ -49,6 +62,10 @@ static uint32_t crc_table[sizeof(uint32_t) * 256];
   The table is simply the CRC of all possible eight bit values.  This is all
   the information needed to generate CRC's on data a byte at a time for all
   combinations of CRC register values and incoming bytes.
+
+  Table k (k > 0) holds the CRC of each byte value followed by k zero bytes,
+  which allows processing several bytes independently and combining the
+  results with exclusive-or.
 */
 static void make_crc_table(void)
 {
@@ -58,7 +75,7 @@ static void make_crc_table(void)
 	/* terms of polynomial defining this crc (except x^32): */
 	static const char p[] = { 0, 1, 2, 4, 5, 7, 8, 10, 11, 12, 16, 22, 23, 26 };
 
-	if (crc_table[1])
+	if (crc_table[0][1])
 		return;
 
 	/* make exclusive-or pattern from polynomial (0xedb88320L) */
@@ -70,11 +87,19 @@ static void make_crc_table(void)
 		c = (uint32_t) n;
 		for (k = 0; k < 8; k++)
 			c = c & 1 ? poly ^ (c >> 1) : c >> 1;
-		crc_table[n] = c;
+		crc_table[0][n] = c;
+	}
+
+	for (n = 0; n < 256; n++) {
+		c = crc_table[0][n];
+		for (k = 1; k < CRC_SLICES; k++) {
+			c = crc_table[0][c & 0xff] ^ (c >> 8);
+			crc_table[k][n] = c;
+		}
 	}
 }
 
-#define DO1(buf) crc = crc_table[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
+#define DO1(buf) crc = crc_table[0][((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
 #define DO2(buf)  DO1(buf); DO1(buf);
 #define DO4(buf)  DO2(buf); DO2(buf);
 #define DO8(buf)  DO4(buf); DO4(buf);
@@ -82,7 +107,8 @@ static void make_crc_table(void)
 /* No ones complement version. JFFS2 (and other things ?)
  * don't use ones compliment in their CRC calculations.
  */
-STATIC uint32_t crc32_no_comp(uint32_t crc, const void *_buf, unsigned int len)
+STATIC uint32_t crc32_no_comp_bytewise(uint32_t crc, const void *_buf,
+				       unsigned int len)
 {
 	const unsigned char *buf = _buf;
 
@@ -100,6 +126,67 @@ STATIC uint32_t crc32_no_comp(uint32_t crc, const void *_buf, unsigned int len)
 	return crc;
 }
 
+#if CRC_SLICES == 8
+static inline uint32_t crc_load_le32(const unsigned char *buf)
+{
+	return buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t)buf[3] << 24;
+}
+
+/* Slice-by-8: fold eight input bytes into the CRC per loop iteration */
+STATIC uint32_t crc32_no_comp_sliceby8(uint32_t crc, const void *_buf,
+				       unsigned int len)
+{
+	const unsigned char *buf = _buf;
+	uint32_t lo, hi;
+
+	make_crc_table();
+
+	while (len >= 8) {
+		lo = crc_load_le32(buf) ^ crc;
+		hi = crc_load_le32(buf + 4);
+
+		crc = crc_table[7][lo & 0xff] ^
+		      crc_table[6][(lo >> 8) & 0xff] ^
+		      crc_table[5][(lo >> 16) & 0xff] ^
+		      crc_table[4][lo >> 24] ^
+		      crc_table[3][hi & 0xff] ^
+		      crc_table[2][(hi >> 8) & 0xff] ^
+		      crc_table[1][(hi >> 16) & 0xff] ^
+		      crc_table[0][hi >> 24];
+
+		buf += 8;
+		len -= 8;
+	}
+
+	while (len--)
+		DO1(buf);
+
+	return crc;
+}
+#else
+STATIC uint32_t crc32_no_comp_sliceby8(uint32_t crc, const void *buf,
+				       unsigned int len)
+{
+	return crc32_no_comp_bytewise(crc, buf, len);
+}
+#endif
+
+STATIC uint32_t crc32_no_comp(uint32_t crc, const void *buf, unsigned int len)
+{
+#if defined(__BAREBOX__) && !defined(__PBL__)
+	if (crc32_arch_available())
+		return crc32_no_comp_arch(crc, buf, len);
+#endif
+
+	return crc32_no_comp_sliceby8(crc, buf, len);
+}
+
+#ifdef __BAREBOX__
+EXPORT_SYMBOL(crc32_no_comp);
+EXPORT_SYMBOL(crc32_no_comp_bytewise);
+EXPORT_SYMBOL(crc32_no_comp_sliceby8);
+#endif
+
 STATIC uint32_t crc32(uint32_t crc, const void *buf, unsigned int len)
 {
 	return ~crc32_no_comp(~crc, buf, len);
@@ -1387,8 +1387,196 @@ static void ecc_point_add(const struct ecc_point *result,
 	apply_z(result->x, result->y, z, curve);
 }
 
+/*
+ * Tables of odd multiples P, 3P, 5P, ... (2^w - 1)P in affine coordinates
+ * for the windowed joint scalar multiplication below.
+ */
+struct ecc_point_table {
+	unsigned int w;
+	unsigned int npoints;
+	u64 *x;	/* npoints * ndigits */
+	u64 *y;
+};
+
+/* Window sizes for the generator (cached) and the public key (per call) */
+#define ECC_G_WINDOW	6
+#define ECC_Q_WINDOW	4
+
+static struct {
+	const struct ecc_curve *curve;
+	struct ecc_point_table *table;
+} ecc_g_tables[4];
+
+static void ecc_point_table_free(struct ecc_point_table *t)
+{
+	if (!t)
+		return;
+
+	free(t->x);
+	free(t->y);
+	free(t);
+}
+
+/*
+ * Build the table of odd multiples with a co-Z addition chain, collecting
+ * the Z coordinates and converting everything to affine coordinates with
+ * a single field inversion (Montgomery's trick).
+ */
+static struct ecc_point_table *ecc_point_table_build(const struct ecc_point *p,
+						     unsigned int w,
+						     const struct ecc_curve *curve)
+{
+	const unsigned int ndigits = curve->g.ndigits;
+	struct ecc_point_table *t;
+	u64 dx[ECC_MAX_DIGITS], dy[ECC_MAX_DIGITS];
+	u64 z[ECC_MAX_DIGITS], inv[ECC_MAX_DIGITS];
+	u64 *zs;
+	unsigned int i;
+
+	t = calloc(1, sizeof(*t));
+	if (!t)
+		return NULL;
+
+	t->w = w;
+	t->npoints = 1 << (w - 1);
+	t->x = malloc(t->npoints * ndigits * sizeof(u64));
+	t->y = malloc(t->npoints * ndigits * sizeof(u64));
+	/* zs[i] holds the factor by which entry i's Z exceeds entry i-1's */
+	zs = malloc(t->npoints * ndigits * sizeof(u64));
+	if (!t->x || !t->y || !zs)
+		goto err;
+
+#define TX(i)	(&t->x[(i) * ndigits])
+#define TY(i)	(&t->y[(i) * ndigits])
+#define ZS(i)	(&zs[(i) * ndigits])
+
+	vli_set(TX(0), p->x, ndigits);
+	vli_set(TY(0), p->y, ndigits);
+
+	if (t->npoints == 1)
+		goto out;
+
+	/* D = 2P, and a copy of P sharing its Z coordinate */
+	vli_set(dx, p->x, ndigits);
+	vli_set(dy, p->y, ndigits);
+	vli_clear(z, ndigits);
+	z[0] = 1;
+	ecc_point_double_jacobian(dx, dy, z, curve);
+
+	vli_set(TX(1), p->x, ndigits);
+	vli_set(TY(1), p->y, ndigits);
+	apply_z(TX(1), TY(1), z, curve);
+
+	/* entry i = entry i-1 + D, all in Jacobian coordinates for now */
+	for (i = 1; i < t->npoints; i++) {
+		if (i > 1) {
+			vli_set(TX(i), TX(i - 1), ndigits);
+			vli_set(TY(i), TY(i - 1), ndigits);
+		}
+		vli_mod_sub(ZS(i), TX(i), dx, curve->p, ndigits);
+		xycz_add(dx, dy, TX(i), TY(i), curve);
+		vli_mod_mult_fast(z, z, ZS(i), curve);
+	}
+
+	/*
+	 * z is now the Z coordinate of the last entry. Walking backwards,
+	 * 1/Z(i-1) = zs[i] / Z(i), so one inversion suffices for all.
+	 */
+	vli_mod_inv(inv, z, curve->p, ndigits);
+
+	for (i = t->npoints - 1; i > 0; i--) {
+		apply_z(TX(i), TY(i), inv, curve);
+		vli_mod_mult_fast(inv, inv, ZS(i), curve);
+	}
+
+#undef TX
+#undef TY
+#undef ZS
+out:
+	free(zs);
+	return t;
+err:
+	free(zs);
+	ecc_point_table_free(t);
+	return NULL;
+}
+
+static struct ecc_point_table *ecc_get_g_table(const struct ecc_curve *curve)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ecc_g_tables); i++) {
+		if (ecc_g_tables[i].curve == curve)
+			return ecc_g_tables[i].table;
+
+		if (!ecc_g_tables[i].curve) {
+			struct ecc_point_table *t;
+
+			t = ecc_point_table_build(&curve->g, ECC_G_WINDOW, curve);
+			if (!t)
+				return NULL;
+
+			ecc_g_tables[i].curve = curve;
+			ecc_g_tables[i].table = t;
+			return t;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Sliding window recoding: scalar = sum(digits[i] * 2^i), with each
+ * digit either zero or odd and below 2^w. Returns the number of digits.
+ */
+static unsigned int ecc_window_recode(u8 *digits, const u64 *scalar,
+				      unsigned int w, unsigned int ndigits)
+{
+	unsigned int num_bits = vli_num_bits(scalar, ndigits);
+	unsigned int i = 0, j;
+
+	memset(digits, 0, num_bits);
+
+	while (i < num_bits) {
+		if (!vli_test_bit(scalar, i)) {
+			i++;
+			continue;
+		}
+
+		for (j = 0; j < w && i + j < num_bits; j++)
+			if (vli_test_bit(scalar, i + j))
+				digits[i] |= 1 << j;
+
+		i += w;
+	}
+
+	return num_bits;
+}
+
+/* (rx, ry, z) += (x, y), with the latter in affine coordinates */
+static void ecc_point_add_mixed(u64 *rx, u64 *ry, u64 *z,
+				const u64 *x, const u64 *y,
+				const struct ecc_curve *curve)
+{
+	const unsigned int ndigits = curve->g.ndigits;
+	u64 tx[ECC_MAX_DIGITS];
+	u64 ty[ECC_MAX_DIGITS];
+	u64 tz[ECC_MAX_DIGITS];
+
+	vli_set(tx, x, ndigits);
+	vli_set(ty, y, ndigits);
+	apply_z(tx, ty, z, curve);
+	vli_mod_sub(tz, rx, tx, curve->p, ndigits);
+	xycz_add(tx, ty, rx, ry, curve);
+	vli_mod_mult_fast(z, z, tz, curve);
+}
+
 /* Computes R = u1P + u2Q mod p using Shamir's trick.
- * Based on: Kenneth MacKay's micro-ecc (2014).
+ *
+ * Both scalars are recoded into sliding windows and processed in a single
+ * run of doublings (Straus' method), adding precomputed odd multiples of P
+ * and Q. The table for the generator point is computed once per curve with
+ * a wider window and kept around, the one for Q is built per call.
  */
 void ecc_point_mult_shamir(const struct ecc_point *result,
 			   const u64 *u1, const struct ecc_point *p,
@@ -1396,54 +1584,72 @@ void ecc_point_mult_shamir(const struct ecc_point *result,
 			   const struct ecc_curve *curve)
 {
 	u64 z[ECC_MAX_DIGITS];
-	u64 sump[2][ECC_MAX_DIGITS];
 	u64 *rx = result->x;
 	u64 *ry = result->y;
 	unsigned int ndigits = curve->g.ndigits;
-	unsigned int num_bits;
-	struct ecc_point sum = ECC_POINT_INIT(sump[0], sump[1], ndigits);
-	const struct ecc_point *points[4];
-	const struct ecc_point *point;
-	unsigned int idx;
+	u8 d1[ECC_MAX_DIGITS * 64], d2[ECC_MAX_DIGITS * 64];
+	struct ecc_point_table *tp, *tq;
+	unsigned int n1, n2;
+	bool started = false;
 	int i;
 
-	ecc_point_add(&sum, p, q, curve);
-	points[0] = NULL;
-	points[1] = p;
-	points[2] = q;
-	points[3] = &sum;
+	if (p == &curve->g)
+		tp = ecc_get_g_table(curve);
+	else
+		tp = ecc_point_table_build(p, ECC_Q_WINDOW, curve);
+	tq = ecc_point_table_build(q, ECC_Q_WINDOW, curve);
+
+	/* fall back to the tables' first entries only: plain Shamir's trick */
+	n1 = ecc_window_recode(d1, u1, tp ? tp->w : 1, ndigits);
+	n2 = ecc_window_recode(d2, u2, tq ? tq->w : 1, ndigits);
+
+	vli_clear(rx, ndigits);
+	vli_clear(ry, ndigits);
+
+	for (i = max(n1, n2) - 1; i >= 0; i--) {
+		const u64 *x, *y;
+
+		if (started)
+			ecc_point_double_jacobian(rx, ry, z, curve);
+
+		if (i < n1 && d1[i]) {
+			x = tp ? &tp->x[(d1[i] >> 1) * ndigits] : p->x;
+			y = tp ? &tp->y[(d1[i] >> 1) * ndigits] : p->y;
+
+			if (started) {
+				ecc_point_add_mixed(rx, ry, z, x, y, curve);
+			} else {
+				vli_set(rx, x, ndigits);
+				vli_set(ry, y, ndigits);
+				vli_clear(z + 1, ndigits - 1);
+				z[0] = 1;
+				started = true;
+			}
+		}
 
-	num_bits = max(vli_num_bits(u1, ndigits), vli_num_bits(u2, ndigits));
-	i = num_bits - 1;
-	idx = !!vli_test_bit(u1, i);
-	idx |= (!!vli_test_bit(u2, i)) << 1;
-	point = points[idx];
+		if (i < n2 && d2[i]) {
+			x = tq ? &tq->x[(d2[i] >> 1) * ndigits] : q->x;
+			y = tq ? &tq->y[(d2[i] >> 1) * ndigits] : q->y;
+
+			if (started) {
+				ecc_point_add_mixed(rx, ry, z, x, y, curve);
+			} else {
+				vli_set(rx, x, ndigits);
+				vli_set(ry, y, ndigits);
+				vli_clear(z + 1, ndigits - 1);
+				z[0] = 1;
+				started = true;
+			}
+		}
+	}
 
-	BUG_ON(!point);
+	if (p != &curve->g)
+		ecc_point_table_free(tp);
+	ecc_point_table_free(tq);
 
-	vli_set(rx, point->x, ndigits);
-	vli_set(ry, point->y, ndigits);
-	vli_clear(z + 1, ndigits - 1);
-	z[0] = 1;
+	if (!started)
+		return;
 
-	for (--i; i >= 0; i--) {
-		ecc_point_double_jacobian(rx, ry, z, curve);
-		idx = !!vli_test_bit(u1, i);
-		idx |= (!!vli_test_bit(u2, i)) << 1;
-		point = points[idx];
-		if (point) {
-			u64 tx[ECC_MAX_DIGITS];
-			u64 ty[ECC_MAX_DIGITS];
-			u64 tz[ECC_MAX_DIGITS];
-
-			vli_set(tx, point->x, ndigits);
-			vli_set(ty, point->y, ndigits);
-			apply_z(tx, ty, z, curve);
-			vli_mod_sub(tz, rx, tx, curve->p, ndigits);
-			xycz_add(tx, ty, rx, ry, curve);
-			vli_mod_mult_fast(z, z, tz, curve);
-		}
-	}
 	vli_mod_inv(z, z, curve->p, ndigits);
 	apply_z(rx, ry, z, curve);
 }
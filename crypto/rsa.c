@@ -165,16 +165,16 @@ static int num_public_exponent_bits(const struct rsa_public_key *key,
 static int is_public_exponent_bit_set(const struct rsa_public_key *key,
 		int pos)
 {
-	return key->exponent & (1ULL << pos);
+	return !!(key->exponent & (1ULL << pos));
 }
 
 /**
- * pow_mod() - in-place public exponentiation
+ * rsa_pow_mod_generic() - in-place public exponentiation with 32-bit limbs
  *
  * @key:	RSA key
  * @inout:	Big-endian word array containing value and result
  */
-static int pow_mod(const struct rsa_public_key *key, void *__inout)
+int rsa_pow_mod_generic(const struct rsa_public_key *key, void *__inout)
 {
 	uint32_t *inout = __inout;
 	uint32_t *result, *ptr;
@@ -242,6 +242,258 @@ static int pow_mod(const struct rsa_public_key *key, void *__inout)
 	return 0;
 }
 
+#if defined(CONFIG_64BIT) && defined(__SIZEOF_INT128__)
+
+typedef unsigned __int128 u128;
+
+#define RSA_MAX_LIMBS64		(RSA_MAX_KEY_BITS / 64)
+#define RSA_MAX_WINDOW		4
+
+/**
+ * struct rsa_mont64 - RSA key converted to 64-bit limbs
+ *
+ * @len:	Number of 64-bit limbs
+ * @n0inv:	-1 / modulus[0] mod 2^64
+ * @modulus:	Modulus as little endian 64-bit limb array
+ */
+struct rsa_mont64 {
+	uint len;
+	uint64_t n0inv;
+	uint64_t modulus[RSA_MAX_LIMBS64];
+};
+
+static void subtract_modulus64(const struct rsa_mont64 *m, uint64_t num[])
+{
+	u128 acc = 0;
+	uint i;
+
+	for (i = 0; i < m->len; i++) {
+		acc = (u128)num[i] - m->modulus[i] - (uint64_t)(acc >> 127);
+		num[i] = (uint64_t)acc;
+	}
+}
+
+static int greater_equal_modulus64(const struct rsa_mont64 *m,
+				   const uint64_t num[])
+{
+	int i;
+
+	for (i = (int)m->len - 1; i >= 0; i--) {
+		if (num[i] < m->modulus[i])
+			return 0;
+		if (num[i] > m->modulus[i])
+			return 1;
+	}
+
+	return 1;  /* equal */
+}
+
+/*
+ * Same as montgomery_mul_add_step(), but on 64-bit limbs. The 64x64->128
+ * multiplications compile to a mul/umulh pair on ARMv8.
+ */
+static void montgomery_mul_add_step64(const struct rsa_mont64 *m,
+		uint64_t result[], const uint64_t a, const uint64_t b[])
+{
+	u128 acc_a, acc_b;
+	uint64_t d0;
+	uint i;
+
+	acc_a = (u128)a * b[0] + result[0];
+	d0 = (uint64_t)acc_a * m->n0inv;
+	acc_b = (u128)d0 * m->modulus[0] + (uint64_t)acc_a;
+	for (i = 1; i < m->len; i++) {
+		acc_a = (acc_a >> 64) + (u128)a * b[i] + result[i];
+		acc_b = (acc_b >> 64) + (u128)d0 * m->modulus[i] +
+				(uint64_t)acc_a;
+		result[i - 1] = (uint64_t)acc_b;
+	}
+
+	acc_a = (acc_a >> 64) + (acc_b >> 64);
+
+	result[i - 1] = (uint64_t)acc_a;
+
+	if (acc_a >> 64)
+		subtract_modulus64(m, result);
+}
+
+/* result[] = a[] * b[] / R mod modulus; result must not alias a or b */
+static void montgomery_mul64(const struct rsa_mont64 *m,
+		uint64_t result[], const uint64_t a[], const uint64_t b[])
+{
+	uint i;
+
+	for (i = 0; i < m->len; ++i)
+		result[i] = 0;
+	for (i = 0; i < m->len; ++i)
+		montgomery_mul_add_step64(m, result, a[i], b);
+}
+
+static void rsa_to_limbs64(uint64_t *dst, const uint32_t *src, uint len64)
+{
+	uint i;
+
+	for (i = 0; i < len64; i++)
+		dst[i] = (uint64_t)src[2 * i + 1] << 32 | src[2 * i];
+}
+
+/* -1 / n mod 2^64 by Newton iteration, each step doubles the correct bits */
+static uint64_t rsa_n0inv64(uint64_t n)
+{
+	uint64_t x = n;	/* n * n == 1 mod 8 for odd n */
+	int i;
+
+	for (i = 0; i < 5; i++)
+		x *= 2 - n * x;
+
+	return -x;
+}
+
+static int rsa_window_size(int exponent_bits)
+{
+	if (exponent_bits <= 24)
+		return 1;
+	if (exponent_bits <= 48)
+		return 3;
+	return RSA_MAX_WINDOW;
+}
+
+/**
+ * rsa_pow_mod64() - in-place public exponentiation with 64-bit limbs
+ *
+ * Uses left-to-right sliding-window exponentiation, which saves
+ * multiplications for exponents larger than the usual 65537.
+ *
+ * @key:	RSA key, with an even number of 32-bit words
+ * @inout:	Big-endian word array containing value and result
+ */
+static int rsa_pow_mod64(const struct rsa_public_key *key, void *__inout)
+{
+	uint32_t *inout = __inout;
+	uint32_t *ptr;
+	struct rsa_mont64 *m;
+	uint64_t (*g)[RSA_MAX_LIMBS64];
+	uint64_t val[RSA_MAX_LIMBS64], rr[RSA_MAX_LIMBS64];
+	uint64_t acc[RSA_MAX_LIMBS64], tmp[RSA_MAX_LIMBS64];
+	uint32_t val32[RSA_MAX_KEY_BITS / 32];
+	bool first = true;
+	uint i, w, len;
+	int j, k;
+
+	if (num_public_exponent_bits(key, &k))
+		return -EINVAL;
+
+	if (k < 2) {
+		pr_debug("Public exponent is too short (%d bits, minimum 2)\n",
+			 k);
+		return -EINVAL;
+	}
+
+	if (!is_public_exponent_bit_set(key, 0)) {
+		pr_debug("LSB of RSA public exponent must be set.\n");
+		return -EINVAL;
+	}
+
+	w = rsa_window_size(k);
+
+	m = malloc(sizeof(*m) + (sizeof(*g) << (w - 1)));
+	if (!m)
+		return -ENOMEM;
+	g = (void *)(m + 1);
+
+	len = key->len / 2;
+	m->len = len;
+	rsa_to_limbs64(m->modulus, key->modulus, len);
+	m->n0inv = rsa_n0inv64(m->modulus[0]);
+
+	/* Convert from big endian byte array to little endian limb array. */
+	for (i = 0, ptr = inout + key->len - 1; i < key->len; i++, ptr--)
+		val32[i] = get_unaligned_be32(ptr);
+	rsa_to_limbs64(val, val32, len);
+	rsa_to_limbs64(rr, key->rr, len);
+
+	/* g[i] = val^(2i+1) * R mod n */
+	montgomery_mul64(m, g[0], val, rr);
+	if (w > 1) {
+		montgomery_mul64(m, tmp, g[0], g[0]);
+		for (i = 1; i < 1 << (w - 1); i++)
+			montgomery_mul64(m, g[i], g[i - 1], tmp);
+	}
+
+	/* the bit at e[k-1] is 1 by definition, so the first window is non-empty */
+	j = k - 1;
+	while (j >= 0) {
+		uint bits, wlen, l;
+
+		if (!is_public_exponent_bit_set(key, j)) {
+			montgomery_mul64(m, tmp, acc, acc);
+			memcpy(acc, tmp, len * sizeof(acc[0]));
+			j--;
+			continue;
+		}
+
+		/* longest window of at most w bits ending in a set bit */
+		wlen = min_t(int, w, j + 1);
+		while (!is_public_exponent_bit_set(key, j - wlen + 1))
+			wlen--;
+
+		bits = 0;
+		for (l = 0; l < wlen; l++)
+			bits = bits << 1 | !!is_public_exponent_bit_set(key, j - l);
+
+		if (first) {
+			memcpy(acc, g[bits >> 1], len * sizeof(acc[0]));
+			first = false;
+		} else {
+			for (l = 0; l < wlen; l++) {
+				montgomery_mul64(m, tmp, acc, acc);
+				memcpy(acc, tmp, len * sizeof(acc[0]));
+			}
+			montgomery_mul64(m, tmp, acc, g[bits >> 1]);
+			memcpy(acc, tmp, len * sizeof(acc[0]));
+		}
+
+		j -= wlen;
+	}
+
+	/* leave the Montgomery domain: acc * 1 / R mod n */
+	memset(val, 0, len * sizeof(val[0]));
+	val[0] = 1;
+	montgomery_mul64(m, tmp, acc, val);
+
+	/* Make sure result < mod; result is at most 1x mod too large. */
+	if (greater_equal_modulus64(m, tmp))
+		subtract_modulus64(m, tmp);
+
+	/* Convert to bigendian byte array */
+	for (i = len - 1, ptr = inout; (int)i >= 0; i--) {
+		put_unaligned_be32(tmp[i] >> 32, ptr++);
+		put_unaligned_be32(tmp[i], ptr++);
+	}
+
+	free(m);
+
+	return 0;
+}
+
+int rsa_pow_mod(const struct rsa_public_key *key, void *inout)
+{
+	/* R = 2^(32 * len) must be a power of 2^64 to reuse key->rr */
+	if (key->len & 1 || key->len > RSA_MAX_KEY_BITS / 32)
+		return rsa_pow_mod_generic(key, inout);
+
+	return rsa_pow_mod64(key, inout);
+}
+
+#else
+
+int rsa_pow_mod(const struct rsa_public_key *key, void *inout)
+{
+	return rsa_pow_mod_generic(key, inout);
+}
+
+#endif
+
 /*
  * Hash algorithm OIDs plus ASN.1 DER wrappings [RFC4880 sec 5.2.2].
  */
@@ -334,7 +586,7 @@ int rsa_verify(const struct rsa_public_key *key, const uint8_t *sig,
 
 	memcpy(buf, sig, sig_len);
 
-	ret = pow_mod(key, buf);
+	ret = rsa_pow_mod(key, buf);
 	if (ret)
 		goto out_free_digest;
 
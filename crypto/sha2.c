@@ -362,7 +362,12 @@ struct digest_algo m256 = {
 	.ctx_length	= sizeof(struct sha256_state),
 };
 
-#ifndef __PBL__
+#ifdef __PBL__
+struct digest_algo * __weak pbl_sha256_algo(void)
+{
+	return &m256;
+}
+#else
 static int sha256_digest_register(void)
 {
 	if (!IS_ENABLED(CONFIG_HAVE_DIGEST_SHA256))
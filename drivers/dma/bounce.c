@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Bounce buffers for streaming DMA mappings
+ *
+ * dma_map_single() normally hands the buffer it is given to the device.
+ * That doesn't work if the buffer lies outside of the device's DMA mask
+ * or doesn't fulfill the alignment the device requires. Instead of having
+ * every driver copy such buffers itself or fall back to PIO, they are
+ * transparently replaced by a suitable bounce buffer here. Data is copied
+ * between the buffers when syncing for the CPU or the device.
+ *
+ * Bounce buffers are taken from the malloc area. Released ones are kept in
+ * a small pool for reuse, as drivers usually map buffers of the same size
+ * over and over again.
+ */
+
+#define pr_fmt(fmt) "dma-bounce: " fmt
+
+#include <common.h>
+#include <dma.h>
+#include <linux/list.h>
+#include <linux/sizes.h>
+
+#include "bounce.h"
+
+#define DMA_BOUNCE_POOL_MAX	SZ_1M
+
+struct dma_bounce {
+	struct list_head list;
+	struct device *dev;
+	void *orig;
+	void *buf;
+	dma_addr_t dma;
+	size_t size;	/* size of the mapping */
+	size_t bufsize;	/* allocated size of buf */
+};
+
+static LIST_HEAD(dma_bounce_active);
+static LIST_HEAD(dma_bounce_pool);
+static size_t dma_bounce_pool_size;
+
+static unsigned int dma_bounce_align(struct device *dev)
+{
+	return max_t(unsigned int, DMA_ALIGNMENT, dev ? dev->dma_alignment : 0);
+}
+
+static bool dma_bounce_fits(struct device *dev, void *ptr, size_t size)
+{
+	dma_addr_t addr = cpu_to_dma(dev, ptr);
+	unsigned int align = dev ? dev->dma_alignment : 0;
+
+	if (dev && dev->dma_mask && size && addr + size - 1 > dev->dma_mask)
+		return false;
+
+	if (align && !IS_ALIGNED(addr, align))
+		return false;
+
+	return true;
+}
+
+bool dma_bounce_needed(struct device *dev, void *ptr, size_t size)
+{
+	return !dma_bounce_fits(dev, ptr, size);
+}
+
+static struct dma_bounce *dma_bounce_get(struct device *dev, size_t size)
+{
+	struct dma_bounce *b;
+	size_t bufsize = ALIGN(size, DMA_ALIGNMENT);
+
+	/* reuse pooled buffers which are not excessively large */
+	list_for_each_entry(b, &dma_bounce_pool, list) {
+		if (b->bufsize < bufsize || b->bufsize / 2 > bufsize)
+			continue;
+		if (!dma_bounce_fits(dev, b->buf, b->bufsize))
+			continue;
+
+		list_del(&b->list);
+		dma_bounce_pool_size -= b->bufsize;
+		return b;
+	}
+
+	b = xzalloc(sizeof(*b));
+	b->bufsize = bufsize;
+	b->buf = memalign(dma_bounce_align(dev), bufsize);
+	if (!b->buf || !dma_bounce_fits(dev, b->buf, bufsize)) {
+		dev_warn(dev, "no memory for %zu bytes DMA bounce buffer\n", size);
+		free(b->buf);
+		free(b);
+		return NULL;
+	}
+
+	return b;
+}
+
+static void dma_bounce_put(struct dma_bounce *b)
+{
+	struct dma_bounce *old;
+
+	list_add(&b->list, &dma_bounce_pool);
+	dma_bounce_pool_size += b->bufsize;
+
+	/* trim the pool, releasing the least recently used buffers first */
+	while (dma_bounce_pool_size > DMA_BOUNCE_POOL_MAX) {
+		old = list_last_entry(&dma_bounce_pool, struct dma_bounce, list);
+		list_del(&old->list);
+		dma_bounce_pool_size -= old->bufsize;
+		free(old->buf);
+		free(old);
+	}
+}
+
+void *dma_bounce_map(struct device *dev, void *ptr, size_t size,
+		     enum dma_data_direction dir)
+{
+	struct dma_bounce *b;
+
+	b = dma_bounce_get(dev, size);
+	if (!b)
+		return NULL;
+
+	b->dev = dev;
+	b->orig = ptr;
+	b->size = size;
+	b->dma = cpu_to_dma(dev, b->buf);
+
+	if (dir != DMA_FROM_DEVICE)
+		memcpy(b->buf, ptr, size);
+
+	list_add(&b->list, &dma_bounce_active);
+
+	dev_dbg(dev, "bouncing %zu bytes at %p via %p\n", size, ptr, b->buf);
+
+	return b->buf;
+}
+
+static struct dma_bounce *dma_bounce_find(struct device *dev, dma_addr_t addr)
+{
+	struct dma_bounce *b;
+
+	list_for_each_entry(b, &dma_bounce_active, list) {
+		if (b->dev == dev && addr - b->dma < b->size)
+			return b;
+	}
+
+	return NULL;
+}
+
+void dma_bounce_unmap(struct device *dev, dma_addr_t addr)
+{
+	struct dma_bounce *b;
+
+	if (list_empty(&dma_bounce_active))
+		return;
+
+	b = dma_bounce_find(dev, addr);
+	if (!b)
+		return;
+
+	list_del(&b->list);
+	dma_bounce_put(b);
+}
+
+void dma_bounce_sync_for_cpu(struct device *dev, dma_addr_t addr,
+			     size_t size, enum dma_data_direction dir)
+{
+	struct dma_bounce *b;
+	size_t offset;
+
+	if (dir == DMA_TO_DEVICE || list_empty(&dma_bounce_active))
+		return;
+
+	b = dma_bounce_find(dev, addr);
+	if (!b)
+		return;
+
+	offset = addr - b->dma;
+	memcpy(b->orig + offset, b->buf + offset, min(size, b->size - offset));
+}
+
+void dma_bounce_sync_for_device(struct device *dev, dma_addr_t addr,
+				size_t size, enum dma_data_direction dir)
+{
+	struct dma_bounce *b;
+	size_t offset;
+
+	if (dir == DMA_FROM_DEVICE || list_empty(&dma_bounce_active))
+		return;
+
+	b = dma_bounce_find(dev, addr);
+	if (!b)
+		return;
+
+	offset = addr - b->dma;
+	memcpy(b->buf + offset, b->orig + offset, min(size, b->size - offset));
+}
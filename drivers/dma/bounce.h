@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef _DMA_BOUNCE_H
+#define _DMA_BOUNCE_H
+
+#include <linux/types.h>
+#include <dma-dir.h>
+
+struct device;
+
+#ifdef CONFIG_DMA_BOUNCE
+bool dma_bounce_needed(struct device *dev, void *ptr, size_t size);
+void *dma_bounce_map(struct device *dev, void *ptr, size_t size,
+		     enum dma_data_direction dir);
+void dma_bounce_unmap(struct device *dev, dma_addr_t addr);
+void dma_bounce_sync_for_cpu(struct device *dev, dma_addr_t addr,
+			     size_t size, enum dma_data_direction dir);
+void dma_bounce_sync_for_device(struct device *dev, dma_addr_t addr,
+				size_t size, enum dma_data_direction dir);
+#else
+static inline bool dma_bounce_needed(struct device *dev, void *ptr, size_t size)
+{
+	return false;
+}
+
+static inline void *dma_bounce_map(struct device *dev, void *ptr, size_t size,
+				   enum dma_data_direction dir)
+{
+	return NULL;
+}
+
+static inline void dma_bounce_unmap(struct device *dev, dma_addr_t addr)
+{
+}
+
+static inline void dma_bounce_sync_for_cpu(struct device *dev, dma_addr_t addr,
+					   size_t size, enum dma_data_direction dir)
+{
+}
+
+static inline void dma_bounce_sync_for_device(struct device *dev, dma_addr_t addr,
+					      size_t size, enum dma_data_direction dir)
+{
+}
+#endif
+
+#endif /* _DMA_BOUNCE_H */
@@ -202,6 +202,30 @@ int dma_get_cfg(struct dma *dma, u32 cfg_id, void **cfg_data)
 	return ops->get_cfg(dma, cfg_id, cfg_data);
 }
 
+/**
+ * dma_memcpy - copy memory using the first DMA device capable of it
+ * @dst: DMA address of the destination
+ * @src: DMA address of the source
+ * @len: number of bytes to copy
+ *
+ * The caller is responsible for mapping the buffers. Returns -ENODEV when no
+ * registered DMA device can do memory to memory transfers.
+ */
+int dma_memcpy(dma_addr_t dst, dma_addr_t src, size_t len)
+{
+	struct dma_device *dmad;
+
+	list_for_each_entry(dmad, &dma_devices, list) {
+		if (!dmad->ops->transfer)
+			continue;
+
+		return dmad->ops->transfer(dmad->dev, DMA_MEM_TO_MEM,
+					   dst, src, len);
+	}
+
+	return -ENODEV;
+}
+
 int dma_device_register(struct dma_device *dmad)
 {
 	list_add_tail(&dmad->list, &dma_devices);
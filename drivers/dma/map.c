@@ -1,7 +1,73 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 #include <dma.h>
 #include <driver.h>
+#include <clock.h>
+#include <linux/sizes.h>
 #include "debug.h"
+#include "bounce.h"
+
+#ifdef CONFIG_DMA_SYNC_ALL_THRESHOLD
+#define DMA_SYNC_ALL_THRESHOLD	((size_t)CONFIG_DMA_SYNC_ALL_THRESHOLD * SZ_1K)
+#else
+#define DMA_SYNC_ALL_THRESHOLD	0
+#endif
+
+#ifdef CONFIG_DMA_SYNC_STATS
+static struct dma_sync_stats dma_sync_stats;
+
+void dma_sync_stats_get(struct dma_sync_stats *stats)
+{
+	*stats = dma_sync_stats;
+}
+
+void dma_sync_stats_reset(void)
+{
+	memset(&dma_sync_stats, 0, sizeof(dma_sync_stats));
+}
+
+#define dma_sync_stats_inc(field)	(dma_sync_stats.field++)
+
+static inline u64 dma_sync_stats_start(void)
+{
+	return get_time_ns();
+}
+
+static inline void dma_sync_stats_account(u64 start, size_t size)
+{
+	dma_sync_stats.ops++;
+	dma_sync_stats.bytes += size;
+	dma_sync_stats.time_ns += get_time_ns() - start;
+}
+#else
+#define dma_sync_stats_inc(field)	do { } while (0)
+
+static inline u64 dma_sync_stats_start(void)
+{
+	return 0;
+}
+
+static inline void dma_sync_stats_account(u64 start, size_t size)
+{
+}
+#endif
+
+static void __dma_sync_for_cpu(void *ptr, size_t size,
+			       enum dma_data_direction dir)
+{
+	u64 start = dma_sync_stats_start();
+
+	arch_sync_dma_for_cpu(ptr, size, dir);
+	dma_sync_stats_account(start, size);
+}
+
+static void __dma_sync_for_device(void *ptr, size_t size,
+				  enum dma_data_direction dir)
+{
+	u64 start = dma_sync_stats_start();
+
+	arch_sync_dma_for_device(ptr, size, dir);
+	dma_sync_stats_account(start, size);
+}
 
 void *dma_alloc(size_t size)
 {
@@ -27,9 +93,12 @@ void dma_sync_single_for_cpu(struct device *dev, dma_addr_t address,
 	void *ptr = dma_to_cpu(dev, address);
 
 	debug_dma_sync_single_for_cpu(dev, address, size, dir);
+	dma_sync_stats_inc(requests);
 
 	if (!dev_is_dma_coherent(dev))
-		arch_sync_dma_for_cpu(ptr, size, dir);
+		__dma_sync_for_cpu(ptr, size, dir);
+
+	dma_bounce_sync_for_cpu(dev, address, size, dir);
 }
 EXPORT_SYMBOL(dma_sync_single_for_cpu);
 
@@ -39,21 +108,47 @@ void dma_sync_single_for_device(struct device *dev, dma_addr_t address,
 	void *ptr = dma_to_cpu(dev, address);
 
 	debug_dma_sync_single_for_device(dev, address, size, dir);
+	dma_sync_stats_inc(requests);
+
+	dma_bounce_sync_for_device(dev, address, size, dir);
 
 	if (!dev_is_dma_coherent(dev))
-		arch_sync_dma_for_device(ptr, size, dir);
+		__dma_sync_for_device(ptr, size, dir);
 }
 EXPORT_SYMBOL(dma_sync_single_for_device);
 
+/* map without cache maintenance, which is left to the caller */
+static dma_addr_t __dma_map_single(struct device *dev, void *ptr,
+				   size_t size, enum dma_data_direction dir)
+{
+	dma_addr_t dma_addr;
+
+	if (dma_bounce_needed(dev, ptr, size)) {
+		ptr = dma_bounce_map(dev, ptr, size, dir);
+		if (!ptr)
+			return DMA_ERROR_CODE;
+	}
+
+	dma_addr = cpu_to_dma(dev, ptr);
+
+	debug_dma_map(dev, ptr, size, dir, dma_addr);
+
+	return dma_addr;
+}
+
 dma_addr_t dma_map_single(struct device *dev, void *ptr,
 					size_t size, enum dma_data_direction dir)
 {
-	dma_addr_t dma_addr = cpu_to_dma(dev, ptr);
+	dma_addr_t dma_addr;
 
-	debug_dma_map(dev, ptr, size, dir, dma_addr);
+	dma_addr = __dma_map_single(dev, ptr, size, dir);
+	if (dma_addr == DMA_ERROR_CODE)
+		return dma_addr;
+
+	dma_sync_stats_inc(requests);
 
 	if (!dev_is_dma_coherent(dev))
-		arch_sync_dma_for_device(ptr, size, dir);
+		__dma_sync_for_device(dma_to_cpu(dev, dma_addr), size, dir);
 
 	return dma_addr;
 }
@@ -64,7 +159,326 @@ void dma_unmap_single(struct device *dev, dma_addr_t dma_addr,
 {
 	if (!dev_is_dma_coherent(dev))
 		dma_sync_single_for_cpu(dev, dma_addr, size, dir);
+	else
+		dma_bounce_sync_for_cpu(dev, dma_addr, size, dir);
 
 	debug_dma_unmap(dev, dma_addr, size, dir);
+
+	dma_bounce_unmap(dev, dma_addr);
 }
 EXPORT_SYMBOL(dma_unmap_single);
+
+/**
+ * dma_sync_batch_init - start collecting sync operations
+ * @batch: the batch
+ * @dev: device doing the DMA
+ * @target: whether ownership goes to the CPU or to the device
+ *
+ * Drivers handling many small buffers at once, like descriptor rings and
+ * packet buffers, can add all of them with dma_sync_batch_add() and issue
+ * the cache maintenance with a single dma_sync_batch_flush(). Adjacent and
+ * overlapping ranges are merged into one maintenance loop then.
+ */
+void dma_sync_batch_init(struct dma_sync_batch *batch, struct device *dev,
+			 enum dma_sync_target target)
+{
+	batch->dev = dev;
+	batch->target = target;
+	batch->nr = 0;
+}
+EXPORT_SYMBOL(dma_sync_batch_init);
+
+/**
+ * dma_sync_batch_add - add a range to a batch
+ * @batch: the batch
+ * @addr: DMA address as returned by dma_map_single()
+ * @size: size of the range
+ * @dir: direction of the transfer
+ *
+ * Equivalent to dma_sync_single_for_cpu() or dma_sync_single_for_device()
+ * except that the cache maintenance is deferred until the batch is flushed.
+ * A full batch is flushed implicitly.
+ */
+/* queue the cache maintenance for a range, nothing else */
+static void __dma_sync_batch_add(struct dma_sync_batch *batch, dma_addr_t addr,
+				 size_t size, enum dma_data_direction dir)
+{
+	struct dma_sync_range *r;
+
+	if (batch->nr == ARRAY_SIZE(batch->range))
+		dma_sync_batch_flush(batch);
+
+	dma_sync_stats_inc(requests);
+
+	r = &batch->range[batch->nr++];
+	r->addr = addr;
+	r->size = size;
+	r->dir = dir;
+}
+
+void dma_sync_batch_add(struct dma_sync_batch *batch, dma_addr_t addr,
+			size_t size, enum dma_data_direction dir)
+{
+	struct device *dev = batch->dev;
+
+	if (batch->target == DMA_SYNC_FOR_DEVICE) {
+		debug_dma_sync_single_for_device(dev, addr, size, dir);
+		dma_bounce_sync_for_device(dev, addr, size, dir);
+	} else {
+		debug_dma_sync_single_for_cpu(dev, addr, size, dir);
+	}
+
+	__dma_sync_batch_add(batch, addr, size, dir);
+}
+EXPORT_SYMBOL(dma_sync_batch_add);
+
+static bool dma_sync_range_before(const struct dma_sync_range *a,
+				  const struct dma_sync_range *b)
+{
+	if (a->dir != b->dir)
+		return a->dir < b->dir;
+
+	return a->addr < b->addr;
+}
+
+/* sort by direction and address, batches are small */
+static void dma_sync_batch_sort(struct dma_sync_range *r, unsigned int n)
+{
+	unsigned int i, j;
+
+	for (i = 1; i < n; i++) {
+		struct dma_sync_range tmp = r[i];
+
+		for (j = i; j > 0 && dma_sync_range_before(&tmp, &r[j - 1]); j--)
+			r[j] = r[j - 1];
+
+		r[j] = tmp;
+	}
+}
+
+static void dma_sync_batch_range(enum dma_sync_target target, void *ptr,
+				 size_t size, enum dma_data_direction dir)
+{
+	if (target == DMA_SYNC_FOR_DEVICE)
+		__dma_sync_for_device(ptr, size, dir);
+	else if (dir != DMA_TO_DEVICE)
+		__dma_sync_for_cpu(ptr, size, dir);
+}
+
+static void dma_sync_batch_maintain(struct dma_sync_batch *batch)
+{
+	struct device *dev = batch->dev;
+	struct dma_sync_range *r = batch->range;
+	unsigned int i, j, n = batch->nr;
+	size_t total = 0;
+
+	dma_sync_batch_sort(r, n);
+
+	for (i = 0; i < n; i++)
+		total += r[i].size;
+
+	/*
+	 * Cleaning and invalidating the whole data cache is only done when
+	 * handing buffers to the device. Before that the CPU may still have
+	 * written to them, so writing back dirty lines is correct for all
+	 * directions. Invalidating for the CPU must stay exact.
+	 */
+	if (DMA_SYNC_ALL_THRESHOLD && batch->target == DMA_SYNC_FOR_DEVICE &&
+	    total >= DMA_SYNC_ALL_THRESHOLD) {
+		u64 start = dma_sync_stats_start();
+
+		arch_sync_dma_all_for_device();
+		dma_sync_stats_account(start, total);
+		dma_sync_stats_inc(full_flushes);
+		return;
+	}
+
+	for (i = 0; i < n; i = j) {
+		unsigned long start = (unsigned long)dma_to_cpu(dev, r[i].addr);
+		unsigned long end = start + r[i].size;
+
+		for (j = i + 1; j < n && r[j].dir == r[i].dir; j++) {
+			unsigned long s = (unsigned long)dma_to_cpu(dev, r[j].addr);
+
+			if (s > end)
+				break;
+
+			end = max(end, s + r[j].size);
+			dma_sync_stats_inc(merged);
+		}
+
+		dma_sync_batch_range(batch->target, (void *)start,
+				     end - start, r[i].dir);
+	}
+}
+
+/**
+ * dma_sync_batch_flush - issue the cache maintenance for a batch
+ * @batch: the batch
+ *
+ * The batch is empty afterwards and can be reused for the same device and
+ * target.
+ */
+void dma_sync_batch_flush(struct dma_sync_batch *batch)
+{
+	unsigned int i;
+
+	if (!batch->nr)
+		return;
+
+	if (!dev_is_dma_coherent(batch->dev))
+		dma_sync_batch_maintain(batch);
+
+	if (batch->target == DMA_SYNC_FOR_CPU) {
+		for (i = 0; i < batch->nr; i++)
+			dma_bounce_sync_for_cpu(batch->dev, batch->range[i].addr,
+						batch->range[i].size,
+						batch->range[i].dir);
+	}
+
+	batch->nr = 0;
+}
+EXPORT_SYMBOL(dma_sync_batch_flush);
+
+/*
+ * Unmap without syncing for the CPU. Used to clean up after a failed
+ * mapping: the device never saw the buffers, so there's nothing to
+ * invalidate and bounce buffers must not be copied back over them.
+ */
+static void __dma_unmap_sg(struct device *dev, struct scatterlist *sgl,
+			   int nents, enum dma_data_direction dir)
+{
+	struct scatterlist *sg;
+	int i;
+
+	for_each_sg(sgl, sg, nents, i) {
+		debug_dma_unmap(dev, sg_dma_address(sg), sg_dma_len(sg), dir);
+		dma_bounce_unmap(dev, sg_dma_address(sg));
+	}
+}
+
+/**
+ * dma_map_sg - map a scatterlist for streaming DMA
+ * @dev: device doing the DMA
+ * @sgl: the scatterlist
+ * @nents: number of entries to map
+ * @dir: direction of the transfer
+ *
+ * Maps every entry and stores the result in sg_dma_address(). Entries
+ * outside of the DMA mask or not fulfilling the alignment of @dev are
+ * bounced if CONFIG_DMA_BOUNCE is enabled. The cache maintenance for all
+ * entries is batched.
+ *
+ * Return: the number of mapped entries or 0 on failure, in which case
+ * nothing remains mapped.
+ */
+int dma_map_sg(struct device *dev, struct scatterlist *sgl, int nents,
+	       enum dma_data_direction dir)
+{
+	struct dma_sync_batch batch;
+	struct scatterlist *sg;
+	int i;
+
+	dma_sync_batch_init(&batch, dev, DMA_SYNC_FOR_DEVICE);
+
+	for_each_sg(sgl, sg, nents, i) {
+		sg_dma_address(sg) = __dma_map_single(dev, sg->address,
+						      sg->length, dir);
+		if (dma_mapping_error(dev, sg_dma_address(sg))) {
+			/* an address beyond the mask is mapped nevertheless */
+			if (sg_dma_address(sg) != DMA_ERROR_CODE)
+				i++;
+			__dma_unmap_sg(dev, sgl, i, dir);
+			return 0;
+		}
+
+		/* dma_bounce_map() already filled the bounce buffer */
+		__dma_sync_batch_add(&batch, sg_dma_address(sg), sg->length, dir);
+	}
+
+	dma_sync_batch_flush(&batch);
+
+	return nents;
+}
+EXPORT_SYMBOL(dma_map_sg);
+
+void dma_unmap_sg(struct device *dev, struct scatterlist *sgl, int nents,
+		  enum dma_data_direction dir)
+{
+	dma_sync_sg_for_cpu(dev, sgl, nents, dir);
+	__dma_unmap_sg(dev, sgl, nents, dir);
+}
+EXPORT_SYMBOL(dma_unmap_sg);
+
+void dma_sync_sg_for_cpu(struct device *dev, struct scatterlist *sgl,
+			 int nents, enum dma_data_direction dir)
+{
+	struct dma_sync_batch batch;
+	struct scatterlist *sg;
+	int i;
+
+	dma_sync_batch_init(&batch, dev, DMA_SYNC_FOR_CPU);
+
+	for_each_sg(sgl, sg, nents, i)
+		dma_sync_batch_add(&batch, sg_dma_address(sg), sg_dma_len(sg), dir);
+
+	dma_sync_batch_flush(&batch);
+}
+EXPORT_SYMBOL(dma_sync_sg_for_cpu);
+
+void dma_sync_sg_for_device(struct device *dev, struct scatterlist *sgl,
+			    int nents, enum dma_data_direction dir)
+{
+	struct dma_sync_batch batch;
+	struct scatterlist *sg;
+	int i;
+
+	dma_sync_batch_init(&batch, dev, DMA_SYNC_FOR_DEVICE);
+
+	for_each_sg(sgl, sg, nents, i)
+		dma_sync_batch_add(&batch, sg_dma_address(sg), sg_dma_len(sg), dir);
+
+	dma_sync_batch_flush(&batch);
+}
+EXPORT_SYMBOL(dma_sync_sg_for_device);
+
+/**
+ * dma_map_buf_sg - split a buffer into segments and map them for DMA
+ * @dev: device doing the DMA
+ * @sgt: sg table to fill
+ * @buf: the buffer
+ * @len: length of the buffer
+ * @dir: direction of the transfer
+ *
+ * Builds a table of segments no longer than dma_get_max_seg_size(@dev) and
+ * maps them, so that drivers for controllers with a limited descriptor
+ * length can take arbitrarily large buffers. Release with
+ * dma_unmap_buf_sg().
+ *
+ * Return: 0 on success, negative error code otherwise
+ */
+int dma_map_buf_sg(struct device *dev, struct sg_table *sgt, void *buf,
+		   size_t len, enum dma_data_direction dir)
+{
+	int ret;
+
+	ret = sg_alloc_table_from_buf(sgt, buf, len, dma_get_max_seg_size(dev));
+	if (ret)
+		return ret;
+
+	if (!dma_map_sg(dev, sgt->sgl, sgt->orig_nents, dir)) {
+		sg_free_table(sgt);
+		return -EIO;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(dma_map_buf_sg);
+
+void dma_unmap_buf_sg(struct device *dev, struct sg_table *sgt,
+		      enum dma_data_direction dir)
+{
+	dma_unmap_sg(dev, sgt->sgl, sgt->orig_nents, dir);
+	sg_free_table(sgt);
+}
+EXPORT_SYMBOL(dma_unmap_buf_sg);
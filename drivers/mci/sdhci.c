@@ -639,32 +639,27 @@ static int sdhci_adma_write_desc(struct sdhci *host, void **desc,
 }
 
 /*
- * Build the ADMA2 descriptor table for a single contiguous DMA buffer.
- * Each entry of the table covers up to SDHCI_ADMA2_MAX_LEN bytes; longer
- * transfers are split across multiple descriptors.
+ * Build the ADMA2 descriptor table for the mapped segments in @sgt, one
+ * entry per segment. sdhci_setup_adma() limits the segments to
+ * SDHCI_ADMA2_MAX_LEN bytes.
  */
-static int sdhci_adma_build_table(struct sdhci *host, dma_addr_t addr,
-				  unsigned int len)
+static int sdhci_adma_build_table(struct sdhci *host, struct sg_table *sgt)
 {
 	void *desc = host->adma_table;
-	int ret;
-
-	while (len) {
-		unsigned int chunk = min_t(unsigned int, len,
-					   SDHCI_ADMA2_MAX_LEN);
+	struct scatterlist *sg;
+	int i, ret;
 
+	for_each_sgtable_sg(sgt, sg, i) {
 		/*
 		 * The length field is 16-bit; a length of 0 encodes
 		 * SDHCI_ADMA2_MAX_LEN bytes per the SD Host Controller
 		 * specification.
 		 */
-		ret = sdhci_adma_write_desc(host, &desc, addr, chunk & 0xffff,
+		ret = sdhci_adma_write_desc(host, &desc, sg_dma_address(sg),
+					    sg_dma_len(sg) & 0xffff,
 					    ADMA2_TRAN_VALID);
 		if (ret)
 			return ret;
-
-		addr += chunk;
-		len -= chunk;
 	}
 
 	/* Append a terminating descriptor (nop, end, valid). */
@@ -677,6 +672,8 @@ void sdhci_setup_data_dma(struct sdhci *sdhci, struct mci_data *data,
 			  dma_addr_t *dma)
 {
 	struct device *dev = sdhci_dev(sdhci);
+	enum dma_data_direction dir;
+	void *buf;
 	int nbytes;
 	int ret;
 
@@ -693,52 +690,64 @@ void sdhci_setup_data_dma(struct sdhci *sdhci, struct mci_data *data,
 
 	nbytes = data->blocks * data->blocksize;
 
-	if (data->flags & MMC_DATA_READ)
-		*dma = dma_map_single(dev, data->dest, nbytes,
-				      DMA_FROM_DEVICE);
-	else
-		*dma = dma_map_single(dev, (void *)data->src, nbytes,
-				      DMA_TO_DEVICE);
-
-	if (dma_mapping_error(dev, *dma)) {
-		*dma = SDHCI_NO_DMA;
-		return;
+	if (data->flags & MMC_DATA_READ) {
+		buf = data->dest;
+		dir = DMA_FROM_DEVICE;
+	} else {
+		buf = (void *)data->src;
+		dir = DMA_TO_DEVICE;
 	}
 
-	sdhci_config_dma(sdhci);
+	if (IN_PROPER && (sdhci->flags & SDHCI_USE_ADMA)) {
+		ret = dma_map_buf_sg(dev, &sdhci->adma_sgt, buf, nbytes, dir);
+		if (ret) {
+			*dma = SDHCI_NO_DMA;
+			return;
+		}
 
-	if (sdhci->flags & SDHCI_USE_ADMA) {
-		ret = sdhci_adma_build_table(sdhci, *dma, nbytes);
+		sdhci_config_dma(sdhci);
+
+		ret = sdhci_adma_build_table(sdhci, &sdhci->adma_sgt);
 		if (ret) {
 			dev_err(dev, "ADMA table build failed: %pe\n",
 				ERR_PTR(ret));
-			dma_unmap_single(dev, *dma, nbytes,
-					 (data->flags & MMC_DATA_READ) ?
-					 DMA_FROM_DEVICE : DMA_TO_DEVICE);
+			dma_unmap_buf_sg(dev, &sdhci->adma_sgt, dir);
 			*dma = SDHCI_NO_DMA;
 			return;
 		}
+
 		sdhci_set_adma_addr(sdhci, sdhci->adma_addr);
-	} else {
-		sdhci_set_sdma_addr(sdhci, *dma);
+		*dma = sg_dma_address(sdhci->adma_sgt.sgl);
+		return;
 	}
+
+	*dma = dma_map_single(dev, buf, nbytes, dir);
+	if (dma_mapping_error(dev, *dma)) {
+		*dma = SDHCI_NO_DMA;
+		return;
+	}
+
+	sdhci_config_dma(sdhci);
+	sdhci_set_sdma_addr(sdhci, *dma);
 }
 
 void sdhci_teardown_data(struct sdhci *sdhci,
 			 struct mci_data *data, dma_addr_t dma)
 {
 	struct device *dev = sdhci_dev(sdhci);
+	enum dma_data_direction dir;
 	unsigned nbytes;
 
 	if (IN_PBL || !data || dma_mapping_error(dev, dma))
 		return;
 
 	nbytes = data->blocks * data->blocksize;
+	dir = (data->flags & MMC_DATA_READ) ? DMA_FROM_DEVICE : DMA_TO_DEVICE;
 
-	if (data->flags & MMC_DATA_READ)
-		dma_unmap_single(dev, dma, nbytes, DMA_FROM_DEVICE);
+	if (sdhci->flags & SDHCI_USE_ADMA)
+		dma_unmap_buf_sg(dev, &sdhci->adma_sgt, dir);
 	else
-		dma_unmap_single(dev, dma, nbytes, DMA_TO_DEVICE);
+		dma_unmap_single(dev, dma, nbytes, dir);
 }
 
 int sdhci_transfer_data_dma(struct sdhci *sdhci, struct mci_cmd *cmd,
@@ -1340,6 +1349,13 @@ int sdhci_setup_adma(struct sdhci *host)
 	host->adma_addr = dma;
 	host->flags |= SDHCI_USE_ADMA;
 
+	/*
+	 * Let the DMA API split transfers into one segment per descriptor
+	 * and bounce buffers the ADMA engine can't address.
+	 */
+	dma_set_max_seg_size(dev, SDHCI_ADMA2_MAX_LEN);
+	dma_set_alignment(dev, SDHCI_ADMA2_ALIGN);
+
 	/*
 	 * One descriptor handles up to SDHCI_ADMA2_MAX_LEN bytes; the last
 	 * one is reserved for the terminating entry.
@@ -260,6 +260,9 @@ struct sdhci_adma2_64_desc {
  */
 #define SDHCI_ADMA2_DESC_ALIGN	8
 
+/* ADMA2 data buffers must be 32-bit aligned */
+#define SDHCI_ADMA2_ALIGN	4
+
 /*
  * Maximum length per ADMA2 descriptor. The length field in the descriptor
  * is 16-bit wide; a value of 0 encodes 65536 bytes per the SD spec, so the
@@ -333,6 +336,7 @@ struct sdhci {
 	unsigned int	adma_table_sz;	/* size of the descriptor table in bytes */
 	unsigned int	desc_sz;	/* per-descriptor size in bytes */
 	unsigned int	adma_table_cnt;	/* number of descriptor entries */
+	struct sg_table	adma_sgt;	/* segments of the current transfer */
 
 	/* Delay (ms) between tuning commands */
 	int			tuning_delay;
@@ -165,6 +165,7 @@ int nand_markbad_bbt(struct nand_chip *chip, loff_t offs);
 int nand_markgood_bbt(struct nand_chip *chip, loff_t offs);
 int nand_isreserved_bbt(struct nand_chip *chip, loff_t offs);
 int nand_isbad_bbt(struct nand_chip *chip, loff_t offs, int allowbbt);
+int nand_bbt_regenerate(struct nand_chip *chip);
 
 /* Legacy */
 void nand_legacy_set_defaults(struct nand_chip *chip);
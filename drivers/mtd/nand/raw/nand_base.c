@@ -1220,10 +1220,13 @@ static int nand_lp_exec_cont_read_page_op(struct nand_chip *chip, unsigned int p
 		return 0;
 	}
 
-	if (page == chip->cont_read.first_page)
+	if (page == chip->cont_read.first_page) {
 		ret = nand_exec_op(chip, &start_op);
-	else
+	} else {
 		ret = nand_exec_op(chip, &cont_op);
+		/* tR of this page overlapped with the previous data out */
+		nand_to_mtd(chip)->read_stats.overlapped++;
+	}
 	if (ret)
 		return ret;
 
@@ -3477,6 +3480,114 @@ static void nand_wait_readrdy(struct nand_chip *chip)
 	WARN_ON(nand_wait_rdy_op(chip, NAND_COMMON_TIMING_MS(conf, tR_max), 0));
 }
 
+/*
+ * Read cache: a few ECC corrected pages kept around to serve short re-reads,
+ * e.g. of UBI headers and UBIFS index nodes, without accessing the chip.
+ */
+static int nand_readcache_init(struct nand_chip *chip)
+{
+	struct mtd_info *mtd = nand_to_mtd(chip);
+	unsigned int i, num = CONFIG_NAND_READ_CACHE_PAGES;
+
+	if (!num)
+		return 0;
+
+	chip->readcache.entries = kcalloc(num, sizeof(*chip->readcache.entries),
+					  GFP_KERNEL);
+	if (!chip->readcache.entries)
+		return -ENOMEM;
+
+	for (i = 0; i < num; i++) {
+		struct nand_readcache_entry *entry = &chip->readcache.entries[i];
+
+		entry->page = -1;
+		entry->buf = kmalloc(mtd->writesize, GFP_KERNEL);
+		if (!entry->buf)
+			break;
+	}
+
+	/* a smaller cache is fine if memory is tight */
+	chip->readcache.num = i;
+
+	return 0;
+}
+
+static void nand_readcache_free(struct nand_chip *chip)
+{
+	unsigned int i;
+
+	for (i = 0; i < chip->readcache.num; i++)
+		kfree(chip->readcache.entries[i].buf);
+
+	kfree(chip->readcache.entries);
+	chip->readcache.entries = NULL;
+	chip->readcache.num = 0;
+}
+
+static struct nand_readcache_entry *nand_readcache_find(struct nand_chip *chip,
+							int page)
+{
+	unsigned int i;
+
+	for (i = 0; i < chip->readcache.num; i++) {
+		struct nand_readcache_entry *entry = &chip->readcache.entries[i];
+
+		if (entry->page == page) {
+			entry->used = ++chip->readcache.clock;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void nand_readcache_add(struct nand_chip *chip, int page,
+			       const u8 *buf, unsigned int bitflips)
+{
+	struct mtd_info *mtd = nand_to_mtd(chip);
+	struct nand_readcache_entry *entry = NULL;
+	unsigned int i;
+
+	for (i = 0; i < chip->readcache.num; i++) {
+		struct nand_readcache_entry *e = &chip->readcache.entries[i];
+
+		if (e->page == page) {
+			entry = e;
+			break;
+		}
+
+		/* least recently used, unused entries first */
+		if (!entry || e->page < 0 ||
+		    (entry->page >= 0 && e->used < entry->used))
+			entry = e;
+	}
+
+	if (!entry)
+		return;
+
+	memcpy(entry->buf, buf, mtd->writesize);
+	entry->page = page;
+	entry->bitflips = bitflips;
+	entry->used = ++chip->readcache.clock;
+}
+
+/* Drop cached copies of pages @first to @last, which are about to change */
+static void nand_readcache_invalidate(struct nand_chip *chip, int first,
+				      int last)
+{
+	unsigned int i;
+
+	if (first <= chip->pagecache.page && chip->pagecache.page <= last)
+		chip->pagecache.page = -1;
+
+	for (i = 0; i < chip->readcache.num; i++) {
+		struct nand_readcache_entry *entry = &chip->readcache.entries[i];
+
+		if (first <= entry->page && entry->page <= last)
+			entry->page = -1;
+	}
+}
+
 /**
  * nand_do_read_ops - [INTERN] Read data with ECC
  * @chip: NAND chip object
@@ -3500,6 +3611,8 @@ static int nand_do_read_ops(struct nand_chip *chip, loff_t from,
 	unsigned int max_bitflips = 0;
 	int retry_mode = 0;
 	bool ecc_fail = false;
+	bool use_readcache;
+	struct nand_readcache_entry *cached;
 
 	chipnr = (int)(from >> chip->chip_shift);
 	nand_select_target(chip, chipnr);
@@ -3516,6 +3629,14 @@ static int nand_do_read_ops(struct nand_chip *chip, loff_t from,
 	if (likely(ops->mode != MTD_OPS_RAW))
 		rawnand_enable_cont_reads(chip, page, readlen, col);
 
+	/*
+	 * Only short reads go through the read cache, long sequential reads
+	 * would just flush it.
+	 */
+	use_readcache = chip->readcache.num && !oob &&
+			ops->mode != MTD_OPS_RAW && !chip->cont_read.ongoing &&
+			readlen < 2 * mtd->writesize;
+
 	while (1) {
 		struct mtd_ecc_stats ecc_stats = mtd->ecc_stats;
 
@@ -3530,8 +3651,18 @@ static int nand_do_read_ops(struct nand_chip *chip, loff_t from,
 		else
 			use_bounce_buf = 0;
 
-		/* Is the current page in the buffer? */
-		if (realpage != chip->pagecache.page || oob) {
+		cached = use_readcache ? nand_readcache_find(chip, realpage) : NULL;
+
+		if (cached) {
+			memcpy(buf, cached->buf + col, bytes);
+			buf += bytes;
+			max_bitflips = max_t(unsigned int, max_bitflips,
+					     cached->bitflips);
+			mtd->read_stats.cached++;
+		} else if (realpage != chip->pagecache.page || oob) {
+			/* Is the current page in the buffer? */
+			bool full_page = true;
+
 			bufpoi = use_bounce_buf ? chip->data_buf : buf;
 
 			if (use_bounce_buf && aligned)
@@ -3548,12 +3679,14 @@ static int nand_do_read_ops(struct nand_chip *chip, loff_t from,
 							      oob_required,
 							      page);
 			else if (!aligned && NAND_HAS_SUBPAGE_READ(chip) &&
-				 !oob)
+				 !oob) {
 				ret = chip->ecc.read_subpage(chip, col, bytes,
 							     bufpoi, page);
-			else
+				full_page = false;
+			} else
 				ret = chip->ecc.read_page(chip, bufpoi,
 							  oob_required, page);
+			mtd->read_stats.pages++;
 			if (ret < 0) {
 				if (use_bounce_buf)
 					/* Invalidate page cache */
@@ -3607,6 +3740,10 @@ static int nand_do_read_ops(struct nand_chip *chip, loff_t from,
 				}
 			}
 
+			if (use_readcache && full_page &&
+			    !(mtd->ecc_stats.failed - ecc_stats.failed))
+				nand_readcache_add(chip, realpage, bufpoi, ret);
+
 			buf += bytes;
 			max_bitflips = max_t(unsigned int, max_bitflips, ret);
 		} else {
@@ -4408,10 +4545,9 @@ static int nand_do_write_ops(struct nand_chip *chip, loff_t to,
 	realpage = (int)(to >> chip->page_shift);
 	page = realpage & chip->pagemask;
 
-	/* Invalidate the page cache, when we write to the cached page */
-	if (to <= ((loff_t)chip->pagecache.page << chip->page_shift) &&
-	    ((loff_t)chip->pagecache.page << chip->page_shift) < (to + ops->len))
-		chip->pagecache.page = -1;
+	/* Invalidate the page cache, when we write to a cached page */
+	nand_readcache_invalidate(chip, realpage,
+				  (int)((to + ops->len - 1) >> chip->page_shift));
 
 	/* Don't allow multipage oob writes with offset */
 	if (oob && ops->ooboffs && (ops->ooboffs + ops->ooblen > oobmaxlen)) {
@@ -4606,11 +4742,10 @@ int nand_erase_nand(struct nand_chip *chip, struct erase_info *instr,
 
 		/*
 		 * Invalidate the page cache, if we erase the block which
-		 * contains the current cached page.
+		 * contains a cached page.
 		 */
-		if (page <= chip->pagecache.page && chip->pagecache.page <
-		    (page + pages_per_block))
-			chip->pagecache.page = -1;
+		nand_readcache_invalidate(chip, page,
+					  page + pages_per_block - 1);
 
 		ret = nand_erase_op(chip, (page & chip->pagemask) >>
 				    (chip->phys_erase_shift - chip->page_shift));
@@ -4729,6 +4864,21 @@ static int nand_block_markgood(struct mtd_info *mtd, loff_t ofs)
 	return nand_block_markgood_lowlevel(mtd_to_nand(mtd), ofs);
 }
 
+/**
+ * nand_regenerate_bbt - Rescan a raw NAND device for bad blocks
+ * @mtd: MTD device structure, may be a partition of the NAND device
+ */
+int nand_regenerate_bbt(struct mtd_info *mtd)
+{
+	while (mtd->parent)
+		mtd = mtd->parent;
+
+	if (mtd->_block_isbad != nand_block_isbad)
+		return -EOPNOTSUPP;
+
+	return nand_bbt_regenerate(mtd_to_nand(mtd));
+}
+
 /**
  * nand_lock - [MTD Interface] Lock the NAND flash
  * @mtd: MTD device structure
@@ -5407,6 +5557,10 @@ static int rawnand_dt_init(struct nand_chip *chip)
 	if (of_property_read_bool(dn, "nand-on-flash-bbt"))
 		chip->bbt_options |= NAND_BBT_USE_FLASH;
 
+	if (IS_ENABLED(CONFIG_NAND_BBT_CACHE) &&
+	    of_property_read_bool(dn, "barebox,bbt-cache"))
+		chip->bbt_options |= NAND_BBT_BAREBOX_CACHE;
+
 	of_get_nand_ecc_user_config(nand);
 	of_get_nand_ecc_legacy_user_config(chip);
 
@@ -6301,6 +6455,10 @@ int nand_scan_tail(struct nand_chip *chip)
 	/* Invalidate the pagebuffer reference */
 	chip->pagecache.page = -1;
 
+	ret = nand_readcache_init(chip);
+	if (ret)
+		goto err_nand_manuf_cleanup;
+
 	/* Large page NAND with SOFT_ECC should support subpage reads */
 	switch (ecc->engine_type) {
 	case NAND_ECC_ENGINE_TYPE_SOFT:
@@ -6374,6 +6532,7 @@ int nand_scan_tail(struct nand_chip *chip)
 	nanddev_cleanup(&chip->base);
 
 err_nand_manuf_cleanup:
+	nand_readcache_free(chip);
 	nand_manufacturer_cleanup(chip);
 
 err_free_buf:
@@ -6456,6 +6615,7 @@ void nand_cleanup(struct nand_chip *chip)
 
 	/* Free bad block table memory */
 	kfree(chip->bbt);
+	nand_readcache_free(chip);
 	kfree(chip->data_buf);
 	kfree(chip->ecc.code_buf);
 	kfree(chip->ecc.calc_buf);
@@ -6550,6 +6710,13 @@ int add_mtd_nand_device(struct mtd_info *mtd, char *devname)
 	dev_add_param_uint32_ro(&mtd->dev, "ecc.strength", &chip->ecc.strength, "%u");
 	dev_add_param_uint32_ro(&mtd->dev, "ecc.size", &chip->ecc.size, "%u");
 
+	dev_add_param_uint32_ro(&mtd->dev, "stat_page_reads",
+				&mtd->read_stats.pages, "%u");
+	dev_add_param_uint32_ro(&mtd->dev, "stat_cache_hits",
+				&mtd->read_stats.cached, "%u");
+	dev_add_param_uint32_ro(&mtd->dev, "stat_overlapped_reads",
+				&mtd->read_stats.overlapped, "%u");
+
 	return ret;
 }
 
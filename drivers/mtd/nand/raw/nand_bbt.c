@@ -59,6 +59,7 @@
 #include <linux/bitops.h>
 #include <linux/export.h>
 #include <linux/string.h>
+#include <crc.h>
 
 #include "internals.h"
 
@@ -906,6 +907,302 @@ static inline int nand_memory_bbt(struct nand_chip *this,
 	return create_bbt(this, pagebuf, bd, -1);
 }
 
+#define BBT_CACHE_MAGIC		0x48434242	/* "BBCH" */
+#define BBT_CACHE_VERSION	1
+#define BBT_CACHE_COPIES	2
+
+/*
+ * On-flash layout of the barebox BBT cache: this header followed by the
+ * RAM-based BBT as is. The CRC covers both, with @crc itself set to zero.
+ */
+struct nand_bbt_cache_hdr {
+	__le32 magic;
+	__le32 version;
+	__le32 seq;
+	__le32 numblocks;
+	__le32 erasesize;
+	__le32 writesize;
+	__le32 oobsize;
+	__le32 len;
+	__le32 crc;
+};
+
+static int bbt_cache_numblocks(struct nand_chip *this)
+{
+	return nand_to_mtd(this)->size >> this->bbt_erase_shift;
+}
+
+/* Same size as the RAM-based BBT allocated in nand_scan_bbt() */
+static size_t bbt_cache_len(struct nand_chip *this)
+{
+	return (nand_to_mtd(this)->size >> (this->bbt_erase_shift + 2)) ? : 1;
+}
+
+static size_t bbt_cache_buflen(struct nand_chip *this)
+{
+	struct mtd_info *mtd = nand_to_mtd(this);
+
+	return ALIGN(sizeof(struct nand_bbt_cache_hdr) + bbt_cache_len(this),
+		     mtd->writesize);
+}
+
+/* The cache lives in the good blocks among the last blocks of the device */
+static void bbt_cache_mark_region(struct nand_chip *this)
+{
+	int numblocks = bbt_cache_numblocks(this);
+	int i;
+
+	for (i = numblocks - 1; i >= 0 && i >= numblocks - NAND_BBT_SCAN_MAXBLOCKS; i--)
+		if (bbt_get_entry(this, i) == BBT_BLOCK_GOOD)
+			bbt_mark_entry(this, i, BBT_BLOCK_RESERVED);
+}
+
+static void bbt_cache_count_bad(struct nand_chip *this)
+{
+	struct mtd_info *mtd = nand_to_mtd(this);
+	int i;
+
+	mtd->ecc_stats.badblocks = 0;
+
+	for (i = 0; i < bbt_cache_numblocks(this); i++) {
+		u8 entry = bbt_get_entry(this, i);
+
+		if (entry == BBT_BLOCK_WORN || entry == BBT_BLOCK_FACTORY_BAD)
+			mtd->ecc_stats.badblocks++;
+	}
+}
+
+static bool bbt_cache_valid(struct nand_chip *this, const void *buf)
+{
+	struct mtd_info *mtd = nand_to_mtd(this);
+	const struct nand_bbt_cache_hdr *hdr = buf;
+	struct nand_bbt_cache_hdr tmp = *hdr;
+	u32 crc;
+
+	if (le32_to_cpu(hdr->magic) != BBT_CACHE_MAGIC ||
+	    le32_to_cpu(hdr->version) != BBT_CACHE_VERSION ||
+	    le32_to_cpu(hdr->numblocks) != bbt_cache_numblocks(this) ||
+	    le32_to_cpu(hdr->erasesize) != mtd->erasesize ||
+	    le32_to_cpu(hdr->writesize) != mtd->writesize ||
+	    le32_to_cpu(hdr->oobsize) != mtd->oobsize ||
+	    le32_to_cpu(hdr->len) != bbt_cache_len(this))
+		return false;
+
+	tmp.crc = 0;
+	crc = crc32(0, &tmp, sizeof(tmp));
+	crc = crc32(crc, buf + sizeof(tmp), bbt_cache_len(this));
+
+	return crc == le32_to_cpu(hdr->crc);
+}
+
+/*
+ * The factory bad block markers never go away, so every block the cache lists
+ * as factory bad must still carry one. This only reads the few bad blocks, but
+ * catches a cache written for a different chip or one that got out of date.
+ */
+static int bbt_cache_verify(struct nand_chip *this, struct nand_bbt_descr *bd)
+{
+	u8 *buf = nand_get_data_buf(this);
+	int i, ret;
+
+	for (i = 0; i < bbt_cache_numblocks(this); i++) {
+		if (bbt_get_entry(this, i) != BBT_BLOCK_FACTORY_BAD)
+			continue;
+
+		ret = scan_block_fast(this, bd, (loff_t)i << this->bbt_erase_shift, buf);
+		if (ret < 0)
+			return ret;
+		if (!ret) {
+			pr_info("nand_bbt: block %d no longer marked bad, cache is stale\n", i);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * nand_bbt_cache_write - [GENERIC] write the barebox BBT cache
+ * @this: NAND chip object
+ *
+ * Writes the RAM-based BBT to up to BBT_CACHE_COPIES of the reserved blocks.
+ * The copies are written one after another, so at least one valid copy
+ * survives a power cut in between.
+ */
+static int nand_bbt_cache_write(struct nand_chip *this)
+{
+	struct mtd_info *mtd = nand_to_mtd(this);
+	struct nand_bbt_cache_hdr *hdr;
+	int numblocks = bbt_cache_numblocks(this);
+	size_t buflen = bbt_cache_buflen(this);
+	int i, copies = 0, ret = 0;
+	u8 *buf;
+
+	if (!IS_ENABLED(CONFIG_MTD_WRITE))
+		return 0;
+
+	if (buflen > mtd->erasesize)
+		return -ENOSPC;
+
+	buf = kzalloc(buflen, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	hdr = (struct nand_bbt_cache_hdr *)buf;
+	hdr->magic = cpu_to_le32(BBT_CACHE_MAGIC);
+	hdr->version = cpu_to_le32(BBT_CACHE_VERSION);
+	hdr->seq = cpu_to_le32(++this->bbt_cache_seq);
+	hdr->numblocks = cpu_to_le32(numblocks);
+	hdr->erasesize = cpu_to_le32(mtd->erasesize);
+	hdr->writesize = cpu_to_le32(mtd->writesize);
+	hdr->oobsize = cpu_to_le32(mtd->oobsize);
+	hdr->len = cpu_to_le32(bbt_cache_len(this));
+	memcpy(buf + sizeof(*hdr), this->bbt, bbt_cache_len(this));
+	hdr->crc = cpu_to_le32(crc32(0, buf, sizeof(*hdr) + bbt_cache_len(this)));
+
+	for (i = numblocks - 1; i >= 0 && i >= numblocks - NAND_BBT_SCAN_MAXBLOCKS &&
+	     copies < BBT_CACHE_COPIES; i--) {
+		loff_t to = (loff_t)i << this->bbt_erase_shift;
+		struct erase_info einfo = {
+			.addr = to,
+			.len = mtd->erasesize,
+		};
+		size_t retlen;
+
+		if (bbt_get_entry(this, i) != BBT_BLOCK_RESERVED)
+			continue;
+
+		ret = nand_erase_nand(this, &einfo, 1);
+		if (!ret)
+			ret = mtd_write(mtd, to, buflen, &retlen, buf);
+		if (ret) {
+			pr_warn("nand_bbt: error writing BBT cache to block %d: %pe\n",
+				i, ERR_PTR(ret));
+			bbt_mark_entry(this, i, BBT_BLOCK_WORN);
+			continue;
+		}
+
+		copies++;
+	}
+
+	kfree(buf);
+
+	if (!copies) {
+		pr_err("nand_bbt: no space left to write the BBT cache\n");
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+
+/**
+ * nand_bbt_cache_read - [GENERIC] read the barebox BBT cache
+ * @this: NAND chip object
+ * @bd: descriptor for the good/bad block search pattern
+ *
+ * Looks for the newest valid cache copy in the last blocks of the device and
+ * uses it as the RAM-based BBT. Returns 0 when the table could be restored,
+ * a negative error code when the device has to be scanned.
+ */
+static int nand_bbt_cache_read(struct nand_chip *this, struct nand_bbt_descr *bd)
+{
+	struct mtd_info *mtd = nand_to_mtd(this);
+	int numblocks = bbt_cache_numblocks(this);
+	size_t buflen = bbt_cache_buflen(this);
+	int i, ret, found = -1;
+	bool scrub = false;
+	u8 *buf, *best;
+
+	if (buflen > mtd->erasesize)
+		return -ENOSPC;
+
+	buf = kmalloc(buflen, GFP_KERNEL);
+	best = kmalloc(buflen, GFP_KERNEL);
+	if (!buf || !best) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = numblocks - 1; i >= 0 && i >= numblocks - NAND_BBT_SCAN_MAXBLOCKS; i--) {
+		struct nand_bbt_cache_hdr *hdr = (void *)buf;
+		size_t retlen;
+
+		ret = mtd_read(mtd, (loff_t)i << this->bbt_erase_shift, buflen,
+			       &retlen, buf);
+		if (ret && !mtd_is_bitflip(ret))
+			continue;
+		if (!bbt_cache_valid(this, buf))
+			continue;
+
+		if (found >= 0 &&
+		    (s32)(le32_to_cpu(hdr->seq) - this->bbt_cache_seq) <= 0)
+			continue;
+
+		found = i;
+		scrub = mtd_is_bitflip(ret);
+		this->bbt_cache_seq = le32_to_cpu(hdr->seq);
+		swap(buf, best);
+	}
+
+	if (found < 0) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	memcpy(this->bbt, best + sizeof(struct nand_bbt_cache_hdr),
+	       bbt_cache_len(this));
+
+	ret = bbt_cache_verify(this, bd);
+	if (ret) {
+		memset(this->bbt, 0, bbt_cache_len(this));
+		goto out;
+	}
+
+	bbt_cache_count_bad(this);
+
+	pr_debug("nand_bbt: using BBT cache from block %d, sequence %u\n",
+		 found, this->bbt_cache_seq);
+
+	if (scrub)
+		nand_bbt_cache_write(this);
+
+	ret = 0;
+out:
+	kfree(buf);
+	kfree(best);
+	return ret;
+}
+
+/**
+ * nand_cached_bbt - [GENERIC] create a memory based bbt backed by a flash cache
+ * @this: NAND chip object
+ * @bd: descriptor for the good/bad block search pattern
+ * @force: ignore the cache and always scan the device
+ */
+static int nand_cached_bbt(struct nand_chip *this, struct nand_bbt_descr *bd,
+			   bool force)
+{
+	int ret;
+
+	if (!force && !nand_bbt_cache_read(this, bd))
+		return 0;
+
+	memset(this->bbt, 0, bbt_cache_len(this));
+	nand_to_mtd(this)->ecc_stats.badblocks = 0;
+
+	ret = nand_memory_bbt(this, bd);
+	if (ret)
+		return ret;
+
+	bbt_cache_mark_region(this);
+
+	ret = nand_bbt_cache_write(this);
+	if (ret)
+		pr_warn("nand_bbt: cannot write BBT cache: %pe\n", ERR_PTR(ret));
+
+	return 0;
+}
+
 /**
  * check_create - [GENERIC] create and write bbt(s) if necessary
  * @this: the NAND device
@@ -1235,7 +1532,11 @@ static int nand_scan_bbt(struct nand_chip *this, struct nand_bbt_descr *bd)
 	 * memory based bad block table.
 	 */
 	if (!td) {
-		if ((res = nand_memory_bbt(this, bd))) {
+		if (this->bbt_options & NAND_BBT_BAREBOX_CACHE)
+			res = nand_cached_bbt(this, bd, false);
+		else
+			res = nand_memory_bbt(this, bd);
+		if (res) {
 			pr_err("nand_bbt: can't scan flash and build the RAM-based BBT\n");
 			goto err_free_bbt;
 		}
@@ -1450,6 +1751,8 @@ static int nand_mark_bbt(struct nand_chip *this, loff_t offs, uint8_t mark)
 	/* Update flash-based bad block table */
 	if (this->bbt_options & NAND_BBT_USE_FLASH)
 		ret = nand_update_bbt(this, offs);
+	else if (this->bbt_options & NAND_BBT_BAREBOX_CACHE)
+		ret = nand_bbt_cache_write(this);
 
 	return ret;
 }
@@ -1473,3 +1776,30 @@ int nand_markgood_bbt(struct nand_chip *this, loff_t offs)
 {
 	return nand_mark_bbt(this, offs, BBT_BLOCK_GOOD);
 }
+
+/**
+ * nand_bbt_regenerate - [NAND Interface] Rescan the device for bad blocks
+ * @this: NAND chip object
+ *
+ * Throws away the RAM-based BBT and scans the device again. With
+ * NAND_BBT_BAREBOX_CACHE the cache on flash is rewritten from the result.
+ */
+int nand_bbt_regenerate(struct nand_chip *this)
+{
+	struct nand_bbt_descr *bd = this->badblock_pattern;
+
+	if (!this->bbt || !bd)
+		return -EINVAL;
+
+	/* The on-flash BBT is authoritative, it cannot be rebuilt from a scan */
+	if (this->bbt_td)
+		return -EOPNOTSUPP;
+
+	if (this->bbt_options & NAND_BBT_BAREBOX_CACHE)
+		return nand_cached_bbt(this, bd, true);
+
+	memset(this->bbt, 0, bbt_cache_len(this));
+	nand_to_mtd(this)->ecc_stats.badblocks = 0;
+
+	return nand_memory_bbt(this, bd);
+}
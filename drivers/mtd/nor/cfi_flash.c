@@ -499,113 +499,270 @@ static int cfi_erase(struct flash_info *finfo, size_t count, loff_t offset)
         return ret;
 }
 
-static int write_buff(struct flash_info *info, const u8 *src,
-		unsigned long addr, unsigned long cnt)
+/*
+ * A write request for one flash chip. cfi_write() programs several of these
+ * at the same time, so that independent chips (e.g. the banks of a
+ * concatenated device) each have a buffer program in flight.
+ */
+struct cfi_write_job {
+	struct flash_info *info;
+	const u8 *src;
+	unsigned long wp;	/* next address to program */
+	unsigned long cnt;	/* bytes left */
+
+	/* pending buffer program, if any */
+	bool busy;
+	flash_sect_t sect;
+	unsigned long len;
+	u64 start;
+};
+
+/* handle an unaligned start, leaves job->wp portwidth aligned */
+static int cfi_write_head(struct cfi_write_job *job)
 {
+	struct flash_info *info = job->info;
 	unsigned long wp;
-	u8 *p;
-	int aln;
 	cfiword_t cword;
-	int i, ret;
+	int i, aln, ret;
+	u8 *p;
 
-#ifdef CONFIG_CFI_BUFFER_WRITE
-	int buffered_size;
-#endif
 	/* get lower aligned address */
-	wp = addr & ~((unsigned long)info->portwidth - 1);
-
-	/* handle unaligned start */
-	aln = addr - wp;
-	if (aln) {
-		cword = 0;
-		p = (u8 *)wp;
-		for (i = 0; i < aln; ++i)
-			flash_add_byte(info, &cword, flash_read8(p + i));
-
-		for (; (i < info->portwidth) && (cnt > 0); i++) {
-			flash_add_byte(info, &cword, *src++);
-			cnt--;
-		}
+	wp = job->wp & ~((unsigned long)info->portwidth - 1);
 
-		for (; (cnt == 0) && (i < info->portwidth); ++i)
-			flash_add_byte(info, &cword, flash_read8(p + i));
+	aln = job->wp - wp;
+	if (!aln)
+		return 0;
 
-		ret = flash_write_cfiword(info, wp, cword);
-		if (ret)
-			return ret;
+	cword = 0;
+	p = (u8 *)wp;
+	for (i = 0; i < aln; ++i)
+		flash_add_byte(info, &cword, flash_read8(p + i));
+
+	for (; (i < info->portwidth) && (job->cnt > 0); i++) {
+		flash_add_byte(info, &cword, *job->src++);
+		job->cnt--;
+	}
+
+	for (; (job->cnt == 0) && (i < info->portwidth); ++i)
+		flash_add_byte(info, &cword, flash_read8(p + i));
+
+	ret = flash_write_cfiword(info, wp, cword);
+	if (ret)
+		return ret;
+
+	job->wp = wp + i;
+
+	return 0;
+}
+
+/* handle unaligned tail bytes */
+static int cfi_write_tail(struct cfi_write_job *job)
+{
+	struct flash_info *info = job->info;
+	cfiword_t cword;
+	u8 *p;
+	int i;
+
+	if (job->cnt == 0)
+		return 0;
+
+	cword = 0;
+	p = (u8 *)job->wp;
 
-		wp += i;
+	for (i = 0; (i < info->portwidth) && (job->cnt > 0); ++i) {
+		flash_add_byte(info, &cword, *job->src++);
+		--job->cnt;
 	}
 
-	/* handle the aligned part */
+	for (; i < info->portwidth; ++i)
+		flash_add_byte(info, &cword, flash_read8(p + i));
+
+	return flash_write_cfiword(info, job->wp, cword);
+}
+
+static int cfi_write_word(struct cfi_write_job *job)
+{
+	struct flash_info *info = job->info;
+	cfiword_t cword = 0;
+	int i, ret;
+
+	for (i = 0; i < info->portwidth; i++)
+		flash_add_byte(info, &cword, *job->src++);
+
+	ret = flash_write_cfiword(info, job->wp, cword);
+	if (ret)
+		return ret;
+
+	job->wp += info->portwidth;
+	job->cnt -= info->portwidth;
+
+	return 0;
+}
+
 #ifdef CONFIG_CFI_BUFFER_WRITE
+/*
+ * Start the next buffer program of @job. Chunks that are all 0xff are
+ * skipped: programming them cannot change the flash contents.
+ */
+static int cfi_write_job_start(struct cfi_write_job *job)
+{
+	struct flash_info *info = job->info;
+	unsigned long buffered_size, len;
+	int ret;
+
 	buffered_size = (info->portwidth / info->chipwidth);
 	buffered_size *= info->buffer_size;
-	while (cnt >= info->portwidth) {
+
+	while (job->cnt >= info->portwidth) {
 		/* prohibit buffer write when buffer_size is 1 */
 		if (info->buffer_size == 1) {
-			cword = 0;
-
-			for (i = 0; i < info->portwidth; i++)
-				flash_add_byte(info, &cword, *src++);
-
-			ret = flash_write_cfiword(info, wp, cword);
+			ret = cfi_write_word(job);
 			if (ret)
 				return ret;
-
-			wp += info->portwidth;
-			cnt -= info->portwidth;
-
 			continue;
 		}
 
 		/* write buffer until next buffered_size aligned boundary */
-		i = buffered_size - (wp % buffered_size);
-		if (i > cnt)
-			i = cnt;
+		len = buffered_size - (job->wp % buffered_size);
+		if (len > job->cnt)
+			len = job->cnt;
+		len -= len & (info->portwidth - 1);
+
+		if (!memchr_inv(job->src, 0xff, len)) {
+			job->wp += len;
+			job->src += len;
+			job->cnt -= len;
+			continue;
+		}
 
-		ret = info->cfi_cmd_set->flash_write_cfibuffer(info, wp, src, i);
+		ret = info->cfi_cmd_set->flash_write_cfibuffer(info, job->wp,
+							       job->src, len);
 		if (ret)
 			return ret;
 
-		i -= i & (info->portwidth - 1);
-		wp += i;
-		src += i;
-		cnt -= i;
+		job->busy = true;
+		job->sect = find_sector(info, job->wp);
+		job->len = len;
+		job->start = get_time_ns();
+		break;
 	}
+
+	return 0;
+}
+
+/* Complete the pending buffer program of @job unless it is still running */
+static int cfi_write_job_poll(struct cfi_write_job *job, bool wait)
+{
+	struct flash_info *info = job->info;
+	int ret;
+
+	if (!wait && info->cfi_cmd_set->flash_is_busy(info, job->sect) &&
+	    !is_timeout(job->start, info->buffer_write_tout * MSECOND))
+		return 0;
+
+	/* reports errors and timeouts, returns the chip to read mode */
+	ret = flash_status_check(info, job->sect, info->buffer_write_tout,
+				 "buffer write");
+	job->busy = false;
+	if (ret)
+		return ret;
+
+	job->wp += job->len;
+	job->src += job->len;
+	job->cnt -= job->len;
+
+	return 0;
+}
+
+/* program the portwidth aligned part of all jobs */
+static int cfi_write_aligned(struct cfi_write_job *jobs, int num)
+{
+	bool pending;
+	int i, ret;
+
+	do {
+		pending = false;
+
+		for (i = 0; i < num; i++) {
+			struct cfi_write_job *job = &jobs[i];
+
+			if (job->busy) {
+				ret = cfi_write_job_poll(job, false);
+				if (ret)
+					goto err;
+			}
+
+			if (!job->busy) {
+				ret = cfi_write_job_start(job);
+				if (ret)
+					goto err;
+			}
+
+			pending |= job->busy;
+		}
+	} while (pending);
+
+	return 0;
+
+err:
+	/* let the other chips finish what they are programming */
+	for (i = 0; i < num; i++)
+		if (jobs[i].busy)
+			cfi_write_job_poll(&jobs[i], true);
+
+	return ret;
+}
 #else
-	while (cnt >= info->portwidth) {
-		cword = 0;
+static int cfi_write_aligned(struct cfi_write_job *jobs, int num)
+{
+	int i, ret;
 
-		for (i = 0; i < info->portwidth; i++)
-			flash_add_byte(info, &cword, *src++);
+	for (i = 0; i < num; i++) {
+		while (jobs[i].cnt >= jobs[i].info->portwidth) {
+			ret = cfi_write_word(&jobs[i]);
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_CFI_BUFFER_WRITE */
 
-		ret = flash_write_cfiword(info, wp, cword);
+static int cfi_write(struct cfi_write_job *jobs, int num)
+{
+	int i, ret;
+
+	for (i = 0; i < num; i++) {
+		ret = cfi_write_head(&jobs[i]);
 		if (ret)
 			return ret;
-
-		wp += info->portwidth;
-		cnt -= info->portwidth;
 	}
-#endif /* CONFIG_CFI_BUFFER_WRITE */
-	if (cnt == 0)
-		return 0;
 
-	/*
-	 * handle unaligned tail bytes
-	 */
-	cword = 0;
-	p = (u8 *)wp;
+	ret = cfi_write_aligned(jobs, num);
+	if (ret)
+		return ret;
 
-	for (i = 0; (i < info->portwidth) && (cnt > 0); ++i) {
-		flash_add_byte(info, &cword, *src++);
-		--cnt;
+	for (i = 0; i < num; i++) {
+		ret = cfi_write_tail(&jobs[i]);
+		if (ret)
+			return ret;
 	}
 
-	for (; i < info->portwidth; ++i)
-		flash_add_byte(info, &cword, flash_read8(p + i));
+	return 0;
+}
 
-	return flash_write_cfiword(info, wp, cword);
+static int write_buff(struct flash_info *info, const u8 *src,
+		unsigned long addr, unsigned long cnt)
+{
+	struct cfi_write_job job = {
+		.info = info,
+		.src = src,
+		.wp = addr,
+		.cnt = cnt,
+	};
+
+	return cfi_write(&job, 1);
 }
 
 static int flash_real_protect(struct flash_info *info, long sector, int prot)
@@ -914,6 +1071,50 @@ static int cfi_mtd_write(struct mtd_info *mtd, loff_t to, size_t len,
         return ret;
 }
 
+/*
+ * Write to the concatenation of all chips: split the request per chip and
+ * program the chips concurrently instead of one after the other.
+ */
+static int cfi_concat_write(struct mtd_info *mtd, loff_t to, size_t len,
+		size_t *retlen, const u8 *buf)
+{
+	struct cfi_priv *priv = mtd->dev.parent->priv;
+	struct cfi_write_job *jobs;
+	size_t remaining = len;
+	int i, num = 0, ret;
+
+	jobs = xzalloc(sizeof(*jobs) * priv->num_devs);
+
+	for (i = 0; i < priv->num_devs && remaining; i++) {
+		struct flash_info *info = &priv->infos[i];
+		size_t size;
+
+		if (to >= info->size) {
+			to -= info->size;
+			continue;
+		}
+
+		size = min_t(size_t, remaining, info->size - to);
+
+		jobs[num].info = info;
+		jobs[num].src = buf;
+		jobs[num].wp = (unsigned long)info->base + to;
+		jobs[num].cnt = size;
+		num++;
+
+		buf += size;
+		remaining -= size;
+		to = 0;
+	}
+
+	ret = cfi_write(jobs, num);
+	free(jobs);
+
+	*retlen = ret ? 0 : len;
+
+	return ret;
+}
+
 static int cfi_mtd_erase(struct mtd_info *mtd, struct erase_info *instr)
 {
 	struct flash_info *info = container_of(mtd, struct flash_info, mtd);
@@ -1031,6 +1232,10 @@ static int cfi_probe(struct device *dev)
 			dev_err(dev, "failed to create concat mtd device\n");
 			return -ENODEV;
 		}
+
+		/* program the chips in parallel when writes span several */
+		if (IS_ENABLED(CONFIG_CFI_BUFFER_WRITE))
+			mtd->_write = cfi_concat_write;
 	} else {
 		if (priv->num_devs > 1)
 			dev_warn(dev, "mtd concat disabled. using first chip only\n");
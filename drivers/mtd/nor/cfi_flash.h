@@ -105,6 +105,10 @@ struct cfi_pri_hdr {
 
 
 struct cfi_cmd_set {
+	/*
+	 * Load the write buffer and start programming it. Does not wait for
+	 * completion, the caller polls flash_is_busy/flash_status_check.
+	 */
 	int (*flash_write_cfibuffer)(struct flash_info *info, unsigned long dest,
 			const u8 *cp, int len);
 	int (*flash_erase_one)(struct flash_info *info, long sect);
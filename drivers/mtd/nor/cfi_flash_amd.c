@@ -175,8 +175,7 @@ static int amd_flash_write_cfibuffer(struct flash_info *info, unsigned long dest
 
 	flash_write_cmd(info, sector, 0, AMD_CMD_WRITE_BUFFER_CONFIRM);
 
-	return flash_status_check(info, sector, info->buffer_write_tout,
-					   "buffer write");
+	return 0;
 }
 #else
 #define amd_flash_write_cfibuffer NULL
@@ -97,10 +97,8 @@ static int intel_flash_write_cfibuffer(struct flash_info *info,
 	}
 
 	flash_write_cmd(info, sector, 0, FLASH_CMD_WRITE_BUFFER_CONFIRM);
-	ret = flash_status_check(info, sector,
-					   info->buffer_write_tout,
-					   "buffer write");
-	return ret;
+
+	return 0;
 }
 #else
 #define intel_flash_write_cfibuffer NULL
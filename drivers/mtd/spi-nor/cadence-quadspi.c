@@ -11,6 +11,8 @@
 
 #include <clock.h>
 #include <common.h>
+#include <dma.h>
+#include <dma-devices.h>
 #include <driver.h>
 #include <errno.h>
 #include <init.h>
@@ -39,6 +41,13 @@ struct cqspi_flash_pdata {
 	u8	     data_width;
 };
 
+struct cqspi_driver_platdata {
+	u32 quirks;
+};
+
+/* Direct access through the AHB window is broken */
+#define CQSPI_DISABLE_DAC_MODE		BIT(0)
+
 struct cqspi_st {
 	struct device	*dev;
 	struct clk	*l4_mp_clk;
@@ -47,6 +56,10 @@ struct cqspi_st {
 
 	void __iomem	*iobase;
 	void __iomem	*ahb_base;
+	resource_size_t	ahb_size;
+	phys_addr_t	ahb_phys;
+	bool		use_direct_mode;
+	bool		use_dma_read;
 	unsigned int	irq_mask;
 	int		current_cs;
 	unsigned int	master_ref_clk_hz;
@@ -65,6 +78,9 @@ struct cqspi_st {
 
 #define CQSPI_REG_SRAM_THRESHOLD_BYTES		50
 
+/* Smaller direct reads are not worth setting up a DMA transfer */
+#define CQSPI_DMA_READ_MIN_BYTES		SZ_4K
+
 /* Instruction type */
 #define CQSPI_INST_TYPE_SINGLE			0
 #define CQSPI_INST_TYPE_DUAL			1
@@ -80,6 +96,7 @@ struct cqspi_st {
 /* Register map */
 #define CQSPI_REG_CONFIG			0x00
 #define CQSPI_REG_CONFIG_ENABLE_MASK		BIT(0)
+#define CQSPI_REG_CONFIG_ENB_DIR_ACC_CTRL	BIT(7)
 #define CQSPI_REG_CONFIG_DECODE_MASK		BIT(9)
 #define CQSPI_REG_CONFIG_CHIPSELECT_LSB		10
 #define CQSPI_REG_CONFIG_DMA_MASK		BIT(15)
@@ -224,19 +241,17 @@ static void cqspi_fifo_read(void *dest, const void *src_ahb_addr,
 			    unsigned int bytes)
 {
 	unsigned int temp;
-	int remaining = bytes;
-	unsigned int *dest_ptr = (unsigned int *)dest;
-	unsigned int *src_ptr = (unsigned int *)src_ahb_addr;
+	unsigned int words = bytes / CQSPI_FIFO_WIDTH;
+	int remaining = bytes % CQSPI_FIFO_WIDTH;
+
+	/* every access to the trigger address pops the next FIFO word */
+	if (words)
+		readsl(src_ahb_addr, dest, words);
 
-	while (remaining > CQSPI_FIFO_WIDTH) {
-		*dest_ptr = readl(src_ptr);
-		dest_ptr++;
-		remaining -= CQSPI_FIFO_WIDTH;
-	}
 	if (remaining > 0) {
 		/* dangling bytes */
-		temp = readl(src_ptr);
-		memcpy(dest_ptr, &temp, remaining);
+		temp = readl(src_ahb_addr);
+		memcpy(dest + words * CQSPI_FIFO_WIDTH, &temp, remaining);
 	}
 }
 
@@ -548,6 +563,60 @@ static int cqspi_indirect_read_execute(struct spi_nor *nor,
 	return ret;
 }
 
+static int cqspi_direct_read_dma(struct cqspi_st *cqspi, u8 *rxbuf,
+				 loff_t from, size_t n_rx)
+{
+	dma_addr_t dma_dst;
+	int ret;
+
+	dma_dst = dma_map_single(cqspi->dev, rxbuf, n_rx, DMA_FROM_DEVICE);
+	if (dma_mapping_error(cqspi->dev, dma_dst))
+		return -ENOMEM;
+
+	ret = dma_memcpy(dma_dst, cqspi->ahb_phys + from, n_rx);
+
+	dma_unmap_single(cqspi->dev, dma_dst, n_rx, DMA_FROM_DEVICE);
+
+	return ret;
+}
+
+/*
+ * Read through the memory mapped AHB window. The controller issues the read
+ * command configured in CQSPI_REG_RD_INSTR itself, so large reads can be
+ * handed to a memcpy capable DMA engine instead of copying word by word.
+ */
+static int cqspi_direct_read_execute(struct spi_nor *nor, u8 *rxbuf,
+				     loff_t from, size_t n_rx)
+{
+	struct cqspi_st *cqspi = nor->priv;
+	size_t head, len;
+	int ret;
+
+	if (cqspi->use_dma_read && n_rx >= CQSPI_DMA_READ_MIN_BYTES) {
+		/* DMA only the part of the buffer we can map without side effects */
+		head = PTR_ALIGN(rxbuf, ARCH_DMA_MINALIGN) - rxbuf;
+		len = ALIGN_DOWN(n_rx - head, ARCH_DMA_MINALIGN);
+
+		ret = cqspi_direct_read_dma(cqspi, rxbuf + head, from + head, len);
+		if (!ret) {
+			memcpy_fromio(rxbuf, cqspi->ahb_base + from, head);
+			memcpy_fromio(rxbuf + head + len,
+				      cqspi->ahb_base + from + head + len,
+				      n_rx - head - len);
+			return 0;
+		}
+
+		if (ret == -ENODEV)
+			cqspi->use_dma_read = false;
+		else
+			dev_warn(nor->dev, "DMA read failed: %pe\n", ERR_PTR(ret));
+	}
+
+	memcpy_fromio(rxbuf, cqspi->ahb_base + from, n_rx);
+
+	return 0;
+}
+
 static __maybe_unused int cqspi_indirect_write_setup(struct spi_nor *nor,
 						     unsigned int to_addr)
 {
@@ -938,6 +1007,7 @@ static void cqspi_write(struct spi_nor *nor, loff_t to,
 static int cqspi_read(struct spi_nor *nor, loff_t from,
 		      size_t len, size_t *retlen, u_char *buf)
 {
+	struct cqspi_st *cqspi = nor->priv;
 	int ret;
 
 	ret = cqspi_set_protocol(nor, 1);
@@ -945,11 +1015,17 @@ static int cqspi_read(struct spi_nor *nor, loff_t from,
 		return ret;
 
 	ret = cqspi_indirect_read_setup(nor, from);
-	if (ret == 0) {
+	if (ret)
+		return ret;
+
+	if (cqspi->use_direct_mode && from + len <= cqspi->ahb_size)
+		ret = cqspi_direct_read_execute(nor, buf, from, len);
+	else
 		ret = cqspi_indirect_read_execute(nor, buf, len);
-		if (ret == 0)
-			*retlen += len;
-	}
+
+	if (ret == 0)
+		*retlen += len;
+
 	return ret;
 }
 
@@ -1147,6 +1223,14 @@ static void cqspi_controller_init(struct cqspi_st *cqspi)
 	/* Disable all interrupts */
 	writel(0, cqspi->iobase + CQSPI_REG_IRQMASK);
 
+	/* Enable direct access controller for reads through the AHB window */
+	if (cqspi->use_direct_mode) {
+		u32 reg = readl(cqspi->iobase + CQSPI_REG_CONFIG);
+
+		reg |= CQSPI_REG_CONFIG_ENB_DIR_ACC_CTRL;
+		writel(reg, cqspi->iobase + CQSPI_REG_CONFIG);
+	}
+
 	cqspi_controller_enable(cqspi);
 }
 
@@ -1156,6 +1240,7 @@ static int cqspi_probe(struct device *dev)
 	struct device_node *np = dev->of_node;
 	struct cqspi_st *cqspi;
 	struct cadence_qspi_platform_data *pdata = dev->platform_data;
+	const struct cqspi_driver_platdata *ddata;
 	int ret;
 
 	cqspi = kzalloc(sizeof(*cqspi), GFP_KERNEL);
@@ -1195,6 +1280,18 @@ static int cqspi_probe(struct device *dev)
 	if (IS_ERR(iores))
 		return PTR_ERR(iores);
 	cqspi->ahb_base = IOMEM(iores->start);
+	cqspi->ahb_phys = iores->start;
+	cqspi->ahb_size = resource_size(iores);
+
+	/*
+	 * Legacy platform data setups only map the FIFO window, so only use
+	 * direct access when the device tree describes the AHB window.
+	 */
+	ddata = device_get_match_data(dev);
+	if (dev->of_node && !(ddata && (ddata->quirks & CQSPI_DISABLE_DAC_MODE))) {
+		cqspi->use_direct_mode = true;
+		cqspi->use_dma_read = IS_ENABLED(CONFIG_DMADEVICES);
+	}
 
 	cqspi_wait_idle(cqspi);
 	cqspi_controller_init(cqspi);
@@ -1238,8 +1335,13 @@ static int cqspi_probe(struct device *dev)
 	return ret;
 }
 
+static const struct cqspi_driver_platdata socfpga_qspi = {
+	.quirks = CQSPI_DISABLE_DAC_MODE,
+};
+
 static __maybe_unused struct of_device_id cqspi_dt_ids[] = {
 	{.compatible = "cdns,qspi-nor",},
+	{.compatible = "intel,socfpga-qspi", .data = &socfpga_qspi, },
 	{ /* end of table */ }
 };
 MODULE_DEVICE_TABLE(of, cqspi_dt_ids);
@@ -107,6 +107,8 @@
 /* Bit fields in SPI_CTRL0 */
 #define SPI_SPI_CTRL0_INST_L8		(0x2 << 8) /* two bit value */
 #define SPI_SPI_CTRL0_WAIT_8_CYCLE	(0x8 << 11)/* five bit value */
+#define SPI_SPI_CTRL0_WAIT_OFFSET	11
+#define SPI_SPI_CTRL0_WAIT_MASK		(0x1f << SPI_SPI_CTRL0_WAIT_OFFSET)
 #define SPI_SPI_CTRL0_EN_CLK_STRETCH    BIT(30)
 
 #define SPI_SPI_CTRL0_ADDR_L_OFFSET	2
@@ -396,6 +398,21 @@ static int dw_spi_set_addr_len(struct spi_nor *nor)
 	return 0;
 }
 
+static void dw_spi_set_wait_cycles(struct spi_nor *nor)
+{
+	struct dw_spi_nor *dw_spi = nor->priv;
+	u32 val;
+
+	val = dw_readl(dw_spi, DW_SPI_SPI_CTRL0);
+	val &= ~SPI_SPI_CTRL0_WAIT_MASK;
+	val |= (nor->read_dummy << SPI_SPI_CTRL0_WAIT_OFFSET) &
+		SPI_SPI_CTRL0_WAIT_MASK;
+
+	dw_spi_enable_chip(dw_spi, 0);
+	dw_writel(dw_spi, DW_SPI_SPI_CTRL0, val);
+	dw_spi_enable_chip(dw_spi, 1);
+}
+
 static int dw_spi_prep_enhanced(struct spi_nor *nor,
 				enum spi_nor_protocol proto, u8 tmod)
 {
@@ -411,6 +428,10 @@ static int dw_spi_prep_enhanced(struct spi_nor *nor,
 		dev_dbg(nor->dev, "quad mode\n");
 		frf = SPI_QUAD_FORMAT;
 		break;
+	case SNOR_PROTO_1_1_8:
+		dev_dbg(nor->dev, "octal mode\n");
+		frf = SPI_OCTAL_FORMAT;
+		break;
 	default:
 		dev_err(nor->dev, "unsupported enhanced mode %d\n",
 			nor->read_proto);
@@ -449,10 +470,12 @@ static int dw_spi_read_enhanced(struct spi_nor *nor, const u8 opcode,
 	dw_writel(dw_spi, DW_SPI_DR, address);
 
 	while (n_rx) {
-		if (dw_spi_rx_fifo_not_empty(dw_spi)) {
+		/* drain everything the FIFO holds instead of polling per byte */
+		u32 level = min_t(u32, dw_readl(dw_spi, DW_SPI_RXFLR), n_rx);
+
+		n_rx -= level;
+		while (level--)
 			rxbuf[offset++] = dw_readl(dw_spi, DW_SPI_DR);
-			n_rx--;
-		}
 
 		/* check RX/TX overflow */
 		if (dw_spi_rx_tx_fifo_overflow(dw_spi))
@@ -467,7 +490,7 @@ static int dw_spi_read_std(struct spi_nor *nor, const u8 opcode, int address,
 {
 	struct dw_spi_nor *dw_spi = nor->priv;
 	int tx_cnt = n_rx, rx_cnt = n_rx, skip_rx, cur_rx = 0;
-	int ret = 0, i, txfhr, rx_free;
+	int ret = 0, i, txfhr, rx_free, dummy;
 	u32 tmp_val;
 
 	ret = dw_spi_wait_not_busy(dw_spi);
@@ -480,7 +503,9 @@ static int dw_spi_read_std(struct spi_nor *nor, const u8 opcode, int address,
 	/* TX fifo must not became empty during the frame transfer:
 	 * use TXFTHR (Transfert Start FIFO level) to avoid the frame
 	 * to start during the first phase computation */
-	skip_rx = 1 /* opcode */ + nor->addr_width;
+	/* register reads have no dummy cycles, memory reads may, e.g. RDSFDP */
+	dummy = address >= 0 ? nor->read_dummy / 8 : 0;
+	skip_rx = 1 /* opcode */ + nor->addr_width + dummy;
 	txfhr = min_t(unsigned int, skip_rx + n_rx, dw_spi->tx_fifo_len) - 1;
 	rx_free = dw_spi->rx_fifo_len - skip_rx;
 
@@ -496,6 +521,10 @@ static int dw_spi_read_std(struct spi_nor *nor, const u8 opcode, int address,
 	for (i = nor->addr_width - 1; i >= 0; i--)
 		dw_writel(dw_spi, DW_SPI_DR, (address >> (8 * i)) & 0xff);
 
+	/* dummy phase, clocked like data in standard format */
+	for (i = 0; i < dummy; i++)
+		dw_writel(dw_spi, DW_SPI_DR, 0xff);
+
 	while (rx_cnt) {
 		/* push dummy bytes to receive data */
 		while (tx_cnt && dw_spi_tx_fifo_not_full(dw_spi) &&
@@ -675,9 +704,11 @@ static int dw_spi_read(struct spi_nor *nor, loff_t from,
 	*retlen = 0;
 	dev_dbg(nor->dev, "read %zu bytes from @0x%llx\n", len, from);
 
-	if (enhanced)
+	if (enhanced) {
+		/* dummy cycles depend on the read op code picked from SFDP */
+		dw_spi_set_wait_cycles(nor);
 		ret = dw_spi_prep_enhanced(nor, nor->read_proto, SPI_TMOD_RO);
-	else
+	} else
 		ret = dw_spi_prep_std(nor, SPI_TMOD_TR);
 	if (ret)
 		return ret;
@@ -743,7 +774,7 @@ static int dw_spi_setup_flash(struct device *dev,
 			      struct dw_spi_flash_pdata *f_pdata,
 			      struct device_node *np)
 {
-	const struct spi_nor_hwcaps hwcaps = {
+	struct spi_nor_hwcaps hwcaps = {
 		.mask = SNOR_HWCAPS_READ |
 			SNOR_HWCAPS_READ_FAST |
 			SNOR_HWCAPS_READ_1_1_2 |
@@ -754,6 +785,7 @@ static int dw_spi_setup_flash(struct device *dev,
 	struct dw_spi_nor *dw_spi = dev->priv;
 	struct mtd_info *mtd = &f_pdata->mtd;
 	struct spi_nor *nor = &f_pdata->nor;
+	u32 rx_bus_width;
 	int ret;
 
 	ret = dw_spi_of_get_flash_pdata(dev, f_pdata, np);
@@ -784,6 +816,11 @@ static int dw_spi_setup_flash(struct device *dev,
 	nor->write = dw_spi_write;
 	nor->erase = dw_spi_erase;
 
+	/* Octal reads need all eight data lines wired up */
+	if (!of_property_read_u32(np, "spi-rx-bus-width", &rx_bus_width) &&
+	    rx_bus_width == 8)
+		hwcaps.mask |= SNOR_HWCAPS_READ_1_1_8;
+
 	ret = spi_nor_scan(nor, NULL, &hwcaps, false);
 	if (ret)
 		goto probe_failed;
@@ -83,6 +83,15 @@ struct flash_info {
 #define SPI_NOR_OCTAL_READ	BIT(15)	/* Flash supports Octal Read */
 #define UNLOCK_GLOBAL_BLOCK	BIT(16)	/* Unlock global block protection */
 #define SPI_NOR_QUAD_WRITE	BIT(17)	/* Flash supports Quad Write */
+#define SPI_NOR_GENERIC		BIT(18)	/*
+					 * Unknown JEDEC ID, the flash is
+					 * described by its SFDP tables only.
+					 */
+#define SPI_NOR_PARSE_SFDP	BIT(19)	/*
+					 * Known flash whose SFDP tables have
+					 * been verified, let them override the
+					 * parameters from this table.
+					 */
 };
 
 enum spi_nor_read_command_index {
@@ -99,6 +108,9 @@ enum spi_nor_read_command_index {
 	SNOR_CMD_READ_1_4_4,
 	SNOR_CMD_READ_4_4_4,
 
+	/* Octal SPI */
+	SNOR_CMD_READ_1_1_8,
+
 	SNOR_CMD_READ_MAX
 };
 
@@ -125,14 +137,30 @@ enum spi_nor_pp_command_index {
 	SNOR_CMD_PP_MAX
 };
 
+#define SNOR_ERASE_TYPE_MAX	4
+
+struct spi_nor_erase_type {
+	u32				size;
+	u8				opcode;
+};
+
+/* 3-byte address op code to 4-byte address op code pairs from the 4BAIT */
+#define SNOR_4B_OPCODES_MAX	16
+
 struct spi_nor_flash_parameter {
 	u64				size;
 	u32				page_size;
+	u8				addr_width;
 
 	struct spi_nor_hwcaps		hwcaps;
 	struct spi_nor_read_command	reads[SNOR_CMD_READ_MAX];
 	struct spi_nor_pp_command	page_programs[SNOR_CMD_PP_MAX];
 
+	struct spi_nor_erase_type	erase_types[SNOR_ERASE_TYPE_MAX];
+
+	u8				opcodes_4b[SNOR_4B_OPCODES_MAX][2];
+	unsigned int			num_opcodes_4b;
+
 	int (*quad_enable)(struct spi_nor *nor);
 };
 
@@ -250,6 +278,7 @@ static u8 spi_nor_convert_3to4_read(u8 opcode)
 		{ SPINOR_OP_READ_1_2_2,	SPINOR_OP_READ_1_2_2_4B },
 		{ SPINOR_OP_READ_1_1_4,	SPINOR_OP_READ_1_1_4_4B },
 		{ SPINOR_OP_READ_1_4_4,	SPINOR_OP_READ_1_4_4_4B },
+		{ SPINOR_OP_READ_1_1_8,	SPINOR_OP_READ_1_1_8_4B },
 
 		{ SPINOR_OP_READ_1_1_1_DTR,	SPINOR_OP_READ_1_1_1_DTR_4B },
 		{ SPINOR_OP_READ_1_2_2_DTR,	SPINOR_OP_READ_1_2_2_DTR_4B },
@@ -284,14 +313,50 @@ static u8 spi_nor_convert_3to4_erase(u8 opcode)
 				      ARRAY_SIZE(spi_nor_3to4_erase));
 }
 
-static void spi_nor_set_4byte_opcodes(struct spi_nor *nor)
+/*
+ * Check whether the 4-byte Address Instruction Table of the flash lists a
+ * 4-byte op code for each of the selected read, program and erase op codes.
+ */
+static bool spi_nor_has_4bait_opcodes(struct spi_nor *nor,
+				      const struct spi_nor_flash_parameter *params)
+{
+	const u8 opcodes[] = {
+		nor->read_opcode, nor->program_opcode, nor->erase_opcode,
+	};
+	unsigned int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(opcodes); i++) {
+		for (j = 0; j < params->num_opcodes_4b; j++)
+			if (params->opcodes_4b[j][0] == opcodes[i])
+				break;
+		if (j == params->num_opcodes_4b)
+			return false;
+	}
+
+	return true;
+}
+
+static void spi_nor_set_4byte_opcodes(struct spi_nor *nor,
+				      const struct spi_nor_flash_parameter *params)
 {
+	if (spi_nor_has_4bait_opcodes(nor, params)) {
+		nor->read_opcode = spi_nor_convert_opcode(nor->read_opcode,
+				params->opcodes_4b, params->num_opcodes_4b);
+		nor->program_opcode = spi_nor_convert_opcode(nor->program_opcode,
+				params->opcodes_4b, params->num_opcodes_4b);
+		nor->erase_opcode = spi_nor_convert_opcode(nor->erase_opcode,
+				params->opcodes_4b, params->num_opcodes_4b);
+		return;
+	}
+
 	/* Do some manufacturer fixups first */
 	switch (JEDEC_MFR(nor->info)) {
 	case SNOR_MFR_SPANSION:
 		/* No small sector erase for 4-byte command set */
-		nor->erase_opcode = SPINOR_OP_SE;
-		nor->mtd->erasesize = nor->info->sector_size;
+		if (nor->info->sector_size) {
+			nor->erase_opcode = SPINOR_OP_SE;
+			nor->mtd->erasesize = nor->info->sector_size;
+		}
 		break;
 
 	default:
@@ -884,6 +949,41 @@ static const struct spi_device_id spi_nor_ids[] = {
 	{ },
 };
 
+struct spi_nor_generic {
+	struct spi_device_id	id;
+	struct flash_info	info;
+};
+
+/*
+ * Flashes missing from spi_nor_ids[] may still be usable if they implement
+ * SFDP: hand out a per-device entry carrying the JEDEC ID only, everything
+ * else is filled in by spi_nor_parse_sfdp().
+ */
+static const struct spi_device_id *spi_nor_generic_id(const u8 *id)
+{
+	struct spi_nor_generic *generic;
+
+	generic = xzalloc(sizeof(*generic));
+
+	memcpy(generic->info.id, id, 3);
+	generic->info.id_len = 3;
+	generic->info.page_size = 256;
+	generic->info.flags = SPI_NOR_GENERIC;
+
+	generic->id.name = "spi-nor-generic";
+	generic->id.driver_data = (unsigned long)&generic->info;
+
+	return &generic->id;
+}
+
+static void spi_nor_free_generic_id(const struct spi_device_id *id)
+{
+	const struct flash_info *info = (void *)id->driver_data;
+
+	if (info->flags & SPI_NOR_GENERIC)
+		free(container_of(id, struct spi_nor_generic, id));
+}
+
 static const struct spi_device_id *spi_nor_read_id(struct spi_nor *nor)
 {
 	int			tmp;
@@ -903,9 +1003,9 @@ static const struct spi_device_id *spi_nor_read_id(struct spi_nor *nor)
 				return &spi_nor_ids[tmp];
 		}
 	}
-	dev_err(nor->dev, "unrecognized JEDEC id bytes: %02x, %2x, %2x\n",
+	dev_dbg(nor->dev, "unrecognized JEDEC id bytes: %02x, %2x, %2x\n",
 		id[0], id[1], id[2]);
-	return ERR_PTR(-ENODEV);
+	return spi_nor_generic_id(id);
 }
 
 static int spi_nor_read(struct mtd_info *mtd, loff_t from, size_t len,
@@ -1114,6 +1214,606 @@ spi_nor_set_pp_settings(struct spi_nor_pp_command *pp,
 	pp->proto = proto;
 }
 
+static int spi_nor_hwcaps2cmd(u32 hwcaps, const int table[][2], size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		if (table[i][0] == (int)hwcaps)
+			return table[i][1];
+
+	return -EINVAL;
+}
+
+static int spi_nor_hwcaps_read2cmd(u32 hwcaps)
+{
+	static const int hwcaps_read2cmd[][2] = {
+		{ SNOR_HWCAPS_READ,		SNOR_CMD_READ },
+		{ SNOR_HWCAPS_READ_FAST,	SNOR_CMD_READ_FAST },
+		{ SNOR_HWCAPS_READ_1_1_2,	SNOR_CMD_READ_1_1_2 },
+		{ SNOR_HWCAPS_READ_1_2_2,	SNOR_CMD_READ_1_2_2 },
+		{ SNOR_HWCAPS_READ_2_2_2,	SNOR_CMD_READ_2_2_2 },
+		{ SNOR_HWCAPS_READ_1_1_4,	SNOR_CMD_READ_1_1_4 },
+		{ SNOR_HWCAPS_READ_1_4_4,	SNOR_CMD_READ_1_4_4 },
+		{ SNOR_HWCAPS_READ_4_4_4,	SNOR_CMD_READ_4_4_4 },
+		{ SNOR_HWCAPS_READ_1_1_8,	SNOR_CMD_READ_1_1_8 },
+	};
+
+	return spi_nor_hwcaps2cmd(hwcaps, hwcaps_read2cmd,
+				  ARRAY_SIZE(hwcaps_read2cmd));
+}
+
+static int spi_nor_hwcaps_pp2cmd(u32 hwcaps)
+{
+	static const int hwcaps_pp2cmd[][2] = {
+		{ SNOR_HWCAPS_PP,		SNOR_CMD_PP },
+		{ SNOR_HWCAPS_PP_1_1_4,		SNOR_CMD_PP_1_1_4 },
+		{ SNOR_HWCAPS_PP_1_4_4,		SNOR_CMD_PP_1_4_4 },
+		{ SNOR_HWCAPS_PP_4_4_4,		SNOR_CMD_PP_4_4_4 },
+	};
+
+	return spi_nor_hwcaps2cmd(hwcaps, hwcaps_pp2cmd,
+				  ARRAY_SIZE(hwcaps_pp2cmd));
+}
+
+static int macronix_quad_enable(struct spi_nor *nor)
+{
+	int ret, val;
+
+	val = read_sr(nor);
+	if (val < 0)
+		return val;
+	if (val & SR_QUAD_EN_MX)
+		return 0;
+
+	write_enable(nor);
+	write_sr(nor, val | SR_QUAD_EN_MX);
+
+	ret = spi_nor_wait_till_ready(nor);
+	if (ret)
+		return ret;
+
+	/* read back and check it */
+	ret = read_sr(nor);
+	if (!(ret > 0 && (ret & SR_QUAD_EN_MX))) {
+		dev_err(nor->dev, "Macronix Quad bit not set\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int sr2_bit7_quad_enable(struct spi_nor *nor)
+{
+	u8 sr2;
+	int ret;
+
+	ret = nor->read_reg(nor, SPINOR_OP_RDSR2, &sr2, 1);
+	if (ret < 0)
+		return ret;
+	if (sr2 & SR2_QUAD_EN_BIT7)
+		return 0;
+
+	sr2 |= SR2_QUAD_EN_BIT7;
+	write_enable(nor);
+	ret = nor->write_reg(nor, SPINOR_OP_WRSR2, &sr2, 1);
+	if (ret < 0)
+		return ret;
+
+	ret = spi_nor_wait_till_ready(nor);
+	if (ret)
+		return ret;
+
+	/* read back and check it */
+	ret = nor->read_reg(nor, SPINOR_OP_RDSR2, &sr2, 1);
+	if (ret < 0 || !(sr2 & SR2_QUAD_EN_BIT7)) {
+		dev_err(nor->dev, "SR2 Quad bit not set\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Serial Flash Discoverable Parameters (SFDP) parsing, see JEDEC JESD216.
+ */
+
+#define SFDP_SIGNATURE		0x50444653U	/* "SFDP" */
+#define SFDP_JESD216_MAJOR	1
+
+#define SFDP_BFPT_ID		0xff00	/* Basic Flash Parameter Table */
+#define SFDP_4BAIT_ID		0xff84	/* 4-byte Address Instruction Table */
+
+struct sfdp_parameter_header {
+	u8		id_lsb;
+	u8		minor;
+	u8		major;
+	u8		length; /* in double words */
+	u8		parameter_table_pointer[3]; /* byte address */
+	u8		id_msb;
+};
+
+#define SFDP_PARAM_HEADER_ID(p)	(((p)->id_msb << 8) | (p)->id_lsb)
+#define SFDP_PARAM_HEADER_PTP(p) \
+	(((p)->parameter_table_pointer[2] << 16) | \
+	 ((p)->parameter_table_pointer[1] <<  8) | \
+	 ((p)->parameter_table_pointer[0] <<  0))
+
+struct sfdp_header {
+	u32		signature; /* Ox50444653U <=> "SFDP" */
+	u8		minor;
+	u8		major;
+	u8		nph; /* 0-base number of parameter headers */
+	u8		unused;
+
+	/* Basic Flash Parameter Table. */
+	struct sfdp_parameter_header	bfpt_header;
+};
+
+/* Basic Flash Parameter Table */
+
+/* JESD216 rev 0 defines 9 DWORDs, rev A 16 and rev C 20. */
+#define BFPT_DWORD(i)		((i) - 1)
+#define BFPT_DWORD_MAX		20
+#define BFPT_DWORD_MAX_JESD216	9
+
+/* 1st DWORD. */
+#define BFPT_DWORD1_FAST_READ_1_1_2		BIT(16)
+#define BFPT_DWORD1_ADDRESS_BYTES_MASK		GENMASK(18, 17)
+#define BFPT_DWORD1_ADDRESS_BYTES_4_ONLY	(0x2UL << 17)
+#define BFPT_DWORD1_FAST_READ_1_2_2		BIT(20)
+#define BFPT_DWORD1_FAST_READ_1_4_4		BIT(21)
+#define BFPT_DWORD1_FAST_READ_1_1_4		BIT(22)
+
+/* 5th DWORD. */
+#define BFPT_DWORD5_FAST_READ_2_2_2		BIT(0)
+#define BFPT_DWORD5_FAST_READ_4_4_4		BIT(4)
+
+/* 11th DWORD. */
+#define BFPT_DWORD11_PAGE_SIZE_SHIFT		4
+#define BFPT_DWORD11_PAGE_SIZE_MASK		GENMASK(7, 4)
+
+/* 15th DWORD. */
+#define BFPT_DWORD15_QER_MASK			GENMASK(22, 20)
+#define BFPT_DWORD15_QER_NONE			(0x0UL << 20) /* Micron */
+#define BFPT_DWORD15_QER_SR2_BIT1_BUGGY		(0x1UL << 20)
+#define BFPT_DWORD15_QER_SR1_BIT6		(0x2UL << 20) /* Macronix */
+#define BFPT_DWORD15_QER_SR2_BIT7		(0x3UL << 20)
+#define BFPT_DWORD15_QER_SR2_BIT1_NO_RD		(0x4UL << 20)
+#define BFPT_DWORD15_QER_SR2_BIT1		(0x5UL << 20) /* Spansion */
+
+struct sfdp_bfpt {
+	u32	dwords[BFPT_DWORD_MAX];
+};
+
+/* Fast Read settings. */
+
+static void
+spi_nor_set_read_settings_from_bfpt(struct spi_nor_read_command *read,
+				    u16 half,
+				    enum spi_nor_protocol proto)
+{
+	/* Each half-word is [15:8] op code, [7:5] mode clocks, [4:0] waits */
+	read->num_mode_clocks = (half >> 5) & 0x07;
+	read->num_wait_states = (half >> 0) & 0x1f;
+	read->opcode = (half >> 8) & 0xff;
+	read->proto = proto;
+}
+
+struct sfdp_bfpt_read {
+	/* The Fast Read x-y-z hardware capability in params->hwcaps.mask. */
+	u32			hwcaps;
+
+	/*
+	 * The <supported_bit> bit in <supported_dword> BFPT DWORD tells us
+	 * whether the Fast Read x-y-z command is supported.
+	 */
+	u32			supported_dword;
+	u32			supported_bit;
+
+	/*
+	 * The half-word at offset <setting_shift> in <setting_dword> BFPT DWORD
+	 * encodes the op code, the number of mode clocks and the number of wait
+	 * states to be used by Fast Read x-y-z command.
+	 */
+	u32			settings_dword;
+	u32			settings_shift;
+
+	/* The SPI protocol for this Fast Read x-y-z command. */
+	enum spi_nor_protocol	proto;
+};
+
+static const struct sfdp_bfpt_read sfdp_bfpt_reads[] = {
+	/* Fast Read 1-1-2 */
+	{
+		SNOR_HWCAPS_READ_1_1_2,
+		BFPT_DWORD(1), BFPT_DWORD1_FAST_READ_1_1_2,	/* Supported bit */
+		BFPT_DWORD(4), 0,	/* Settings */
+		SNOR_PROTO_1_1_2,
+	},
+
+	/* Fast Read 1-2-2 */
+	{
+		SNOR_HWCAPS_READ_1_2_2,
+		BFPT_DWORD(1), BFPT_DWORD1_FAST_READ_1_2_2,	/* Supported bit */
+		BFPT_DWORD(4), 16,	/* Settings */
+		SNOR_PROTO_1_2_2,
+	},
+
+	/* Fast Read 2-2-2 */
+	{
+		SNOR_HWCAPS_READ_2_2_2,
+		BFPT_DWORD(5), BFPT_DWORD5_FAST_READ_2_2_2,	/* Supported bit */
+		BFPT_DWORD(6), 16,	/* Settings */
+		SNOR_PROTO_2_2_2,
+	},
+
+	/* Fast Read 1-1-4 */
+	{
+		SNOR_HWCAPS_READ_1_1_4,
+		BFPT_DWORD(1), BFPT_DWORD1_FAST_READ_1_1_4,	/* Supported bit */
+		BFPT_DWORD(3), 16,	/* Settings */
+		SNOR_PROTO_1_1_4,
+	},
+
+	/* Fast Read 1-4-4 */
+	{
+		SNOR_HWCAPS_READ_1_4_4,
+		BFPT_DWORD(1), BFPT_DWORD1_FAST_READ_1_4_4,	/* Supported bit */
+		BFPT_DWORD(3), 0,	/* Settings */
+		SNOR_PROTO_1_4_4,
+	},
+
+	/* Fast Read 4-4-4 */
+	{
+		SNOR_HWCAPS_READ_4_4_4,
+		BFPT_DWORD(5), BFPT_DWORD5_FAST_READ_4_4_4,	/* Supported bit */
+		BFPT_DWORD(7), 16,	/* Settings */
+		SNOR_PROTO_4_4_4,
+	},
+};
+
+/*
+ * Read SFDP data with the RDSFDP command: 1-1-1 protocol, 3-byte address
+ * and 8 dummy cycles, whatever the flash is configured to use afterwards.
+ */
+static int spi_nor_read_sfdp(struct spi_nor *nor, u32 addr,
+			     size_t len, void *buf)
+{
+	u8 addr_width, read_opcode, read_dummy;
+	enum spi_nor_protocol read_proto;
+	size_t retlen;
+	u8 *ptr = buf;
+	int ret;
+
+	read_opcode = nor->read_opcode;
+	addr_width = nor->addr_width;
+	read_dummy = nor->read_dummy;
+	read_proto = nor->read_proto;
+
+	nor->read_opcode = SPINOR_OP_RDSFDP;
+	nor->addr_width = 3;
+	nor->read_dummy = 8;
+	nor->read_proto = SNOR_PROTO_1_1_1;
+
+	while (len) {
+		retlen = 0;
+		ret = nor->read(nor, addr, len, &retlen, ptr);
+		if (ret < 0)
+			goto out;
+		if (!retlen || retlen > len) {
+			ret = -EIO;
+			goto out;
+		}
+
+		ptr += retlen;
+		addr += retlen;
+		len -= retlen;
+	}
+	ret = 0;
+
+out:
+	nor->read_opcode = read_opcode;
+	nor->addr_width = addr_width;
+	nor->read_dummy = read_dummy;
+	nor->read_proto = read_proto;
+
+	return ret;
+}
+
+static int spi_nor_parse_bfpt(struct spi_nor *nor,
+			      const struct sfdp_parameter_header *bfpt_header,
+			      struct spi_nor_flash_parameter *params)
+{
+	struct sfdp_bfpt bfpt;
+	size_t len;
+	int i, err;
+	u32 addr;
+	u16 half;
+
+	/* JESD216 Basic Flash Parameter Table length is at least 9 DWORDs. */
+	if (bfpt_header->length < BFPT_DWORD_MAX_JESD216)
+		return -EINVAL;
+
+	/* Read the Basic Flash Parameter Table. */
+	len = min_t(size_t, sizeof(bfpt),
+		    bfpt_header->length * sizeof(u32));
+	addr = SFDP_PARAM_HEADER_PTP(bfpt_header);
+	memset(&bfpt, 0, sizeof(bfpt));
+	err = spi_nor_read_sfdp(nor, addr, len, &bfpt);
+	if (err < 0)
+		return err;
+
+	/* Fix endianness of the BFPT DWORDs. */
+	for (i = 0; i < BFPT_DWORD_MAX; i++)
+		bfpt.dwords[i] = le32_to_cpu(bfpt.dwords[i]);
+
+	/* Flash Memory Density (in bits). */
+	params->size = bfpt.dwords[BFPT_DWORD(2)];
+	if (params->size & BIT(31)) {
+		params->size &= ~BIT(31);
+
+		/*
+		 * Prevent overflows on params->size. Anyway, a NOR of 2^64
+		 * bits is unlikely to exist so this error probably means
+		 * the BFPT we are reading is corrupted/wrong.
+		 */
+		if (params->size > 63)
+			return -EINVAL;
+
+		params->size = 1ULL << params->size;
+	} else {
+		params->size++;
+	}
+	params->size >>= 3; /* Convert to bytes. */
+
+	if ((bfpt.dwords[BFPT_DWORD(1)] & BFPT_DWORD1_ADDRESS_BYTES_MASK) ==
+	    BFPT_DWORD1_ADDRESS_BYTES_4_ONLY)
+		params->addr_width = 4;
+
+	/* Fast Read settings. */
+	for (i = 0; i < ARRAY_SIZE(sfdp_bfpt_reads); i++) {
+		const struct sfdp_bfpt_read *rd = &sfdp_bfpt_reads[i];
+		struct spi_nor_read_command *read;
+
+		if (!(bfpt.dwords[rd->supported_dword] & rd->supported_bit)) {
+			params->hwcaps.mask &= ~rd->hwcaps;
+			continue;
+		}
+
+		params->hwcaps.mask |= rd->hwcaps;
+		read = &params->reads[spi_nor_hwcaps_read2cmd(rd->hwcaps)];
+		half = bfpt.dwords[rd->settings_dword] >> rd->settings_shift;
+		spi_nor_set_read_settings_from_bfpt(read, half, rd->proto);
+	}
+
+	/*
+	 * Fast Read 1-1-8 (JESD216C): there is no supported bit, a non-zero
+	 * op code in the upper half of the 17th DWORD means it is supported.
+	 */
+	half = bfpt.dwords[BFPT_DWORD(17)] >> 16;
+	if (half >> 8) {
+		params->hwcaps.mask |= SNOR_HWCAPS_READ_1_1_8;
+		spi_nor_set_read_settings_from_bfpt(
+				&params->reads[SNOR_CMD_READ_1_1_8],
+				half, SNOR_PROTO_1_1_8);
+	}
+
+	/* Sector Erase Types: 8th and 9th DWORDs, size as a power of two. */
+	memset(params->erase_types, 0, sizeof(params->erase_types));
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		u32 dword = bfpt.dwords[BFPT_DWORD(8) + i / 2];
+		u16 erase = dword >> (16 * (i % 2));
+		u8 shift = erase & 0xff;
+
+		if (!shift || shift > 31)
+			continue;
+
+		params->erase_types[i].size = 1U << shift;
+		params->erase_types[i].opcode = erase >> 8;
+	}
+
+	/* Stop here if not JESD216 rev A or later. */
+	if (bfpt_header->length < 16)
+		return 0;
+
+	/* Page size: this field specifies 'N' so the page size = 2^N bytes. */
+	params->page_size = 1U << ((bfpt.dwords[BFPT_DWORD(11)] &
+				    BFPT_DWORD11_PAGE_SIZE_MASK) >>
+				   BFPT_DWORD11_PAGE_SIZE_SHIFT);
+
+	/* Quad Enable Requirements. */
+	switch (bfpt.dwords[BFPT_DWORD(15)] & BFPT_DWORD15_QER_MASK) {
+	case BFPT_DWORD15_QER_NONE:
+		params->quad_enable = NULL;
+		break;
+
+	case BFPT_DWORD15_QER_SR2_BIT1_BUGGY:
+	case BFPT_DWORD15_QER_SR2_BIT1_NO_RD:
+	case BFPT_DWORD15_QER_SR2_BIT1:
+		params->quad_enable = spansion_quad_enable;
+		break;
+
+	case BFPT_DWORD15_QER_SR1_BIT6:
+		params->quad_enable = macronix_quad_enable;
+		break;
+
+	case BFPT_DWORD15_QER_SR2_BIT7:
+		params->quad_enable = sr2_bit7_quad_enable;
+		break;
+
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* 4-byte Address Instruction Table: 1st DWORD bit to op code pair. */
+static const u8 sfdp_4bait_opcodes[][3] = {
+	{ 0,	SPINOR_OP_READ,		SPINOR_OP_READ_4B },
+	{ 1,	SPINOR_OP_READ_FAST,	SPINOR_OP_READ_FAST_4B },
+	{ 2,	SPINOR_OP_READ_1_1_2,	SPINOR_OP_READ_1_1_2_4B },
+	{ 3,	SPINOR_OP_READ_1_2_2,	SPINOR_OP_READ_1_2_2_4B },
+	{ 4,	SPINOR_OP_READ_1_1_4,	SPINOR_OP_READ_1_1_4_4B },
+	{ 5,	SPINOR_OP_READ_1_4_4,	SPINOR_OP_READ_1_4_4_4B },
+	{ 6,	SPINOR_OP_PP,		SPINOR_OP_PP_4B },
+	{ 7,	SPINOR_OP_PP_1_1_4,	SPINOR_OP_PP_1_1_4_4B },
+	{ 8,	SPINOR_OP_PP_1_4_4,	SPINOR_OP_PP_1_4_4_4B },
+	{ 20,	SPINOR_OP_READ_1_1_8,	SPINOR_OP_READ_1_1_8_4B },
+};
+
+/* Bits 9 to 12 of the 1st DWORD flag support for erase types 1 to 4. */
+#define SFDP_4BAIT_ERASE_TYPE_SHIFT	9
+
+static void spi_nor_add_4b_opcode(struct spi_nor_flash_parameter *params,
+				  u8 opcode, u8 opcode_4b)
+{
+	if (params->num_opcodes_4b == SNOR_4B_OPCODES_MAX)
+		return;
+
+	params->opcodes_4b[params->num_opcodes_4b][0] = opcode;
+	params->opcodes_4b[params->num_opcodes_4b][1] = opcode_4b;
+	params->num_opcodes_4b++;
+}
+
+static int spi_nor_parse_4bait(struct spi_nor *nor,
+			       const struct sfdp_parameter_header *param_header,
+			       struct spi_nor_flash_parameter *params)
+{
+	__le32 dwords[2];
+	u32 dword1, dword2;
+	int i, err;
+
+	if (param_header->major != SFDP_JESD216_MAJOR ||
+	    param_header->length < ARRAY_SIZE(dwords))
+		return -EINVAL;
+
+	err = spi_nor_read_sfdp(nor, SFDP_PARAM_HEADER_PTP(param_header),
+				sizeof(dwords), dwords);
+	if (err < 0)
+		return err;
+
+	dword1 = le32_to_cpu(dwords[0]);
+	dword2 = le32_to_cpu(dwords[1]);
+
+	params->num_opcodes_4b = 0;
+
+	for (i = 0; i < ARRAY_SIZE(sfdp_4bait_opcodes); i++)
+		if (dword1 & BIT(sfdp_4bait_opcodes[i][0]))
+			spi_nor_add_4b_opcode(params, sfdp_4bait_opcodes[i][1],
+					      sfdp_4bait_opcodes[i][2]);
+
+	/* The 2nd DWORD holds the 4-byte op code of each erase type. */
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		const struct spi_nor_erase_type *erase = &params->erase_types[i];
+
+		if (!erase->size ||
+		    !(dword1 & BIT(SFDP_4BAIT_ERASE_TYPE_SHIFT + i)))
+			continue;
+
+		spi_nor_add_4b_opcode(params, erase->opcode,
+				      (dword2 >> (8 * i)) & 0xff);
+	}
+
+	return 0;
+}
+
+/**
+ * spi_nor_parse_sfdp() - parse the Serial Flash Discoverable Parameters.
+ * @nor:	pointer to a 'struct spi_nor'
+ * @params:	pointer to the 'struct spi_nor_flash_parameter' to be filled
+ *
+ * The Basic Flash Parameter Table is the main and only mandatory table as
+ * defined by the SFDP (JESD216) specification. It provides the memory size,
+ * the fast read settings, the erase types and the Quad Enable requirements.
+ * The optional 4-byte Address Instruction Table tells which dedicated 4-byte
+ * address op codes the flash implements.
+ *
+ * Return: 0 on success, -errno otherwise.
+ */
+static int spi_nor_parse_sfdp(struct spi_nor *nor,
+			      struct spi_nor_flash_parameter *params)
+{
+	const struct sfdp_parameter_header *param_header, *bfpt_header;
+	struct sfdp_parameter_header *param_headers = NULL;
+	struct sfdp_header header;
+	size_t psize;
+	int i, err;
+
+	/* Get the SFDP header. */
+	err = spi_nor_read_sfdp(nor, 0, sizeof(header), &header);
+	if (err < 0)
+		return err;
+
+	/* Check the SFDP header version. */
+	if (le32_to_cpu(header.signature) != SFDP_SIGNATURE ||
+	    header.major != SFDP_JESD216_MAJOR)
+		return -EINVAL;
+
+	/*
+	 * Verify that the first and only mandatory parameter header is a
+	 * Basic Flash Parameter Table header as specified in JESD216.
+	 */
+	bfpt_header = &header.bfpt_header;
+	if (SFDP_PARAM_HEADER_ID(bfpt_header) != SFDP_BFPT_ID ||
+	    bfpt_header->major != SFDP_JESD216_MAJOR)
+		return -EINVAL;
+
+	/* Read the optional parameter headers. */
+	if (header.nph) {
+		psize = header.nph * sizeof(*param_headers);
+
+		param_headers = kmalloc(psize, GFP_KERNEL);
+		if (!param_headers)
+			return -ENOMEM;
+
+		err = spi_nor_read_sfdp(nor, sizeof(header),
+					psize, param_headers);
+		if (err < 0) {
+			dev_err(nor->dev,
+				"failed to read SFDP parameter headers\n");
+			goto exit;
+		}
+	}
+
+	/*
+	 * Check other parameter headers to get the latest revision of
+	 * the basic flash parameter table.
+	 */
+	for (i = 0; i < header.nph; i++) {
+		param_header = &param_headers[i];
+
+		if (SFDP_PARAM_HEADER_ID(param_header) == SFDP_BFPT_ID &&
+		    param_header->major == SFDP_JESD216_MAJOR &&
+		    (param_header->minor > bfpt_header->minor ||
+		     (param_header->minor == bfpt_header->minor &&
+		      param_header->length > bfpt_header->length)))
+			bfpt_header = param_header;
+	}
+
+	err = spi_nor_parse_bfpt(nor, bfpt_header, params);
+	if (err)
+		goto exit;
+
+	/* Parse other parameter headers. */
+	for (i = 0; i < header.nph; i++) {
+		param_header = &param_headers[i];
+
+		if (SFDP_PARAM_HEADER_ID(param_header) != SFDP_4BAIT_ID)
+			continue;
+
+		/* The 4BAIT is optional, ignore a broken one. */
+		if (spi_nor_parse_4bait(nor, param_header, params))
+			dev_warn(nor->dev,
+				 "failed to parse 4-byte address instruction table\n");
+	}
+
+exit:
+	kfree(param_headers);
+	return err;
+}
+
 static int spi_nor_unlock_global_block_protection(struct spi_nor *nor)
 {
 	int ret;
@@ -1163,6 +1863,13 @@ static int spi_nor_init_params(struct spi_nor *nor,
 					  SNOR_PROTO_1_1_4);
 	}
 
+	if (info->flags & SPI_NOR_OCTAL_READ) {
+		params->hwcaps.mask |= SNOR_HWCAPS_READ_1_1_8;
+		spi_nor_set_read_settings(&params->reads[SNOR_CMD_READ_1_1_8],
+					  0, 8, SPINOR_OP_READ_1_1_8,
+					  SNOR_PROTO_1_1_8);
+	}
+
 	/* Page Program settings. */
 	params->hwcaps.mask |= SNOR_HWCAPS_PP;
 	spi_nor_set_pp_settings(&params->page_programs[SNOR_CMD_PP],
@@ -1191,48 +1898,26 @@ static int spi_nor_init_params(struct spi_nor *nor,
 				   SNOR_HWCAPS_PP_QUAD))
 		params->quad_enable = spansion_quad_enable;
 
-	return 0;
-}
-
-static int spi_nor_hwcaps2cmd(u32 hwcaps, const int table[][2], size_t size)
-{
-	size_t i;
-
-	for (i = 0; i < size; i++)
-		if (table[i][0] == (int)hwcaps)
-			return table[i][1];
-
-	return -EINVAL;
-}
-
-static int spi_nor_hwcaps_read2cmd(u32 hwcaps)
-{
-	static const int hwcaps_read2cmd[][2] = {
-		{ SNOR_HWCAPS_READ,		SNOR_CMD_READ },
-		{ SNOR_HWCAPS_READ_FAST,	SNOR_CMD_READ_FAST },
-		{ SNOR_HWCAPS_READ_1_1_2,	SNOR_CMD_READ_1_1_2 },
-		{ SNOR_HWCAPS_READ_1_2_2,	SNOR_CMD_READ_1_2_2 },
-		{ SNOR_HWCAPS_READ_2_2_2,	SNOR_CMD_READ_2_2_2 },
-		{ SNOR_HWCAPS_READ_1_1_4,	SNOR_CMD_READ_1_1_4 },
-		{ SNOR_HWCAPS_READ_1_4_4,	SNOR_CMD_READ_1_4_4 },
-		{ SNOR_HWCAPS_READ_4_4_4,	SNOR_CMD_READ_4_4_4 },
-	};
-
-	return spi_nor_hwcaps2cmd(hwcaps, hwcaps_read2cmd,
-				  ARRAY_SIZE(hwcaps_read2cmd));
-}
+	/*
+	 * Override the legacy parameters with the SFDP ones for flashes that
+	 * are unknown or explicitly ask for it. The tables of known flashes
+	 * are not trusted by default, as some of them are known to be broken.
+	 * Keep the legacy parameters if the SFDP tables turn out to be broken.
+	 */
+	if ((info->flags & (SPI_NOR_GENERIC | SPI_NOR_PARSE_SFDP)) &&
+	    !(info->flags & SPI_NOR_SKIP_SFDP)) {
+		struct spi_nor_flash_parameter sfdp_params;
+		int err;
 
-static int spi_nor_hwcaps_pp2cmd(u32 hwcaps)
-{
-	static const int hwcaps_pp2cmd[][2] = {
-		{ SNOR_HWCAPS_PP,		SNOR_CMD_PP },
-		{ SNOR_HWCAPS_PP_1_1_4,		SNOR_CMD_PP_1_1_4 },
-		{ SNOR_HWCAPS_PP_1_4_4,		SNOR_CMD_PP_1_4_4 },
-		{ SNOR_HWCAPS_PP_4_4_4,		SNOR_CMD_PP_4_4_4 },
-	};
+		memcpy(&sfdp_params, params, sizeof(sfdp_params));
+		err = spi_nor_parse_sfdp(nor, &sfdp_params);
+		if (!err)
+			memcpy(params, &sfdp_params, sizeof(*params));
+		else if (info->flags & SPI_NOR_GENERIC)
+			return err;
+	}
 
-	return spi_nor_hwcaps2cmd(hwcaps, hwcaps_pp2cmd,
-				  ARRAY_SIZE(hwcaps_pp2cmd));
+	return 0;
 }
 
 static int spi_nor_select_read(struct spi_nor *nor,
@@ -1287,11 +1972,50 @@ static int spi_nor_select_pp(struct spi_nor *nor,
 	return 0;
 }
 
+/*
+ * Pick an erase type announced by SFDP: the 4KiB one if small sectors are
+ * preferred, the largest one otherwise.
+ */
+static int spi_nor_select_sfdp_erase(struct spi_nor *nor,
+				     const struct spi_nor_flash_parameter *params)
+{
+	const struct spi_nor_erase_type *erase = NULL;
+	struct mtd_info *mtd = nor->mtd;
+	int i;
+
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		const struct spi_nor_erase_type *type = &params->erase_types[i];
+
+		if (!type->size)
+			continue;
+
+		if (IS_ENABLED(CONFIG_MTD_SPI_NOR_USE_4K_SECTORS) &&
+		    type->size == SZ_4K) {
+			erase = type;
+			break;
+		}
+
+		if (!erase || type->size > erase->size)
+			erase = type;
+	}
+
+	if (!erase)
+		return -EINVAL;
+
+	nor->erase_opcode = erase->opcode;
+	mtd->erasesize = erase->size;
+	return 0;
+}
+
 static int spi_nor_select_erase(struct spi_nor *nor,
-				const struct flash_info *info)
+				const struct flash_info *info,
+				const struct spi_nor_flash_parameter *params)
 {
 	struct mtd_info *mtd = nor->mtd;
 
+	if (info->flags & SPI_NOR_GENERIC)
+		return spi_nor_select_sfdp_erase(nor, params);
+
 #ifdef CONFIG_MTD_SPI_NOR_USE_4K_SECTORS
 	/* prefer "small sector" erase if possible */
 	if (info->flags & SECT_4K) {
@@ -1350,7 +2074,7 @@ static int spi_nor_setup(struct spi_nor *nor, const struct flash_info *info,
 	}
 
 	/* Select the Sector Erase command. */
-	err = spi_nor_select_erase(nor, info);
+	err = spi_nor_select_erase(nor, info, params);
 	if (err) {
 		dev_err(nor->dev,
 			"can't select erase settings supported by both the SPI controller and memory.\n");
@@ -1413,6 +2137,12 @@ int spi_nor_scan(struct spi_nor *nor, const char *name,
 		jid = spi_nor_read_id(nor);
 		if (IS_ERR(jid)) {
 			return PTR_ERR(jid);
+		} else if (((struct flash_info *)jid->driver_data)->flags &
+			   SPI_NOR_GENERIC) {
+			dev_err(dev, "unrecognized JEDEC id, expected %s\n",
+				id->name);
+			spi_nor_free_generic_id(jid);
+			return -ENODEV;
 		} else if (jid != id) {
 			/*
 			 * JEDEC knows better, so overwrite platform ID. We
@@ -1446,8 +2176,17 @@ int spi_nor_scan(struct spi_nor *nor, const char *name,
 
 	/* Parse the Serial Flash Discoverable Parameters table. */
 	ret = spi_nor_init_params(nor, info, &params);
-	if (ret)
+	if (ret) {
+		if (info->flags & SPI_NOR_GENERIC) {
+			dev_err(dev,
+				"unrecognized JEDEC id bytes: %02x, %2x, %2x\n",
+				info->id[0], info->id[1], info->id[2]);
+			nor->info = NULL;
+			spi_nor_free_generic_id(id);
+			return -ENOENT;
+		}
 		return ret;
+	}
 
 	if (!mtd->name)
 		mtd->name = (char *) dev_name(dev);
@@ -1503,7 +2242,7 @@ int spi_nor_scan(struct spi_nor *nor, const char *name,
 	 */
 	ret = spi_nor_setup(nor, info, &params, hwcaps);
 	if (ret)
-		return ret;
+		goto err_free_id;
 
 	if (info->addr_width)
 		nor->addr_width = info->addr_width;
@@ -1511,9 +2250,10 @@ int spi_nor_scan(struct spi_nor *nor, const char *name,
 		/* enable 4-byte addressing if the device exceeds 16MiB */
 		nor->addr_width = 4;
 		if (JEDEC_MFR(info) == SNOR_MFR_SPANSION ||
-	 	    info->flags & SPI_NOR_4B_OPCODES)
-			spi_nor_set_4byte_opcodes(nor);
-		else
+		    info->flags & SPI_NOR_4B_OPCODES ||
+		    spi_nor_has_4bait_opcodes(nor, &params))
+			spi_nor_set_4byte_opcodes(nor, &params);
+		else if (params.addr_width != 4)
 			set_4byte(nor, info, 1);
 	} else {
 		nor->addr_width = 3;
@@ -1522,7 +2262,8 @@ int spi_nor_scan(struct spi_nor *nor, const char *name,
 	if (nor->addr_width > SPI_NOR_MAX_ADDR_WIDTH) {
 		dev_err(dev, "address width is too large: %u\n",
 			nor->addr_width);
-		return -EINVAL;
+		ret = -EINVAL;
+		goto err_free_id;
 	}
 
 	dev_info(dev, "%s (%lld Kbytes)\n", id->name,
@@ -1545,6 +2286,11 @@ int spi_nor_scan(struct spi_nor *nor, const char *name,
 				mtd->eraseregions[i].erasesize / 1024,
 				mtd->eraseregions[i].numblocks);
 	return 0;
+
+err_free_id:
+	nor->info = NULL;
+	spi_nor_free_generic_id(id);
+	return ret;
 }
 EXPORT_SYMBOL_GPL(spi_nor_scan);
 
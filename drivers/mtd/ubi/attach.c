@@ -72,6 +72,7 @@
 #include <linux/err.h>
 #include <linux/math64.h>
 #include <stdlib.h>
+#include <clock.h>
 #include "ubi.h"
 
 static int self_check_ai(struct ubi_device *ubi, struct ubi_attach_info *ai);
@@ -919,6 +920,57 @@ static bool vol_ignored(int vol_id)
 #endif
 }
 
+/**
+ * scan_read_hdrs - read the EC and the VID header of a PEB at once.
+ * @ubi: UBI device description object
+ * @ai: attaching information
+ * @pnum: the physical eraseblock number
+ * @ech: the EC header is returned here
+ * @vidh: the VID header is returned here
+ * @vid_err: the result of checking the VID header is returned here
+ *
+ * During a full scan both headers are needed for nearly every PEB, so read the
+ * whole area up to the data offset with a single read instead of two. When
+ * both headers share a NAND page, that page is only read once. Otherwise the
+ * read spans consecutive full pages, which lets the NAND layer use a
+ * continuous read.
+ *
+ * Returns the result of checking the EC header, see 'ubi_io_read_ec_hdr()'.
+ */
+static int scan_read_hdrs(struct ubi_device *ubi, struct ubi_attach_info *ai,
+			  int pnum, struct ubi_ec_hdr **ech,
+			  struct ubi_vid_hdr **vidh, int *vid_err)
+{
+	int read_err;
+
+	read_err = ubi_io_read(ubi, ai->hdrs_buf, pnum, 0, ubi->leb_start);
+	if (mtd_is_eccerr(read_err)) {
+		/*
+		 * The ECC error may be in the area of one header only. Read
+		 * them separately again so that it's attributed correctly.
+		 */
+		*ech = ai->ech;
+		*vidh = ubi_get_vid_hdr(ai->vidb);
+
+		read_err = ubi_io_read_ec_hdr(ubi, pnum, *ech, 0);
+		if (read_err < 0)
+			return read_err;
+
+		*vid_err = ubi_io_read_vid_hdr(ubi, pnum, ai->vidb, 0);
+
+		return read_err;
+	}
+
+	if (read_err && read_err != UBI_IO_BITFLIPS)
+		return read_err;
+
+	*ech = ai->hdrs_buf;
+	*vidh = ai->hdrs_buf + ubi->vid_hdr_offset;
+	*vid_err = ubi_io_check_vid_hdr(ubi, pnum, *vidh, read_err, 0);
+
+	return ubi_io_check_ec_hdr(ubi, pnum, *ech, read_err, 0);
+}
+
 /**
  * scan_peb - scan and process UBI headers of a PEB.
  * @ubi: UBI device description object
@@ -938,7 +990,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	struct ubi_vid_io_buf *vidb = ai->vidb;
 	struct ubi_vid_hdr *vidh = ubi_get_vid_hdr(vidb);
 	long long ec;
-	int err, bitflips = 0, vol_id = -1, ec_err = 0;
+	int err, bitflips = 0, vol_id = -1, ec_err = 0, vid_err = 0;
 
 	dbg_bld("scan PEB %d", pnum);
 
@@ -951,7 +1003,10 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		return 0;
 	}
 
-	err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
+	if (ai->hdrs_buf)
+		err = scan_read_hdrs(ubi, ai, pnum, &ech, &vidh, &vid_err);
+	else
+		err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -1034,7 +1089,10 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	/* OK, we've done with the EC header, let's look at the VID header */
 
-	err = ubi_io_read_vid_hdr(ubi, pnum, vidb, 0);
+	if (ai->hdrs_buf)
+		err = vid_err;
+	else
+		err = ubi_io_read_vid_hdr(ubi, pnum, vidb, 0);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -1363,12 +1421,13 @@ static void destroy_ai(struct ubi_attach_info *ai)
  * of failure, an error code is returned.
  */
 static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
-		    int start)
+		    int start_pnum)
 {
 	int err, pnum;
 	struct rb_node *rb1, *rb2;
 	struct ubi_ainf_volume *av;
 	struct ubi_ainf_peb *aeb;
+	u64 start, ms;
 
 	err = -ENOMEM;
 
@@ -1380,14 +1439,23 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (!ai->vidb)
 		goto out_ech;
 
-	for (pnum = start; pnum < ubi->peb_count; pnum++) {
+	/* Not fatal, the headers are read separately without it */
+	ai->hdrs_buf = kmalloc(ubi->leb_start, GFP_KERNEL);
+
+	start = get_time_ns();
+
+	for (pnum = start_pnum; pnum < ubi->peb_count; pnum++) {
 		dbg_gen("process PEB %d", pnum);
 		err = scan_peb(ubi, ai, pnum, false);
 		if (err < 0)
 			goto out_vidh;
 	}
 
-	ubi_msg(ubi, "scanning is finished");
+	ms = div_u64(get_time_ns() - start, NSEC_PER_MSEC);
+
+	ubi_msg(ubi, "scanning is finished, %d PEBs in %llu ms (%llu PEBs/s)",
+		ubi->peb_count - start_pnum, ms,
+		div_u64((u64)(ubi->peb_count - start_pnum) * MSEC_PER_SEC, ms ?: 1));
 
 	/* Calculate mean erase counter */
 	if (ai->ec_count)
@@ -1424,12 +1492,16 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (err)
 		goto out_vidh;
 
+	kfree(ai->hdrs_buf);
+	ai->hdrs_buf = NULL;
 	ubi_free_vid_buf(ai->vidb);
 	kfree(ai->ech);
 
 	return 0;
 
 out_vidh:
+	kfree(ai->hdrs_buf);
+	ai->hdrs_buf = NULL;
 	ubi_free_vid_buf(ai->vidb);
 out_ech:
 	kfree(ai->ech);
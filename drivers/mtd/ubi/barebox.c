@@ -20,42 +20,31 @@ static ssize_t ubi_volume_cdev_read(struct cdev *cdev, void *buf, size_t size,
 	struct ubi_volume_cdev_priv *priv = cdev->priv;
 	struct ubi_volume *vol = priv->vol;
 	struct ubi_device *ubi = priv->ubi;
-	int err, lnum, off, len;
-	size_t count_save = size;
+	int err, lnum, off;
 	unsigned long long tmp;
-	loff_t offp = offset;
-	int usable_leb_size = vol->usable_leb_size;
 
 	ubi_debug("%s: %zd @ 0x%08llx", __func__, size, offset);
 
-	len = size > usable_leb_size ? usable_leb_size : size;
+	if (!size)
+		return 0;
 
-	tmp = offp;
-	off = do_div(tmp, usable_leb_size);
+	tmp = offset;
+	off = do_div(tmp, vol->usable_leb_size);
 	lnum = tmp;
-	do {
-		if (off + len >= usable_leb_size)
-			len = usable_leb_size - off;
-
-		err = ubi_eba_read_leb(ubi, vol, lnum, buf, off, len, 0);
-		if (err) {
-			ubi_err(ubi, "read error: %pe", ERR_PTR(err));
-			break;
-		}
-		off += len;
-		if (off == usable_leb_size) {
-			lnum += 1;
-			off -= usable_leb_size;
-		}
 
-		size -= len;
-		offp += len;
-
-		buf += len;
-		len = size > usable_leb_size ? usable_leb_size : size;
-	} while (size);
+	/*
+	 * Static volumes are optionally checked while they are read, unless
+	 * the reader verifies the data itself.
+	 */
+	err = ubi_eba_read_lebs(ubi, vol, lnum, buf, off, size,
+				IS_ENABLED(CONFIG_MTD_UBI_CHECK_STATIC_READ) &&
+				!(flags & O_NOVERIFY));
+	if (err) {
+		ubi_err(ubi, "read error: %pe", ERR_PTR(err));
+		return err;
+	}
 
-	return count_save;
+	return size;
 }
 
 static ssize_t ubi_volume_cdev_write(struct cdev* cdev, const void *buf,
@@ -693,6 +693,263 @@ int ubi_eba_read_leb(struct ubi_device *ubi, struct ubi_volume *vol, int lnum,
 	return err;
 }
 
+/*
+ * Maximum number of LEBs mapped to consecutive PEBs which are read with a
+ * single flash read by ubi_eba_read_lebs().
+ */
+#define UBI_READ_RUN_PEBS	4
+
+/**
+ * leb_data_size - size of the data stored in a LEB.
+ * @vol: volume description object
+ * @lnum: logical eraseblock number
+ */
+static int leb_data_size(struct ubi_volume *vol, int lnum)
+{
+	if (vol->vol_type == UBI_STATIC_VOLUME && lnum == vol->used_ebs - 1)
+		return vol->last_eb_bytes;
+
+	return vol->usable_leb_size;
+}
+
+/**
+ * leb_needs_check - whether the data CRC of a LEB still has to be checked.
+ * @vol: volume description object
+ * @lnum: logical eraseblock number
+ * @offset: offset of the read in the LEB
+ * @len: length of the read
+ *
+ * Only complete reads of the data of a static volume LEB can be checked, and
+ * LEBs which were checked before are skipped.
+ */
+static bool leb_needs_check(struct ubi_volume *vol, int lnum, int offset,
+			    int len)
+{
+	if (vol->vol_type != UBI_STATIC_VOLUME || vol->checked)
+		return false;
+
+	if (lnum < vol->checked_ebs || lnum >= vol->used_ebs)
+		return false;
+
+	return offset == 0 && len == leb_data_size(vol, lnum);
+}
+
+/**
+ * leb_checked - remember that the data CRC of a LEB was checked.
+ * @vol: volume description object
+ * @lnum: logical eraseblock number
+ *
+ * Checked LEBs are tracked as the number of leading LEBs of the volume which
+ * passed, so a volume which was read sequentially from the start is marked as
+ * checked once its last LEB was read.
+ */
+static void leb_checked(struct ubi_volume *vol, int lnum)
+{
+	if (lnum != vol->checked_ebs)
+		return;
+
+	if (++vol->checked_ebs == vol->used_ebs)
+		vol->checked = 1;
+}
+
+/**
+ * leb_check_data - check LEB data against its VID header.
+ * @ubi: UBI device description object
+ * @vol: volume description object
+ * @lnum: logical eraseblock number
+ * @vid_hdr: VID header of the PEB @lnum is mapped to
+ * @data: LEB data
+ * @len: length of @data
+ *
+ * Returns %0 if the VID header is valid, belongs to @lnum and the data CRC
+ * matches, %-EBADMSG otherwise.
+ */
+static int leb_check_data(struct ubi_device *ubi, struct ubi_volume *vol,
+			  int lnum, const struct ubi_vid_hdr *vid_hdr,
+			  const void *data, int len)
+{
+	uint32_t crc;
+
+	if (be32_to_cpu(vid_hdr->magic) != UBI_VID_HDR_MAGIC)
+		return -EBADMSG;
+
+	crc = crc32(UBI_CRC32_INIT, vid_hdr, UBI_VID_HDR_SIZE_CRC);
+	if (crc != be32_to_cpu(vid_hdr->hdr_crc))
+		return -EBADMSG;
+
+	if (be32_to_cpu(vid_hdr->vol_id) != vol->vol_id ||
+	    be32_to_cpu(vid_hdr->lnum) != lnum ||
+	    be32_to_cpu(vid_hdr->data_size) != len)
+		return -EBADMSG;
+
+	crc = crc32(UBI_CRC32_INIT, data, len);
+	if (crc != be32_to_cpu(vid_hdr->data_crc))
+		return -EBADMSG;
+
+	return 0;
+}
+
+/**
+ * ubi_eba_read_lebs - read data spanning consecutive logical eraseblocks.
+ * @ubi: UBI device description object
+ * @vol: volume description object
+ * @lnum: first logical eraseblock number
+ * @buf: buffer to store the read data
+ * @offset: offset from where to read in @lnum
+ * @len: how many bytes to read
+ * @check: data CRC check flag
+ *
+ * This function is equivalent to calling ubi_eba_read_leb() for @lnum and the
+ * following LEBs in turn, but reads LEBs which are mapped to consecutive PEBs
+ * with a single flash read, which allows the NAND layer to use continuous page
+ * reads across eraseblock boundaries. The headers in between are read along
+ * and skipped.
+ *
+ * With @check set, the data CRC of complete LEBs of static volumes is checked
+ * against the VID headers read as part of the same flash read. LEBs which
+ * were checked once are not checked again, and a static volume becomes
+ * checked when all of its LEBs were read from the start.
+ *
+ * Reads reporting bit-flips or ECC errors and LEBs failing the check are
+ * redone with ubi_eba_read_leb(), so they are scrubbed and reported as usual.
+ * Returns zero in case of success and a negative error code in case of
+ * failure.
+ */
+int ubi_eba_read_lebs(struct ubi_device *ubi, struct ubi_volume *vol, int lnum,
+		      void *buf, int offset, size_t len, int check)
+{
+	const int usable = vol->usable_leb_size;
+	int pnums[UBI_READ_RUN_PEBS], chunks[UBI_READ_RUN_PEBS];
+	int err = 0, i, n, pnum, base, off, chk;
+	void *bounce = NULL, *hdr, *data;
+	size_t span, read, rem;
+
+	if (vol->vol_type == UBI_DYNAMIC_VOLUME)
+		check = 0;
+
+	while (len) {
+		/* look up the PEBs of the LEBs this run will cover */
+		for (n = 0, rem = len, off = offset;
+		     rem && n < UBI_READ_RUN_PEBS &&
+		     lnum + n < vol->reserved_pebs; n++) {
+			pnum = vol->eba_tbl->entries[lnum + n].pnum;
+			if (pnum >= 0) {
+				err = check_mapping(ubi, vol, lnum + n, &pnum);
+				if (err < 0)
+					goto out;
+			}
+			if (pnum < 0 || (n && pnum != pnums[0] + n))
+				break;
+
+			pnums[n] = pnum;
+			chunks[n] = min_t(size_t, rem, usable - off);
+			rem -= chunks[n];
+			off = 0;
+		}
+
+		if (n < 2)
+			goto single;
+
+		if (!bounce) {
+			bounce = vmalloc(UBI_READ_RUN_PEBS * ubi->peb_size);
+			if (!bounce)
+				goto single;
+		}
+
+		/*
+		 * Start at the EC header of the first PEB, so its VID header
+		 * is available, unless the read starts in the middle of the
+		 * LEB, which cannot be checked anyway.
+		 */
+		base = offset ? ubi->leb_start + offset : 0;
+		span = (size_t)(n - 1) * ubi->peb_size + ubi->leb_start +
+		       chunks[n - 1] - base;
+
+		dbg_eba("read %zu bytes from LEBs %d..%d:%d, PEBs %d..%d",
+			span, vol->vol_id, lnum, lnum + n - 1, pnums[0],
+			pnums[0] + n - 1);
+
+		for (i = 0; i < n; i++) {
+			err = leb_read_lock(ubi, vol->vol_id, lnum + i);
+			if (err) {
+				while (i--)
+					leb_read_unlock(ubi, vol->vol_id,
+							lnum + i);
+				goto out;
+			}
+		}
+
+		err = mtd_read(ubi->mtd, (loff_t)pnums[0] * ubi->peb_size +
+			       base, span, &read, bounce);
+
+		for (i = 0; i < n; i++)
+			leb_read_unlock(ubi, vol->vol_id, lnum + i);
+
+		if (err || read != span) {
+			/* let ubi_eba_read_leb() deal with this LEB */
+			err = 0;
+			goto single;
+		}
+
+		for (i = 0; i < n; i++) {
+			off = i ? 0 : offset;
+			data = bounce + (size_t)i * ubi->peb_size +
+			       ubi->leb_start + off - base;
+
+			chk = check && leb_needs_check(vol, lnum, off,
+						       chunks[i]);
+			if (chk) {
+				/* complete LEB, so its VID header was read */
+				hdr = bounce + (size_t)i * ubi->peb_size +
+				      ubi->vid_hdr_offset - base;
+				err = leb_check_data(ubi, vol, lnum, hdr, data,
+						     chunks[i]);
+			}
+
+			if (chk && err) {
+				/* reports and handles the failure */
+				err = ubi_eba_read_leb(ubi, vol, lnum, buf,
+						       off, chunks[i], 1);
+				if (err)
+					goto out;
+			} else {
+				memcpy(buf, data, chunks[i]);
+			}
+
+			if (chk)
+				leb_checked(vol, lnum);
+
+			buf += chunks[i];
+			len -= chunks[i];
+			offset = 0;
+			lnum++;
+		}
+
+		continue;
+
+single:
+		chunks[0] = min_t(size_t, len, usable - offset);
+		chk = check && leb_needs_check(vol, lnum, offset, chunks[0]);
+
+		err = ubi_eba_read_leb(ubi, vol, lnum, buf, offset, chunks[0],
+				       chk);
+		if (err)
+			goto out;
+
+		if (chk)
+			leb_checked(vol, lnum);
+
+		buf += chunks[0];
+		len -= chunks[0];
+		offset = 0;
+		lnum++;
+	}
+
+out:
+	vfree(bounce);
+	return err;
+}
+
 /**
  * try_recover_peb - try to recover from write failure.
  * @vol: volume description object
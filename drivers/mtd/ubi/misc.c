@@ -48,25 +48,34 @@ int ubi_calc_data_len(const struct ubi_device *ubi, const void *buf,
 int ubi_check_volume(struct ubi_device *ubi, int vol_id)
 {
 	void *buf;
-	int err = 0, i;
+	int err = 0, i, n;
 	struct ubi_volume *vol = ubi->volumes[vol_id];
+	const int batch = 4;
 
 	if (vol->vol_type != UBI_STATIC_VOLUME)
 		return 0;
 
-	buf = vmalloc(vol->usable_leb_size);
+	/* check all LEBs, regardless of what earlier reads checked already */
+	vol->checked = 0;
+	vol->checked_ebs = 0;
+
+	buf = vmalloc(batch * vol->usable_leb_size);
 	if (!buf)
 		return -ENOMEM;
 
-	for (i = 0; i < vol->used_ebs; i++) {
-		int size;
+	/* read a few LEBs at once, so they can be read in one go */
+	for (i = 0; i < vol->used_ebs; i += n) {
+		size_t size;
+
+		n = min(batch, vol->used_ebs - i);
+		size = (size_t)(n - 1) * vol->usable_leb_size;
 
-		if (i == vol->used_ebs - 1)
-			size = vol->last_eb_bytes;
+		if (i + n == vol->used_ebs)
+			size += vol->last_eb_bytes;
 		else
-			size = vol->usable_leb_size;
+			size += vol->usable_leb_size;
 
-		err = ubi_eba_read_leb(ubi, vol, i, buf, 0, size, 1);
+		err = ubi_eba_read_lebs(ubi, vol, i, buf, 0, size, 1);
 		if (err) {
 			if (mtd_is_eccerr(err))
 				err = 1;
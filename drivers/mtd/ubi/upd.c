@@ -82,6 +82,8 @@ static int clear_update_marker(struct ubi_device *ubi, struct ubi_volume *vol,
 
 	if (vol->vol_type == UBI_STATIC_VOLUME) {
 		vol->corrupted = 0;
+		vol->checked = 0;
+		vol->checked_ebs = 0;
 		vol->used_bytes = bytes;
 		vol->used_ebs = div_u64_rem(bytes, vol->usable_leb_size,
 					    &vol->last_eb_bytes);
@@ -123,6 +125,10 @@ int ubi_start_update(struct ubi_device *ubi, struct ubi_volume *vol,
 	if (err)
 		return err;
 
+	/* the data CRCs checked so far are about to be stale */
+	vol->checked = 0;
+	vol->checked_ebs = 0;
+
 	/* Before updating - wipe out the volume */
 	for (i = 0; i < vol->reserved_pebs; i++) {
 		err = ubi_eba_unmap_leb(ubi, vol, i);
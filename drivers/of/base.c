@@ -7,6 +7,7 @@
  * based on Linux devicetree support
  */
 #include <common.h>
+#include <arena.h>
 #include <deep-probe.h>
 #include <of.h>
 #include <of_address.h>
@@ -2631,11 +2632,86 @@ int of_diff(struct device_node *a, struct device_node *b, int indent)
 	return diff;
 }
 
-struct device_node *of_new_node(struct device_node *parent, const char *name)
+/*
+ * Allocation helpers for trees built with the of_arena_* functions. Memory
+ * comes from the arena if one is given and falls back to the heap when the
+ * arena is out of memory. @flag is set in @flags for arena memory, freeing
+ * must skip everything that is tagged this way.
+ */
+static void *of_zalloc(struct arena *arena, size_t size, u8 *flags, u8 flag)
+{
+	void *mem = arena ? arena_zalloc(arena, size) : NULL;
+
+	if (!mem)
+		return xzalloc(size);
+
+	*flags |= flag;
+	return mem;
+}
+
+static char *of_strdup(struct arena *arena, const char *str, u8 *flags, u8 flag)
+{
+	char *mem = arena ? arena_strdup(arena, str) : NULL;
+
+	if (!mem)
+		return xstrdup(str);
+
+	*flags |= flag;
+	return mem;
+}
+
+static const char *of_strdup_const(struct arena *arena, const char *str,
+				   u8 *flags, u8 flag)
+{
+	const char *mem = arena ? arena_strdup_const(arena, str) : NULL;
+
+	if (!mem)
+		return xstrdup_const(str);
+
+	*flags |= flag;
+	return mem;
+}
+
+static void of_free_property(struct property *pp)
+{
+	if (!(pp->arena_flags & OF_ARENA_NAME))
+		free_const(pp->name);
+	if (!(pp->arena_flags & OF_ARENA_VALUE))
+		free(pp->value);
+	if (!(pp->arena_flags & OF_ARENA_STRUCT))
+		free(pp);
+}
+
+static void of_free_node(struct device_node *node)
+{
+	if (!(node->arena_flags & OF_ARENA_NAME))
+		free_const(node->name);
+	if (!(node->arena_flags & OF_ARENA_FULL_NAME))
+		free(node->full_name);
+	if (!(node->arena_flags & OF_ARENA_STRUCT))
+		free(node);
+}
+
+/**
+ * of_arena_new_node - Add a new node allocated from an arena
+ * @arena:	arena to allocate from, or NULL to use the heap
+ * @parent:	parent of the new node, or NULL to create a new root node
+ * @name:	name of the new node
+ *
+ * Meant for parsers that build whole trees at once. The arena memory is only
+ * reclaimed as a whole: when creating a root node, the root takes ownership
+ * of @arena and frees it in of_delete_node(). Nodes and properties added
+ * later with the regular functions are allocated from the heap.
+ *
+ * Return: A pointer to the new node
+ */
+struct device_node *of_arena_new_node(struct arena *arena,
+				      struct device_node *parent, const char *name)
 {
 	struct device_node *node;
+	u8 flags = 0;
 
-	node = xzalloc(sizeof(*node));
+	node = of_zalloc(arena, sizeof(*node), &flags, OF_ARENA_STRUCT);
 	node->parent = parent;
 	if (parent)
 		list_add_tail(&node->parent_list, &parent->children);
@@ -2644,30 +2720,116 @@ struct device_node *of_new_node(struct device_node *parent, const char *name)
 	INIT_LIST_HEAD(&node->properties);
 
 	if (parent) {
-		node->name = xstrdup_const(name);
-		node->full_name = basprintf("%pOF/%s",
-					      node->parent, name);
+		size_t len = strlen(parent->full_name) + strlen(name) + 2;
+
+		node->name = of_strdup_const(arena, name, &flags, OF_ARENA_NAME);
+		node->full_name = arena ? arena_alloc(arena, len) : NULL;
+		if (node->full_name)
+			flags |= OF_ARENA_FULL_NAME;
+		else
+			node->full_name = xmalloc(len);
+		snprintf(node->full_name, len, "%s/%s", parent->full_name, name);
 		list_add(&node->list, &parent->list);
 	} else {
-		node->name = xstrdup_const("");
-		node->full_name = xstrdup("");
+		node->name = "";
+		node->full_name = of_strdup(arena, "", &flags, OF_ARENA_FULL_NAME);
+		node->arena = arena;
 		INIT_LIST_HEAD(&node->list);
 	}
 
+	node->arena_flags = flags;
+
 	return node;
 }
 
+struct device_node *of_new_node(struct device_node *parent, const char *name)
+{
+	return of_arena_new_node(NULL, parent, name);
+}
+
+static struct property *of_arena_add_property(struct arena *arena,
+					      struct device_node *node,
+					      const char *name)
+{
+	struct property *prop;
+	u8 flags = 0;
+
+	prop = of_zalloc(arena, sizeof(*prop), &flags, OF_ARENA_STRUCT);
+	prop->name = of_strdup_const(arena, name, &flags, OF_ARENA_NAME);
+	prop->arena_flags = flags;
+
+	list_add_tail(&prop->list, &node->properties);
+
+	return prop;
+}
+
 struct property *__of_new_property(struct device_node *node, const char *name,
 				   void *data, int len)
 {
 	struct property *prop;
 
-	prop = xzalloc(sizeof(*prop));
-	prop->name = xstrdup_const(name);
+	prop = of_arena_add_property(NULL, node, name);
 	prop->length = len;
 	prop->value = data;
 
-	list_add_tail(&prop->list, &node->properties);
+	return prop;
+}
+
+/**
+ * of_arena_new_property - Add a new property allocated from an arena
+ * @arena:	arena to allocate from, or NULL to use the heap
+ * @node:	device node to which the property is added
+ * @name:	Name of the new property
+ * @data:	Value of the property (can be NULL)
+ * @len:	Length of the value
+ *
+ * Like of_new_property(), but the property is allocated from @arena. See
+ * of_arena_new_node() for the lifetime of arena allocations.
+ *
+ * Return: A pointer to the new property
+ */
+struct property *of_arena_new_property(struct arena *arena,
+				       struct device_node *node, const char *name,
+				       const void *data, int len)
+{
+	struct property *prop;
+	u8 flags = 0;
+	char *buf;
+
+	buf = of_zalloc(arena, len, &flags, OF_ARENA_VALUE);
+	if (data)
+		memcpy(buf, data, len);
+
+	prop = of_arena_add_property(arena, node, name);
+	prop->length = len;
+	prop->value = buf;
+	prop->arena_flags |= flags;
+
+	return prop;
+}
+
+/**
+ * of_arena_new_property_const - Add a new const property allocated from an arena
+ * @arena:	arena to allocate from, or NULL to use the heap
+ * @node:	device node to which the property is added
+ * @name:	Name of the new property
+ * @data:	Value of the property (can be NULL)
+ * @len:	Length of the value
+ *
+ * Like of_new_property_const(), but the property is allocated from @arena.
+ *
+ * Return: A pointer to the new property
+ */
+struct property *of_arena_new_property_const(struct arena *arena,
+					     struct device_node *node,
+					     const char *name,
+					     const void *data, int len)
+{
+	struct property *prop;
+
+	prop = of_arena_add_property(arena, node, name);
+	prop->length = len;
+	prop->value_const = data;
 
 	return prop;
 }
@@ -2687,13 +2849,7 @@ struct property *__of_new_property(struct device_node *node, const char *name,
 struct property *of_new_property(struct device_node *node, const char *name,
 		const void *data, int len)
 {
-	char *buf;
-
-	buf = xzalloc(len);
-	if (data)
-		memcpy(buf, data, len);
-
-	return __of_new_property(node, name, buf, len);
+	return of_arena_new_property(NULL, node, name, data, len);
 }
 
 /**
@@ -2713,16 +2869,7 @@ struct property *of_new_property(struct device_node *node, const char *name,
 struct property *of_new_property_const(struct device_node *node, const char *name,
 		const void *data, int len)
 {
-	struct property *prop;
-
-	prop = xzalloc(sizeof(*prop));
-	prop->name = xstrdup(name);
-	prop->length = len;
-	prop->value_const = data;
-
-	list_add_tail(&prop->list, &node->properties);
-
-	return prop;
+	return of_arena_new_property_const(NULL, node, name, data, len);
 }
 
 void of_delete_property(struct property *pp)
@@ -2732,9 +2879,7 @@ void of_delete_property(struct property *pp)
 
 	list_del(&pp->list);
 
-	free_const(pp->name);
-	free(pp->value);
-	free(pp);
+	of_free_property(pp);
 }
 
 struct property *of_rename_property(struct device_node *np,
@@ -2748,8 +2893,10 @@ struct property *of_rename_property(struct device_node *np,
 
 	of_property_write_bool(np, new_name, false);
 
-	free_const(pp->name);
+	if (!(pp->arena_flags & OF_ARENA_NAME))
+		free_const(pp->name);
 	pp->name = xstrdup(new_name);
+	pp->arena_flags &= ~OF_ARENA_NAME;
 	return pp;
 }
 
@@ -2816,7 +2963,14 @@ int of_append_property(struct device_node *np, const char *name, const void *val
 	}
 
 	orig_len = pp->length;
-	buf = realloc(pp->value, orig_len + len);
+	if (pp->arena_flags & OF_ARENA_VALUE) {
+		/* arena memory can't be resized, move the value to the heap */
+		buf = malloc(orig_len + len);
+		if (buf)
+			memcpy(buf, pp->value, orig_len);
+	} else {
+		buf = realloc(pp->value, orig_len + len);
+	}
 	if (!buf)
 		return -ENOMEM;
 
@@ -2824,6 +2978,7 @@ int of_append_property(struct device_node *np, const char *name, const void *val
 
 	pp->value = buf;
 	pp->length += len;
+	pp->arena_flags &= ~OF_ARENA_VALUE;
 
 	if (pp->value_const) {
 		memcpy(buf, pp->value_const, orig_len);
@@ -2855,10 +3010,12 @@ int of_prepend_property(struct device_node *np, const char *name, const void *va
 	memcpy(buf, val, len);
 	memcpy(buf + len, oldval, oldlen);
 
-	free(pp->value);
+	if (!(pp->arena_flags & OF_ARENA_VALUE))
+		free(pp->value);
 	pp->value = buf;
 	pp->length = len + oldlen;
 	pp->value_const = NULL;
+	pp->arena_flags &= ~OF_ARENA_VALUE;
 
 	return 0;
 }
@@ -3114,10 +3271,29 @@ struct device_node *of_dup(const struct device_node *root)
 	return of_copy_node(NULL, root);
 }
 
+/*
+ * Free a whole tree without unlinking anything. Only objects that were
+ * added from the heap are freed individually, the arena goes in one go.
+ */
+static void of_free_tree(struct device_node *node)
+{
+	struct device_node *n, *nt;
+	struct property *p, *pt;
+
+	list_for_each_entry_safe(p, pt, &node->properties, list)
+		of_free_property(p);
+
+	list_for_each_entry_safe(n, nt, &node->children, parent_list)
+		of_free_tree(n);
+
+	of_free_node(node);
+}
+
 void of_delete_node(struct device_node *node)
 {
 	struct device_node *n, *nt;
 	struct property *p, *pt;
+	struct arena *arena;
 
 	if (!node)
 		return;
@@ -3127,20 +3303,23 @@ void of_delete_node(struct device_node *node)
 		return;
 	}
 
+	if (!node->parent) {
+		arena = node->arena;
+		of_free_tree(node);
+		arena_free(arena);
+		return;
+	}
+
 	list_for_each_entry_safe(p, pt, &node->properties, list)
 		of_delete_property(p);
 
 	list_for_each_entry_safe(n, nt, &node->children, parent_list)
 		of_delete_node(n);
 
-	if (node->parent) {
-		list_del(&node->parent_list);
-		list_del(&node->list);
-	}
+	list_del(&node->parent_list);
+	list_del(&node->list);
 
-	free_const(node->name);
-	free(node->full_name);
-	free(node);
+	of_free_node(node);
 }
 
 /*
@@ -10,9 +10,13 @@
 #include <of.h>
 #include <errno.h>
 #include <malloc.h>
+#include <arena.h>
 #include <init.h>
 #include <memory.h>
 #include <fuzz.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/stat.h>
 #include <linux/sizes.h>
 #include <linux/ctype.h>
 #include <linux/log2.h>
@@ -111,7 +115,7 @@ static int of_reservemap_num_entries(const struct fdt_header *fdt)
  *
  * Return: 0 for success or negative error code
  */
-static int of_unflatten_reservemap(struct device_node *root,
+static int of_unflatten_reservemap(struct arena *arena, struct device_node *root,
 				   const struct fdt_header *fdt)
 {
 	int n;
@@ -122,13 +126,13 @@ static int of_unflatten_reservemap(struct device_node *root,
 	if (n <= 0)
 		return n;
 
-	memreserve = of_new_node(root, "$memreserve");
+	memreserve = of_arena_new_node(arena, root, "$memreserve");
 	if (!memreserve)
 		return -ENOMEM;
 
-	p = of_new_property(memreserve, "reg",
-			    (void *)fdt + be32_to_cpu(fdt->off_mem_rsvmap),
-			    n * sizeof(struct fdt_reserve_entry));
+	p = of_arena_new_property(arena, memreserve, "reg",
+				  (void *)fdt + be32_to_cpu(fdt->off_mem_rsvmap),
+				  n * sizeof(struct fdt_reserve_entry));
 	if (!p)
 		return -ENOMEM;
 
@@ -190,6 +194,7 @@ static struct device_node *__of_unflatten_dtb(const void *infdt, int size,
 	const char *pathp, *name;
 	struct device_node *root, *node = NULL;
 	struct property *p;
+	struct arena *arena;
 	uint32_t dt_struct;
 	const struct fdt_node_header *fnh;
 	void *dt_strings;
@@ -205,11 +210,19 @@ static struct device_node *__of_unflatten_dtb(const void *infdt, int size,
 	dt_struct = f.off_dt_struct;
 	dt_strings = (void *)fdt + f.off_dt_strings;
 
-	root = of_new_node(NULL, NULL);
+	/*
+	 * All nodes and properties of the tree come from one arena which
+	 * the root node owns, so deleting the tree frees them at once.
+	 */
+	arena = arena_new();
+	if (!arena)
+		return ERR_PTR(-ENOMEM);
+
+	root = of_arena_new_node(arena, NULL, NULL);
 	if (!root)
 		return ERR_PTR(-ENOMEM);
 
-	ret = of_unflatten_reservemap(root, fdt);
+	ret = of_unflatten_reservemap(arena, root, fdt);
 	if (ret)
 		goto err;
 
@@ -260,7 +273,7 @@ static struct device_node *__of_unflatten_dtb(const void *infdt, int size,
 					ret = -EINVAL;
 					goto err;
 				}
-				node = of_new_node(node, pathp);
+				node = of_arena_new_node(arena, node, pathp);
 			}
 
 			break;
@@ -306,9 +319,11 @@ static struct device_node *__of_unflatten_dtb(const void *infdt, int size,
 			}
 
 			if (constprops)
-				p = of_new_property_const(node, name, nodep, len);
+				p = of_arena_new_property_const(arena, node, name,
+								nodep, len);
 			else
-				p = of_new_property(node, name, nodep, len);
+				p = of_arena_new_property(arena, node, name,
+							  nodep, len);
 
 			if (!strcmp(name, "phandle") && len == 4)
 				node->phandle = be32_to_cpup(of_property_get_value(p));
@@ -866,6 +881,98 @@ int fdt_machine_is_compatible(const struct fdt_header *fdt, size_t fdt_size, con
 	return 0;
 }
 
+/**
+ * fdt_file_machine_is_compatible - check the root compatible of a dtb file
+ * @filename: path to the flattened devicetree
+ * @compat: the compatible to look for
+ *
+ * Like fdt_machine_is_compatible(), but instead of reading the whole blob
+ * only the header, the root node property headers, their names and finally
+ * the root compatible property itself are read from @filename.
+ *
+ * Return: the match score as returned by fdt_machine_is_compatible(), 0 if
+ * the file could not be read or is not compatible
+ */
+int fdt_file_machine_is_compatible(const char *filename, const char *compat)
+{
+	struct fdt_header hdr, f;
+	struct fdt_property prop;
+	char name[sizeof("compatible")];
+	struct stat s;
+	__be32 tag;
+	uint32_t dt_struct, nameoff, len;
+	char *data = NULL;
+	int fd, ret = 0;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	if (fstat(fd, &s) || s.st_size < sizeof(hdr))
+		goto out;
+
+	if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+		goto out;
+
+	if (fdt_parse_header(&hdr, s.st_size, &f) < 0)
+		goto out;
+
+	dt_struct = f.off_dt_struct;
+	if (pread(fd, &tag, sizeof(tag), dt_struct) != sizeof(tag) ||
+	    be32_to_cpu(tag) != FDT_BEGIN_NODE)
+		goto out;
+
+	/* The root node must have an empty name */
+	if (pread(fd, name, 1, dt_struct + FDT_TAGSIZE) != 1 || name[0])
+		goto out;
+
+	dt_struct = dt_struct_advance(&f, dt_struct, sizeof(struct fdt_node_header), 1);
+
+	/* properties precede subnodes, see fdt_machine_is_compatible() */
+	while (dt_struct) {
+		if (pread(fd, &tag, sizeof(tag), dt_struct) != sizeof(tag))
+			goto out;
+
+		if (be32_to_cpu(tag) == FDT_NOP) {
+			dt_struct = dt_struct_advance(&f, dt_struct, FDT_TAGSIZE, 0);
+			continue;
+		}
+
+		if (be32_to_cpu(tag) != FDT_PROP)
+			goto out;
+
+		if (pread(fd, &prop, sizeof(prop), dt_struct) != sizeof(prop))
+			goto out;
+
+		len = fdt32_to_cpu(prop.len);
+		nameoff = fdt32_to_cpu(prop.nameoff);
+
+		if (nameoff + sizeof(name) <= f.size_dt_strings &&
+		    pread(fd, name, sizeof(name), f.off_dt_strings + nameoff) == sizeof(name) &&
+		    !memcmp(name, "compatible", sizeof(name)))
+			break;
+
+		dt_struct = dt_struct_advance(&f, dt_struct, sizeof(prop), len);
+	}
+
+	if (!dt_struct || !dt_struct_advance(&f, dt_struct, sizeof(prop), len))
+		goto out;
+
+	data = malloc(len);
+	if (!data)
+		goto out;
+
+	if (pread(fd, data, len, dt_struct + sizeof(prop)) != len)
+		goto out;
+
+	ret = fdt_string_is_compatible(data, len, compat, strlen(compat));
+out:
+	free(data);
+	close(fd);
+
+	return ret;
+}
+
 /*
  * In order to randomize all inputs to fdt_machine_is_compatible,
  * we use the last 32 bytes of the random data as a compatible.
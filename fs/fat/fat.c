@@ -25,6 +25,7 @@
 #include <linux/ctype.h>
 #include <xfuncs.h>
 #include <fcntl.h>
+#include <rtc.h>
 #include "ff.h"
 #include "integer.h"
 #include "diskio.h"
@@ -331,6 +332,12 @@ static int fat_stat(struct device *dev, const char *filename, struct stat *s)
 	s->st_size = finfo.fsize;
 	s->st_mode = S_IRWXU | S_IRWXG | S_IRWXO;
 
+	if (IS_ENABLED(CONFIG_GREGORIAN_CALENDER) && finfo.fdate)
+		s->st_mtime = mktime(1980 + (finfo.fdate >> 9),
+				     (finfo.fdate >> 5) & 0xf, finfo.fdate & 0x1f,
+				     finfo.ftime >> 11, (finfo.ftime >> 5) & 0x3f,
+				     (finfo.ftime & 0x1f) * 2);
+
 	if (finfo.fattrib & AM_DIR)
 		s->st_mode |= S_IFDIR;
 	else
@@ -1113,6 +1113,7 @@ static void stat_inode(struct inode *inode, struct stat *s)
 	s->st_mode = inode->i_mode;
 	s->st_uid = inode->i_uid;
 	s->st_gid = inode->i_gid;
+	s->st_mtime = inode->i_mtime.tv_sec;
 	s->st_cdevname = inode->cdevname;
 }
 
@@ -55,7 +55,7 @@ static struct dentry *legacy_lookup(struct inode *dir, struct dentry *dentry,
 	const struct fs_legacy_ops *legacy_ops = fsdev->driver->legacy_ops;
 	struct inode *inode;
 	char *pathname;
-	struct stat s;
+	struct stat s = {};
 	int ret;
 
 	pathname = dpath(dentry, fsdev->vfsmount.mnt_root);
@@ -68,6 +68,7 @@ static struct dentry *legacy_lookup(struct inode *dir, struct dentry *dentry,
 
 		inode->i_size = s.st_size;
 		inode->i_mode = s.st_mode;
+		inode->i_mtime.tv_sec = s.st_mtime;
 
 		d_add(dentry, inode);
 	}
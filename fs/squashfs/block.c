@@ -77,6 +77,53 @@ static char *get_block_length(struct super_block *sb,
 }
 
 
+/*
+ * Decompress, or copy if it is stored uncompressed, a block whose on-disk data
+ * starts offset bytes into bh[0] and spans the b devblksize buffers of bh.
+ */
+static int squashfs_decompress_block(struct squashfs_sb_info *msblk, char **bh,
+		int b, int offset, int length, int compressed,
+		struct squashfs_page_actor *output)
+{
+	int bytes, k, avail, pg_offset = 0;
+	void *data;
+
+	if (compressed) {
+		if (!msblk->stream)
+			return -EIO;
+		return squashfs_decompress(msblk, bh, b, offset, length,
+			output);
+	}
+
+	/*
+	 * Block is uncompressed.
+	 */
+	data = squashfs_first_page(output);
+
+	for (bytes = length, k = 0; k < b; k++) {
+		int in = min(bytes, msblk->devblksize - offset);
+		bytes -= in;
+		while (in) {
+			if (pg_offset == PAGE_CACHE_SIZE) {
+				data = squashfs_next_page(output);
+				pg_offset = 0;
+			}
+			avail = min_t(int, in, PAGE_CACHE_SIZE -
+					pg_offset);
+			memcpy(data + pg_offset, bh[k] + offset,
+					avail);
+			in -= avail;
+			pg_offset += avail;
+			offset += avail;
+		}
+		offset = 0;
+	}
+	squashfs_finish_page(output);
+
+	return length;
+}
+
+
 /*
  * Read and decompress a metadata block or datablock.  Length is non-zero
  * if a datablock is being read (the size is stored elsewhere in the
@@ -90,10 +137,10 @@ int squashfs_read_data(struct super_block *sb, u64 index, int length,
 		u64 *next_index, struct squashfs_page_actor *output)
 {
 	struct squashfs_sb_info *msblk = sb->s_fs_info;
-	char **buf;
+	char **buf, *first = NULL, *data = NULL;
 	int offset = index & ((1 << msblk->devblksize_log2) - 1);
 	u64 cur_index = index >> msblk->devblksize_log2;
-	int bytes, compressed, b = 0, k = 0, avail;
+	int bytes, compressed, b = 0, k, nblocks;
 
 	buf = calloc(((output->length + msblk->devblksize - 1)
 			>> msblk->devblksize_log2) + 1, sizeof(*buf));
@@ -104,7 +151,6 @@ int squashfs_read_data(struct super_block *sb, u64 index, int length,
 		/*
 		 * Datablock.
 		 */
-		bytes = -offset;
 		compressed = SQUASHFS_COMPRESSED_BLOCK(length);
 		length = SQUASHFS_COMPRESSED_SIZE_BLOCK(length);
 		if (next_index)
@@ -118,15 +164,16 @@ int squashfs_read_data(struct super_block *sb, u64 index, int length,
 			goto read_failure;
 		}
 
-		for (b = 0; bytes < length; b++, cur_index++) {
-			buf[b] = squashfs_devread(msblk,
-					 cur_index * msblk->devblksize,
-					 msblk->devblksize);
-			if (buf[b] == NULL)
-				goto block_release;
+		/* read all device blocks spanned by the datablock at once */
+		nblocks = DIV_ROUND_UP(offset + length, msblk->devblksize);
+		data = squashfs_devread(msblk,
+				 cur_index * msblk->devblksize,
+				 nblocks << msblk->devblksize_log2);
+		if (data == NULL)
+			goto read_failure;
 
-			bytes += msblk->devblksize;
-		}
+		for (b = 0; b < nblocks; b++)
+			buf[b] = data + (b << msblk->devblksize_log2);
 
 	} else {
 		/*
@@ -135,9 +182,10 @@ int squashfs_read_data(struct super_block *sb, u64 index, int length,
 		if ((index + 2) > msblk->bytes_used)
 			goto read_failure;
 
-		buf[0] = get_block_length(sb, &cur_index, &offset, &length);
-		if (buf[0] == NULL)
+		first = get_block_length(sb, &cur_index, &offset, &length);
+		if (first == NULL)
 			goto read_failure;
+		buf[0] = first;
 		b = 1;
 
 		bytes = msblk->devblksize - offset;
@@ -153,58 +201,33 @@ int squashfs_read_data(struct super_block *sb, u64 index, int length,
 					(index + length) > msblk->bytes_used)
 			goto block_release;
 
-		for (; bytes < length; b++) {
-			buf[b] = squashfs_devread(msblk,
-					 ++cur_index * msblk->devblksize,
-					 msblk->devblksize);
-			if (buf[b] == NULL)
+		if (bytes < length) {
+			nblocks = DIV_ROUND_UP(length - bytes,
+					       msblk->devblksize);
+			data = squashfs_devread(msblk,
+					 (cur_index + 1) * msblk->devblksize,
+					 nblocks << msblk->devblksize_log2);
+			if (data == NULL)
 				goto block_release;
-			bytes += msblk->devblksize;
-		}
-	}
 
-	if (compressed) {
-		if (!msblk->stream)
-			goto read_failure;
-		length = squashfs_decompress(msblk, buf, b, offset, length,
-			output);
-		if (length < 0)
-			goto read_failure;
-	} else {
-		/*
-		 * Block is uncompressed.
-		 */
-		int pg_offset = 0;
-		void *data = squashfs_first_page(output);
-
-		for (bytes = length; k < b; k++) {
-			int in = min(bytes, msblk->devblksize - offset);
-			bytes -= in;
-			while (in) {
-				if (pg_offset == PAGE_CACHE_SIZE) {
-					data = squashfs_next_page(output);
-					pg_offset = 0;
-				}
-				avail = min_t(int, in, PAGE_CACHE_SIZE -
-						pg_offset);
-				memcpy(data + pg_offset, buf[k] + offset,
-						avail);
-				in -= avail;
-				pg_offset += avail;
-				offset += avail;
-			}
-			offset = 0;
-			kfree(buf[k]);
+			for (k = 0; k < nblocks; k++)
+				buf[b++] = data + (k << msblk->devblksize_log2);
 		}
-		squashfs_finish_page(output);
 	}
 
+	length = squashfs_decompress_block(msblk, buf, b, offset, length,
+			compressed, output);
+	if (length < 0)
+		goto block_release;
+
+	kfree(first);
+	kfree(data);
 	kfree(buf);
 	return length;
 
 block_release:
-	for (; k < b; k++)
-		kfree(buf[k]);
+	kfree(first);
+	kfree(data);
 
 read_failure:
 	ERROR("squashfs_read_data failed to read block 0x%llx\n",
@@ -212,3 +235,68 @@ int squashfs_read_data(struct super_block *sb, u64 index, int length,
 	kfree(buf);
 	return -EIO;
 }
+
+
+/*
+ * Read n consecutive datablocks starting at index with a single device read
+ * and decompress datablock i into output[i].  lengths[] holds the on-disk
+ * length fields of the datablocks, res[] receives the decompressed length or
+ * a negative error code of each of them.
+ */
+int squashfs_read_datablocks(struct super_block *sb, u64 index, int n,
+		const int *lengths, struct squashfs_page_actor **output,
+		int *res)
+{
+	struct squashfs_sb_info *msblk = sb->s_fs_info;
+	int mask = (1 << msblk->devblksize_log2) - 1;
+	u64 cur_index = index >> msblk->devblksize_log2;
+	int i, k, pos, length, total = 0, nblocks;
+	u64 block = index;
+	char **buf, *data;
+
+	for (i = 0; i < n; i++) {
+		length = SQUASHFS_COMPRESSED_SIZE_BLOCK(lengths[i]);
+		if (length <= 0 || length > output[i]->length)
+			return -EIO;
+		total += length;
+	}
+
+	if (index + total > msblk->bytes_used)
+		return -EIO;
+
+	nblocks = DIV_ROUND_UP((index & mask) + total, msblk->devblksize);
+	buf = calloc(nblocks, sizeof(*buf));
+	if (buf == NULL)
+		return -ENOMEM;
+
+	TRACE("Blocks @ 0x%llx, %d blocks, %d bytes\n", index, n, total);
+
+	data = squashfs_devread(msblk, cur_index * msblk->devblksize,
+				nblocks << msblk->devblksize_log2);
+	if (data == NULL) {
+		kfree(buf);
+		return -EIO;
+	}
+
+	for (k = 0; k < nblocks; k++)
+		buf[k] = data + (k << msblk->devblksize_log2);
+
+	for (i = 0, pos = index & mask; i < n; i++) {
+		length = SQUASHFS_COMPRESSED_SIZE_BLOCK(lengths[i]);
+		k = pos >> msblk->devblksize_log2;
+
+		res[i] = squashfs_decompress_block(msblk, buf + k,
+			DIV_ROUND_UP((pos & mask) + length, msblk->devblksize),
+			pos & mask, length,
+			SQUASHFS_COMPRESSED_BLOCK(lengths[i]), output[i]);
+		if (res[i] < 0)
+			ERROR("squashfs_read_datablocks failed to read block "
+			      "0x%llx\n", (unsigned long long) block);
+		pos += length;
+		block += length;
+	}
+
+	kfree(data);
+	kfree(buf);
+	return 0;
+}
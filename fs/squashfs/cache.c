@@ -48,6 +48,56 @@
 #include "squashfs.h"
 #include "page_actor.h"
 
+/*
+ * Look-up block in cache, returning the index of its entry or -1 if it is not
+ * cached.
+ */
+static int squashfs_cache_find(struct squashfs_cache *cache, u64 block)
+{
+	int i, n;
+
+	for (i = cache->curr_blk, n = 0; n < cache->entries; n++) {
+		if (cache->entry[i].block == block)
+			return i;
+		i = (i + 1) % cache->entries;
+	}
+
+	return -1;
+}
+
+/*
+ * Evict an unused cache entry and initialise it for block, with a usage count
+ * of one.  The caller must make sure that there is at least one unused entry.
+ */
+static struct squashfs_cache_entry *squashfs_cache_alloc(
+	struct squashfs_cache *cache, u64 block)
+{
+	struct squashfs_cache_entry *entry;
+	int i, n;
+
+	/*
+	 * A simple round-robin strategy is used to choose the entry to be
+	 * evicted from the cache.
+	 */
+	i = cache->next_blk;
+	for (n = 0; n < cache->entries; n++) {
+		if (cache->entry[i].refcount == 0)
+			break;
+		i = (i + 1) % cache->entries;
+	}
+
+	cache->next_blk = (i + 1) % cache->entries;
+	entry = &cache->entry[i];
+
+	cache->unused--;
+	entry->block = block;
+	entry->refcount = 1;
+	entry->pending = 1;
+	entry->error = 0;
+
+	return entry;
+}
+
 /*
  * Look-up block in cache, and increment usage count.  If not in cache, read
  * and decompress it from disk.
@@ -55,44 +105,19 @@
 struct squashfs_cache_entry *squashfs_cache_get(struct super_block *sb,
 	struct squashfs_cache *cache, u64 block, int length)
 {
-	int i, n;
+	int i;
 	struct squashfs_cache_entry *entry;
 
 	while (1) {
-		for (i = cache->curr_blk, n = 0; n < cache->entries; n++) {
-			if (cache->entry[i].block == block) {
-				cache->curr_blk = i;
-				break;
-			}
-			i = (i + 1) % cache->entries;
-		}
-
-		if (n == cache->entries) {
+		i = squashfs_cache_find(cache, block);
 
+		if (i < 0) {
 			/*
-			 * At least one unused cache entry.  A simple
-			 * round-robin strategy is used to choose the entry to
-			 * be evicted from the cache.
+			 * At least one unused cache entry.  Evict one and
+			 * fill it in from disk.
 			 */
-			i = cache->next_blk;
-			for (n = 0; n < cache->entries; n++) {
-				if (cache->entry[i].refcount == 0)
-					break;
-				i = (i + 1) % cache->entries;
-			}
-
-			cache->next_blk = (i + 1) % cache->entries;
-			entry = &cache->entry[i];
-
-			/*
-			 * Initialise chosen cache entry, and fill it in from
-			 * disk.
-			 */
-			cache->unused--;
-			entry->block = block;
-			entry->refcount = 1;
-			entry->pending = 1;
-			entry->error = 0;
+			entry = squashfs_cache_alloc(cache, block);
+			i = entry - cache->entry;
 
 			entry->length = squashfs_read_data(sb, block, length,
 				&entry->next_index, entry->actor);
@@ -111,6 +136,7 @@ struct squashfs_cache_entry *squashfs_cache_get(struct super_block *sb,
 		 * previously unused there's one less cache entry available
 		 * for reuse.
 		 */
+		cache->curr_blk = i;
 		entry = &cache->entry[i];
 		if (entry->refcount == 0)
 			cache->unused--;
@@ -348,6 +374,95 @@ struct squashfs_cache_entry *squashfs_get_datablock(struct super_block *sb,
 	return squashfs_cache_get(sb, msblk->read_page, start_block, length);
 }
 
+/*
+ * Read the n consecutive datablocks starting at <start_block> into the data
+ * cache using a single device read, stopping at the first one which is
+ * already cached.  lengths[] holds the on-disk length fields of the
+ * datablocks.  If dest is given, the first datablock is decompressed straight
+ * into it instead of into the cache; dest must hold a whole block.
+ *
+ * Returns the decompressed length of the first datablock if dest is given,
+ * zero otherwise, or a negative error code.  Datablocks which could not be
+ * read are not cached, so a later squashfs_get_datablock() retries them.
+ */
+int squashfs_readahead_datablocks(struct super_block *sb, u64 start_block,
+				  const int *lengths, int n, void *dest)
+{
+	struct squashfs_sb_info *msblk = sb->s_fs_info;
+	struct squashfs_cache *cache = msblk->read_page;
+	struct squashfs_cache_entry *entry[SQUASHFS_MAX_READAHEAD] = {};
+	struct squashfs_page_actor *actor[SQUASHFS_MAX_READAHEAD];
+	int res[SQUASHFS_MAX_READAHEAD];
+	void **pages = NULL;
+	u64 block = start_block;
+	int i, ret;
+
+	n = min(n, SQUASHFS_MAX_READAHEAD);
+
+	if (dest) {
+		i = squashfs_cache_find(cache, start_block);
+		if (i >= 0) {
+			struct squashfs_cache_entry *buffer = &cache->entry[i];
+
+			ret = buffer->error ? : squashfs_copy_data(dest,
+					buffer, 0, cache->block_size);
+			return ret;
+		}
+
+		pages = calloc(cache->pages, sizeof(*pages));
+		if (pages == NULL)
+			return -ENOMEM;
+
+		for (i = 0; i < cache->pages; i++)
+			pages[i] = dest + i * PAGE_CACHE_SIZE;
+
+		actor[0] = squashfs_page_actor_init(pages, cache->pages, 0);
+		if (actor[0] == NULL) {
+			kfree(pages);
+			return -ENOMEM;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		if (i || !dest) {
+			if (!cache->unused ||
+			    squashfs_cache_find(cache, block) >= 0)
+				break;
+			entry[i] = squashfs_cache_alloc(cache, block);
+			actor[i] = entry[i]->actor;
+		}
+		block += SQUASHFS_COMPRESSED_SIZE_BLOCK(lengths[i]);
+	}
+	n = i;
+
+	ret = n ? squashfs_read_datablocks(sb, start_block, n, lengths, actor,
+					   res) : 0;
+
+	for (i = 0, block = start_block; i < n; i++) {
+		if (entry[i]) {
+			if (ret || res[i] < 0) {
+				entry[i]->block = SQUASHFS_INVALID_BLK;
+			} else {
+				entry[i]->length = res[i];
+				entry[i]->next_index = block +
+					SQUASHFS_COMPRESSED_SIZE_BLOCK(lengths[i]);
+			}
+			entry[i]->pending = 0;
+			squashfs_cache_put(entry[i]);
+		}
+		block += SQUASHFS_COMPRESSED_SIZE_BLOCK(lengths[i]);
+	}
+
+	if (dest) {
+		kfree(actor[0]);
+		kfree(pages);
+		if (!ret)
+			ret = res[0];
+	}
+
+	return ret;
+}
+
 /*
  * Read a filesystem table (uncompressed sequence of bytes) from disk
  */
@@ -19,6 +19,10 @@
  * decompressor.h
  */
 
+/*
+ * decompress() reads its input from the devblksize sized buffers in bh, which
+ * remain owned by the caller.
+ */
 struct squashfs_decompressor {
 	void	*(*init)(struct squashfs_sb_info *, void *);
 	void	*(*comp_opts)(struct squashfs_sb_info *, void *, int);
@@ -306,15 +306,16 @@ static int fill_meta_index(struct inode *inode, int index,
 
 
 /*
- * Get the on-disk location and compressed size of the datablock
- * specified by index.  Fill_meta_index() does most of the work.
+ * Get the on-disk location of the datablock specified by index, and the
+ * on-disk size fields of count datablocks starting with it.  Fill_meta_index()
+ * does most of the work.
  */
-static int read_blocklist(struct inode *inode, int index, u64 *block)
+static int read_blocklist_sizes(struct inode *inode, int index, u64 *block,
+				__le32 *sizes, int count)
 {
 	u64 start;
 	long long blks;
 	int offset;
-	__le32 size;
 	int res = fill_meta_index(inode, index, &start, &offset, block);
 
 	TRACE("read_blocklist: res %d, index %d, start 0x%llx, offset"
@@ -338,15 +339,103 @@ static int read_blocklist(struct inode *inode, int index, u64 *block)
 	}
 
 	/*
-	 * Read length of block specified by index.
+	 * Read lengths of blocks starting at index.
 	 */
-	res = squashfs_read_metadata(inode->i_sb, &size, &start, &offset,
-			sizeof(size));
+	res = squashfs_read_metadata(inode->i_sb, sizes, &start, &offset,
+			count * sizeof(*sizes));
+	if (res < 0)
+		return res;
+	return 0;
+}
+
+
+/*
+ * Get the on-disk location and compressed size of the datablock
+ * specified by index.
+ */
+static int read_blocklist(struct inode *inode, int index, u64 *block)
+{
+	__le32 size;
+	int res = read_blocklist_sizes(inode, index, block, &size, 1);
+
 	if (res < 0)
 		return res;
 	return squashfs_block_size(size);
 }
 
+
+/*
+ * Read datablock index, located at block with on-disk size bsize, and up to
+ * msblk->readahead - 1 following datablocks of the file with a single device
+ * read into the data cache.  If dest is given, datablock index is decompressed
+ * straight into it.  See squashfs_readahead_datablocks() for the return value.
+ */
+static int squashfs_readahead(struct inode *inode, int index, u64 block,
+			      int bsize, void *dest)
+{
+	struct squashfs_sb_info *msblk = inode->i_sb->s_fs_info;
+	int lengths[SQUASHFS_MAX_READAHEAD];
+	__le32 sizes[SQUASHFS_MAX_READAHEAD - 1];
+	int i, n, blocks;
+	u64 next;
+
+	/* the tail end is only in the block list if it is not a fragment */
+	blocks = i_size_read(inode) >> msblk->block_log;
+	if (squashfs_i(inode)->fragment_block == SQUASHFS_INVALID_BLK &&
+	    (i_size_read(inode) & (msblk->block_size - 1)))
+		blocks++;
+
+	n = clamp(blocks - index, 1, msblk->readahead);
+	lengths[0] = bsize;
+
+	if (n > 1 && read_blocklist_sizes(inode, index + 1, &next, sizes,
+					  n - 1) == 0) {
+		for (i = 1; i < n; i++) {
+			lengths[i] = squashfs_block_size(sizes[i - 1]);
+			/* sparse blocks end the run */
+			if (lengths[i] <= 0)
+				break;
+		}
+		n = i;
+	} else {
+		n = 1;
+	}
+
+	return squashfs_readahead_datablocks(inode->i_sb, block, lengths, n,
+					     dest);
+}
+
+
+/*
+ * Read the whole datablock index of a file straight into dest, without going
+ * through the page buffers.  Fails with -EAGAIN for the tail end of the file,
+ * which has to be read with squashfs_readpage().
+ */
+int squashfs_read_block(struct inode *inode, int index, void *dest)
+{
+	struct squashfs_sb_info *msblk = inode->i_sb->s_fs_info;
+	u64 block = 0;
+	int bsize, res;
+
+	if (index >= i_size_read(inode) >> msblk->block_log)
+		return -EAGAIN;
+
+	bsize = read_blocklist(inode, index, &block);
+	if (bsize < 0)
+		return bsize;
+
+	if (bsize == 0) {
+		memset(dest, 0, msblk->block_size);
+		return 0;
+	}
+
+	res = squashfs_readahead(inode, index, block, bsize, dest);
+	if (res < 0)
+		return res;
+
+	return res == msblk->block_size ? 0 : -EIO;
+}
+
 static int squashfs_fill_page(char *dest, struct squashfs_cache_entry *buffer,
 			      int offset, int avail)
 {
@@ -441,10 +530,14 @@ int squashfs_readpage(struct file *file, struct page *page)
 		if (bsize < 0)
 			goto out;
 
-		if (bsize == 0)
+		if (bsize == 0) {
 			res = squashfs_readpage_sparse(page, expected);
-		else
+		} else {
+			if (msblk->readahead > 1)
+				squashfs_readahead(inode, index, block, bsize,
+						   NULL);
 			res = squashfs_readpage_block(page, block, bsize, expected);
+		}
 	} else
 		res = squashfs_readpage_fragment(page, expected);
 
@@ -34,6 +34,7 @@ char *squashfs_devread(struct squashfs_sb_info *fs, int byte_offset,
 	size = cdev_read(fs->cdev, buf, byte_len, byte_offset, 0);
 	if (size < 0) {
 		dev_err(fs->dev, "read error: %pe\n", ERR_PTR(size));
+		free(buf);
 		return NULL;
 	}
 
@@ -205,6 +206,7 @@ static int squashfs_read(struct file *f, void *buf, size_t insize)
 	unsigned int now;
 	void *pagebuf;
 	struct squashfs_page *page = f->private_data;
+	struct squashfs_sb_info *msblk = page->real_page.inode->i_sb->s_fs_info;
 
 	/* Read till end of current buffer page */
 	ofs = pos % PAGE_CACHE_SIZE;
@@ -219,8 +221,18 @@ static int squashfs_read(struct file *f, void *buf, size_t insize)
 		buf += now;
 	}
 
-	/* Do full buffer pages */
+	/* Do full buffer pages, whole blocks straight into the buffer */
 	while (size >= PAGE_CACHE_SIZE) {
+		if (!(pos & (msblk->block_size - 1)) &&
+		    size >= msblk->block_size &&
+		    !squashfs_read_block(page->real_page.inode,
+					 pos >> msblk->block_log, buf)) {
+			size -= msblk->block_size;
+			pos += msblk->block_size;
+			buf += msblk->block_size;
+			continue;
+		}
+
 		squashfs_read_buf(page, pos, &pagebuf);
 
 		memcpy(buf, pagebuf, PAGE_CACHE_SIZE);
@@ -64,6 +64,9 @@ extern const struct file_operations squashfs_file_operations;
 /* block.c */
 extern int squashfs_read_data(struct super_block *, u64, int, u64 *,
 				struct squashfs_page_actor *);
+extern int squashfs_read_datablocks(struct super_block *, u64, int,
+				const int *, struct squashfs_page_actor **,
+				int *);
 
 /* cache.c */
 extern struct squashfs_cache *squashfs_cache_init(char *, int, int);
@@ -78,6 +81,8 @@ extern struct squashfs_cache_entry *squashfs_get_fragment(struct super_block *,
 				u64, int);
 extern struct squashfs_cache_entry *squashfs_get_datablock(struct super_block *,
 				u64, int);
+extern int squashfs_readahead_datablocks(struct super_block *, u64,
+				const int *, int, void *);
 extern void *squashfs_read_table(struct super_block *, u64, int);
 
 /* decompressor.c */
@@ -98,6 +103,7 @@ extern __le64 *squashfs_read_fragment_index_table(struct super_block *,
 /* file.c */
 int squashfs_copy_cache(struct page *, struct squashfs_cache_entry *, int,
 				int);
+int squashfs_read_block(struct inode *, int, void *);
 extern int squashfs_readpage(struct file *file, struct page *page);
 
 /* file_xxx.c */
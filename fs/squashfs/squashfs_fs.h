@@ -216,6 +216,10 @@ static inline int squashfs_block_size(__le32 raw)
 
 /* cached data constants for filesystem */
 #define SQUASHFS_CACHED_BLKS		8
+#define SQUASHFS_CACHED_DATA		4
+
+/* maximum number of datablocks read with a single device read */
+#define SQUASHFS_MAX_READAHEAD		16
 
 /* meta index cache */
 #define SQUASHFS_META_INDEXES	(SQUASHFS_METADATA_SIZE / sizeof(unsigned int))
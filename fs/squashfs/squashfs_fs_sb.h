@@ -77,6 +77,10 @@ struct squashfs_sb_info {
 	unsigned int				inodes;
 	unsigned int				fragments;
 	int					xattr_ids;
+	int					cached_blks;
+	int					cached_fragments;
+	int					cached_data;
+	int					readahead;
 	struct cdev				*cdev;
 	struct device				*dev;
 };
@@ -26,6 +26,7 @@
 #define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
 
 #include <errno.h>
+#include <parseopt.h>
 #include <linux/fs.h>
 #include <linux/kernel.h>
 #include <linux/pagemap.h>
@@ -66,6 +67,40 @@ static const struct squashfs_decompressor *supported_squashfs_filesystem(short
 	return decompressor;
 }
 
+/*
+ * Parse the cache size mount options: "meta_cache", "frag_cache" and
+ * "data_cache" set the number of cached metadata blocks, fragment blocks and
+ * datablocks, "readahead" the number of datablocks read at once.  Readahead
+ * defaults to and is limited by the data cache size.
+ */
+static void squashfs_parse_options(struct squashfs_sb_info *msblk,
+				   const char *options)
+{
+	unsigned short meta = SQUASHFS_CACHED_BLKS;
+	unsigned short frag = SQUASHFS_CACHED_FRAGMENTS;
+	unsigned short data = SQUASHFS_CACHED_DATA;
+	unsigned short readahead = 0;
+
+	if (options) {
+		parseopt_hu(options, "meta_cache", &meta);
+		parseopt_hu(options, "frag_cache", &frag);
+		parseopt_hu(options, "data_cache", &data);
+		parseopt_hu(options, "readahead", &readahead);
+	}
+
+	msblk->cached_blks = max_t(int, meta, 1);
+	msblk->cached_fragments = max_t(int, frag, 1);
+	msblk->cached_data = max_t(int, data, squashfs_max_decompressors());
+	msblk->readahead = readahead ? : msblk->cached_data;
+	msblk->readahead = clamp_t(int, msblk->readahead, 1,
+				   min(msblk->cached_data,
+				       SQUASHFS_MAX_READAHEAD));
+
+	TRACE("caches: %d metadata, %d fragment, %d data, readahead %d\n",
+	      msblk->cached_blks, msblk->cached_fragments, msblk->cached_data,
+	      msblk->readahead);
+}
+
 void squashfs_put_super(struct super_block *sb)
 {
 	if (sb->s_fs_info) {
@@ -112,6 +147,8 @@ static int squashfs_fill_super(struct super_block *sb, void *data, int silent)
 	msblk->cdev = fsdev->cdev;
 	msblk->dev = &fsdev->dev;
 
+	squashfs_parse_options(msblk, fsdev->options);
+
 	msblk->devblksize = 1024;
 	msblk->devblksize_log2 = ffz(~msblk->devblksize);
 
@@ -222,13 +259,13 @@ static int squashfs_fill_super(struct super_block *sb, void *data, int silent)
 	err = -ENOMEM;
 
 	msblk->block_cache = squashfs_cache_init("metadata",
-			SQUASHFS_CACHED_BLKS, SQUASHFS_METADATA_SIZE);
+			msblk->cached_blks, SQUASHFS_METADATA_SIZE);
 	if (msblk->block_cache == NULL)
 		goto failed_mount;
 
 	/* Allocate read_page block */
 	msblk->read_page = squashfs_cache_init("data",
-		squashfs_max_decompressors(), msblk->block_size);
+		msblk->cached_data, msblk->block_size);
 	if (msblk->read_page == NULL) {
 		ERROR("Failed to allocate read_page block\n");
 		goto failed_mount;
@@ -265,7 +302,7 @@ static int squashfs_fill_super(struct super_block *sb, void *data, int silent)
 	if (fragments == 0)
 		goto check_directory_table;
 	msblk->fragment_cache = squashfs_cache_init("fragment",
-		SQUASHFS_CACHED_FRAGMENTS, msblk->block_size);
+		msblk->cached_fragments, msblk->block_size);
 	if (msblk->fragment_cache == NULL) {
 		err = -ENOMEM;
 		goto failed_mount;
@@ -162,7 +162,7 @@ static int squashfs_xz_uncompress(struct squashfs_sb_info *msblk, void *strm,
 		xz_err = xz_dec_run(stream->state, &stream->buf);
 
 		if (stream->buf.in_pos == stream->buf.in_size && k < b)
-			kfree(bh[k++]);
+			k++;
 	} while (xz_err == XZ_OK);
 
 	squashfs_finish_page(output);
@@ -173,9 +173,6 @@ static int squashfs_xz_uncompress(struct squashfs_sb_info *msblk, void *strm,
 	return total + stream->buf.out_pos;
 
 out:
-	for (; k < b; k++)
-		kfree(bh[k]);
-
 	return -EIO;
 }
 
@@ -34,6 +34,7 @@
 #include <linux/log2.h>
 #include <linux/stat.h>
 #include <linux/err.h>
+#include <parseopt.h>
 #include "ubifs.h"
 #include <mtd/ubi-user.h>
 
@@ -656,11 +657,35 @@ static int check_volume_empty(struct ubifs_info *c)
 static int parse_standard_option(const char *option)
 */
 
-/*
- * removed in barebox
-static int ubifs_parse_options(struct ubifs_info *c, char *options,
-			       int is_remount)
+/**
+ * ubifs_parse_options - parse mount parameters.
+ * @c: UBIFS file-system description object
+ * @options: parameters to parse
+ *
+ * barebox only knows the "bulk_read" and "no_bulk_read" options. Without
+ * either of them, global.ubifs.bulk_read decides.
  */
+static void ubifs_parse_options(struct ubifs_info *c, const char *options)
+{
+	bool opt;
+
+	c->bulk_read = !!ubifs_bulk_read;
+
+	if (!options)
+		return;
+
+	parseopt_b(options, "bulk_read", &opt);
+	if (opt) {
+		c->mount_opts.bulk_read = 2;
+		c->bulk_read = 1;
+	}
+
+	parseopt_b(options, "no_bulk_read", &opt);
+	if (opt) {
+		c->mount_opts.bulk_read = 1;
+		c->bulk_read = 0;
+	}
+}
 
 /**
  * destroy_journal - destroy journal data structures.
@@ -691,10 +716,29 @@ static void destroy_journal(struct ubifs_info *c)
 	free_buds(c);
 }
 
-/*
- * removed in barebox
-static void bu_init(struct ubifs_info *c)
+/**
+ * bu_init - initialize bulk-read information.
+ * @c: UBIFS file-system description object
  */
+static void bu_init(struct ubifs_info *c)
+{
+	ubifs_assert(c, c->bulk_read == 1);
+
+	if (c->bu.buf)
+		return; /* Already initialized */
+
+	c->bu.buf = kmalloc(c->max_bu_buf_len, GFP_KERNEL | __GFP_NOWARN);
+	if (!c->bu.buf) {
+		/* Just disable bulk-read */
+		ubifs_warn(c, "cannot allocate %d bytes of memory for bulk-read, disabling it",
+			   c->max_bu_buf_len);
+		c->mount_opts.bulk_read = 1;
+		c->bulk_read = 0;
+		return;
+	}
+
+	c->bu.buf_len = c->max_bu_buf_len;
+}
 
 /*
  * removed in barebox
@@ -850,6 +894,9 @@ static int mount_ubifs(struct ubifs_info *c)
 		/* c->lst.taken_empty_lebs is always 0 in ro implementation */
 	}
 
+	if (c->bulk_read == 1)
+		bu_init(c);
+
 	c->mounting = 0;
 
 	ubifs_msg(c, "UBIFS: mounted UBI device %d, volume %d, name \"%s\"%s",
@@ -1231,6 +1278,8 @@ int ubifs_get_super(struct device *dev, struct ubi_volume_desc *ubi,
 
 	c->ubi = ubi;
 
+	ubifs_parse_options(c, fsdev->options);
+
 	err = ubifs_fill_super(sb, NULL, silent);
 	if (err) {
 		ubifs_assert(c, err < 0);
@@ -286,23 +286,13 @@ int __init ubifs_compressors_init(void)
 
 /* file.c */
 
-static int read_block(struct inode *inode, void *addr, unsigned int block,
-		      struct ubifs_data_node *dn)
+static int decompress_block(struct inode *inode, void *addr, unsigned int block,
+			    struct ubifs_data_node *dn)
 {
 	struct ubifs_info *c = inode->i_sb->s_fs_info;
 	int err, len, out_len;
-	union ubifs_key key;
 	unsigned int dlen;
 
-	data_key_init(c, &key, inode->i_ino, block);
-	err = ubifs_tnc_lookup(c, &key, dn);
-	if (err) {
-		if (err == -ENOENT)
-			/* Not found, so it must be a hole */
-			memset(addr, 0, UBIFS_BLOCK_SIZE);
-		return err;
-	}
-
 	ubifs_assert(c, le64_to_cpu(dn->ch.sqnum) > ubifs_inode(inode)->creat_sqnum);
 
 	len = le32_to_cpu(dn->size);
@@ -333,11 +323,38 @@ static int read_block(struct inode *inode, void *addr, unsigned int block,
 	return -EINVAL;
 }
 
+static int read_block(struct inode *inode, void *addr, unsigned int block,
+		      struct ubifs_data_node *dn)
+{
+	struct ubifs_info *c = inode->i_sb->s_fs_info;
+	union ubifs_key key;
+	int err;
+
+	data_key_init(c, &key, inode->i_ino, block);
+	err = ubifs_tnc_lookup(c, &key, dn);
+	if (err) {
+		if (err == -ENOENT)
+			/* Not found, so it must be a hole */
+			memset(addr, 0, UBIFS_BLOCK_SIZE);
+		return err;
+	}
+
+	return decompress_block(inode, addr, block, dn);
+}
+
 struct ubifs_file {
 	struct inode *inode;
 	void *buf;
 	unsigned int block;
 	struct ubifs_data_node *dn;
+
+	/* block expected next if the file is read sequentially */
+	unsigned int next_block;
+
+	/* readahead window, filled by bulk-reads */
+	void *ra_buf;
+	unsigned int ra_block;
+	unsigned int ra_cnt;
 };
 
 int ubifs_open(struct inode *inode, struct file *file)
@@ -360,6 +377,7 @@ int ubifs_close(struct inode *inode, struct file *f)
 {
 	struct ubifs_file *uf = f->private_data;
 
+	free(uf->ra_buf);
 	free(uf->buf);
 	free(uf->dn);
 	free(uf);
@@ -367,24 +385,134 @@ int ubifs_close(struct inode *inode, struct file *f)
 	return 0;
 }
 
+/*
+ * bulk_read - read a run of data nodes with a single flash read
+ * @uf: the file to read from
+ * @block: the first block to read
+ * @dst: buffer for the first @nblocks blocks
+ * @nblocks: number of blocks that fit into @dst
+ *
+ * Data nodes of consecutive blocks usually are written consecutively to the
+ * same LEB. Find such a run starting at @block in the TNC and read it with one
+ * flash read. Blocks up to @nblocks are decompressed directly into @dst, the
+ * remaining ones into the readahead window of @uf.
+ *
+ * Returns the number of blocks stored in @dst, 0 if @block can't be bulk-read
+ * or a negative error code.
+ */
+static int bulk_read(struct ubifs_file *uf, unsigned int block, void *dst,
+		     unsigned int nblocks)
+{
+	struct inode *inode = uf->inode;
+	struct ubifs_info *c = inode->i_sb->s_fs_info;
+	struct bu_info *bu = &c->bu;
+	unsigned int b, last, cnt;
+	void *node, *addr;
+	int err, i = 0;
+
+	data_key_init(c, &bu->key, inode->i_ino, block);
+
+	err = ubifs_tnc_get_bu_keys(c, bu);
+	if (err)
+		return err;
+
+	/* leave holes at the start to read_block() */
+	if (!bu->cnt || key_block(c, &bu->zbranch[0].key) != block)
+		return 0;
+
+	err = ubifs_tnc_bulk_read(c, bu);
+	if (err)
+		return err;
+
+	last = key_block(c, &bu->zbranch[bu->cnt - 1].key);
+	cnt = last - block + 1;
+
+	uf->ra_cnt = 0;
+	if (cnt > nblocks) {
+		if (!uf->ra_buf)
+			uf->ra_buf = xmalloc(UBIFS_MAX_BULK_READ * UBIFS_BLOCK_SIZE);
+		uf->ra_block = block + nblocks;
+	}
+
+	node = bu->buf;
+
+	for (b = block; b <= last; b++) {
+		if (b < block + nblocks)
+			addr = dst + (b - block) * UBIFS_BLOCK_SIZE;
+		else
+			addr = uf->ra_buf + (b - uf->ra_block) * UBIFS_BLOCK_SIZE;
+
+		if (key_block(c, &bu->zbranch[i].key) != b) {
+			/* Not found, so it must be a hole */
+			memset(addr, 0, UBIFS_BLOCK_SIZE);
+			continue;
+		}
+
+		err = decompress_block(inode, addr, b, node);
+		if (err) {
+			uf->ra_cnt = 0;
+			return err;
+		}
+
+		node += ALIGN(bu->zbranch[i].len, 8);
+		i++;
+	}
+
+	if (cnt > nblocks)
+		uf->ra_cnt = cnt - nblocks;
+
+	uf->next_block = last + 1;
+
+	return min(cnt, nblocks);
+}
+
+static bool block_in_ra(struct ubifs_file *uf, unsigned int block)
+{
+	return block >= uf->ra_block && block - uf->ra_block < uf->ra_cnt;
+}
+
 static int ubifs_get_block(struct ubifs_file *uf, unsigned int pos)
 {
-	int ret;
+	struct ubifs_info *c = uf->inode->i_sb->s_fs_info;
 	unsigned int block = pos / UBIFS_BLOCK_SIZE;
+	int ret;
 
-	if (block != uf->block) {
-		ret = read_block(uf->inode, uf->buf, block, uf->dn);
-		if (ret && ret != -ENOENT)
-			return ret;
+	if (block == uf->block)
+		return 0;
+
+	if (block_in_ra(uf, block)) {
+		memcpy(uf->buf, uf->ra_buf + (block - uf->ra_block) * UBIFS_BLOCK_SIZE,
+		       UBIFS_BLOCK_SIZE);
 		uf->block = block;
+		uf->next_block = block + 1;
+		return 0;
+	}
+
+	/* Sequential access, so fill the readahead window */
+	if (c->bulk_read && block == uf->next_block) {
+		uf->block = -1;
+		ret = bulk_read(uf, block, uf->buf, 1);
+		if (ret < 0)
+			return ret;
+		if (ret) {
+			uf->block = block;
+			return 0;
+		}
 	}
 
+	ret = read_block(uf->inode, uf->buf, block, uf->dn);
+	if (ret && ret != -ENOENT)
+		return ret;
+	uf->block = block;
+	uf->next_block = block + 1;
+
 	return 0;
 }
 
 int ubifs_read(struct file *f, void *buf, size_t insize)
 {
 	struct ubifs_file *uf = f->private_data;
+	struct ubifs_info *c = uf->inode->i_sb->s_fs_info;
 	unsigned int pos = f->f_pos;
 	unsigned int ofs;
 	unsigned int now;
@@ -406,16 +534,31 @@ int ubifs_read(struct file *f, void *buf, size_t insize)
 		buf += now;
 	}
 
-	/* Do full blocks */
+	/* Do full blocks, bulk-reading straight into the buffer if possible */
 	while (size >= UBIFS_BLOCK_SIZE) {
-		ret = ubifs_get_block(uf, pos);
-		if (ret)
-			return ret;
+		unsigned int block = pos / UBIFS_BLOCK_SIZE;
+
+		ret = 0;
+		if (c->bulk_read && !block_in_ra(uf, block) && block != uf->block) {
+			ret = bulk_read(uf, block, buf, size / UBIFS_BLOCK_SIZE);
+			if (ret < 0)
+				return ret;
+		}
+
+		if (ret) {
+			now = ret * UBIFS_BLOCK_SIZE;
+		} else {
+			ret = ubifs_get_block(uf, pos);
+			if (ret)
+				return ret;
 
-		memcpy(buf, uf->buf, UBIFS_BLOCK_SIZE);
-		size -= UBIFS_BLOCK_SIZE;
-		pos += UBIFS_BLOCK_SIZE;
-		buf += UBIFS_BLOCK_SIZE;
+			now = UBIFS_BLOCK_SIZE;
+			memcpy(buf, uf->buf, now);
+		}
+
+		size -= now;
+		pos += now;
+		buf += now;
 	}
 
 	/* And the rest */
@@ -545,6 +688,7 @@ static int zstd_decomp_init(void)
 
 int ubifs_allow_encrypted;
 int ubifs_allow_authenticated_unauthenticated;
+int ubifs_bulk_read = 1;
 
 static int ubifs_init(void)
 {
@@ -565,6 +709,7 @@ static int ubifs_init(void)
 	globalvar_add_simple_bool("ubifs.allow_encrypted", &ubifs_allow_encrypted);
 	globalvar_add_simple_bool("ubifs.allow_authenticated_unauthenticated",
 				  &ubifs_allow_authenticated_unauthenticated);
+	globalvar_add_simple_bool("ubifs.bulk_read", &ubifs_bulk_read);
 
 	return register_fs_driver(&ubifs_driver);
 }
@@ -575,3 +720,5 @@ BAREBOX_MAGICVAR(global.ubifs.allow_encrypted,
 		 "If true, allow to mount UBIFS with encrypted files");
 BAREBOX_MAGICVAR(global.ubifs.allow_authenticated_unauthenticated,
 		 "If true, allow to mount authenticated UBIFS images without doing authentication");
+BAREBOX_MAGICVAR(global.ubifs.bulk_read,
+		 "If true, read runs of consecutive data nodes with a single flash read");
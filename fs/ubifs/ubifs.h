@@ -50,6 +50,7 @@ struct iattr;
 struct kstat;
 extern int ubifs_allow_encrypted;
 extern int ubifs_allow_authenticated_unauthenticated;
+extern int ubifs_bulk_read;
 
 #include <digest.h>
 
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <linux/types.h>
+
+/*
+ * An arena hands out bump-pointer allocations from a small number of
+ * larger blocks. Individual allocations can't be freed, the whole arena
+ * is released at once with arena_free().
+ */
+struct arena;
+
+struct arena_stats {
+	size_t arenas;		/* currently live arenas */
+	size_t blocks;		/* blocks allocated by them */
+	size_t size;		/* bytes taken from malloc */
+	size_t used;		/* bytes handed out to users */
+	size_t peak;		/* maximum of size since boot */
+};
+
+struct arena *arena_new(void);
+void arena_free(struct arena *arena);
+
+void *arena_alloc(struct arena *arena, size_t size);
+void *arena_zalloc(struct arena *arena, size_t size);
+char *arena_strdup(struct arena *arena, const char *str);
+const char *arena_strdup_const(struct arena *arena, const char *str);
+
+bool arena_contains(const void *mem);
+
+void arena_get_stats(struct arena_stats *stats);
+void arena_print_stats(void);
+
+#endif /* __ARENA_H__ */
@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __BLSPEC_H
+#define __BLSPEC_H
+
+#include <linux/list.h>
+#include <linux/types.h>
+
+struct device_node;
+
+/*
+ * Scan results of a file that only depend on its contents. Files are
+ * identified by the UUID of the partition they live on, their path,
+ * modification time and size.
+ */
+struct blspec_cache_entry {
+	struct list_head list;
+	char *partuuid;
+	char *path;
+	time_t mtime;
+	loff_t size;
+	/* looked up since the last blspec_cache_scan_begin() */
+	bool seen;
+
+	/* loader entries: the parsed key/value pairs */
+	struct device_node *node;
+	char *sortkey;
+
+	/* devicetrees: the result of the compatibility check */
+	bool checked;
+	bool compatible;
+};
+
+struct blspec_cache_entry *blspec_cache_lookup(const char *partuuid,
+					       const char *path,
+					       time_t mtime, loff_t size);
+void blspec_cache_set_compat(const char *compat);
+void blspec_cache_scan_begin(const char *partuuid, const char *root);
+void blspec_cache_scan_end(const char *partuuid, const char *root);
+
+#endif /* __BLSPEC_H */
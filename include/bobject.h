@@ -9,12 +9,19 @@
 /**
  * struct bobject - barebox object
  * @name: name of object (must be first member)
- * @parameters: list of struct param_d parameters
+ * @parameters: list of struct param_d parameters, sorted by name
+ * @param_hash: hashed name index into @parameters, allocated once the
+ *              object has enough parameters to make it worthwhile
+ * @param_hash_bits: log2 of the number of @param_hash buckets
+ * @num_params: number of entries in @parameters
  * @local: name of bobject is not unique across the system
  */
 struct bobject {
 	char			*name;
 	struct list_head	parameters;
+	struct hlist_head	*param_hash;
+	unsigned int		param_hash_bits;
+	unsigned int		num_params;
 	u32			local:1;
 };
 
@@ -34,6 +41,9 @@ static inline void bobject_init(struct bobject *bobj)
 	 * so initialize it even if !IS_ENABLED(CONFIG_PARAMETER)
 	 */
 	INIT_LIST_HEAD(&bobj->parameters);
+	bobj->param_hash = NULL;
+	bobj->param_hash_bits = 0;
+	bobj->num_params = 0;
 }
 
 struct bobject *bobject_alloc(const char *name);
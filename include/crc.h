@@ -15,9 +15,28 @@ extern u16 crc_itu_t(u16 crc, const u8 *buffer, size_t len);
 uint32_t crc32(uint32_t, const void *, unsigned int);
 uint32_t crc32_be(uint32_t, const void *, unsigned int);
 uint32_t crc32_no_comp(uint32_t, const void *, unsigned int);
+uint32_t crc32_no_comp_bytewise(uint32_t, const void *, unsigned int);
+uint32_t crc32_no_comp_sliceby8(uint32_t, const void *, unsigned int);
 int file_crc(char *filename, unsigned long start, unsigned long size,
 	     unsigned long *crc, unsigned long *total);
 
 uint32_t __pi_crc32(uint32_t, const void *, unsigned int);
 
+#ifdef CONFIG_ARCH_HAS_CRC32
+/* Architecture-accelerated CRC32 (no ones complement), if the CPU supports it */
+bool crc32_arch_available(void);
+uint32_t crc32_no_comp_arch(uint32_t, const void *, unsigned int);
+#else
+static inline bool crc32_arch_available(void)
+{
+	return false;
+}
+
+static inline uint32_t crc32_no_comp_arch(uint32_t crc, const void *buf,
+					  unsigned int len)
+{
+	return crc32_no_comp_sliceby8(crc, buf, len);
+}
+#endif
+
 #endif /* __INCLUDE_CRC_H */
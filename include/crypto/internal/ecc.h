@@ -268,7 +268,9 @@ bool ecc_point_is_zero(const struct ecc_point *point);
  * @curve:		curve
  *
  * Returns result = x * p + x * q over the curve.
- * This works faster than two multiplications and addition.
+ * This works faster than two multiplications and addition. Passing the
+ * curve's generator point as @p makes use of a cached table of its
+ * multiples.
  */
 void ecc_point_mult_shamir(const struct ecc_point *result,
 			   const u64 *x, const struct ecc_point *p,
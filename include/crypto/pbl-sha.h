@@ -5,9 +5,22 @@
 
 #include <digest.h>
 #include <types.h>
+#include <crypto/sha.h>
 
 int sha256_init(struct digest *desc);
 int sha256_update(struct digest *desc, const void *data, unsigned long len);
 int sha256_final(struct digest *desc, u8 *out);
 
+/* context size large enough for all SHA-256 implementations in PBL */
+#define PBL_SHA256_CTX_SIZE	(sizeof(struct sha256_state) + sizeof(u64))
+
+/* the generic SHA-256 implementation */
+extern struct digest_algo m256;
+
+/*
+ * Returns the SHA-256 implementation to be used in PBL. This is the generic
+ * one, unless an architecture provides an accelerated one.
+ */
+struct digest_algo *pbl_sha256_algo(void);
+
 #endif /* __PBL-SHA_H_ */
@@ -54,6 +54,20 @@ struct public_key *rsa_of_read_key(struct device_node *node);
 int rsa_verify(const struct rsa_public_key *key, const uint8_t *sig,
 			  const uint32_t sig_len, const uint8_t *hash,
 			  enum hash_algo algo);
+
+/**
+ * rsa_pow_mod() - in-place public exponentiation
+ *
+ * Uses 64-bit limbs and sliding-window exponentiation where available.
+ * rsa_pow_mod_generic() always uses the 32-bit square-and-multiply
+ * implementation.
+ *
+ * @key:	RSA key
+ * @inout:	Big-endian word array containing value and result
+ * @return 0 on success, -ve on error
+ */
+int rsa_pow_mod(const struct rsa_public_key *key, void *inout);
+int rsa_pow_mod_generic(const struct rsa_public_key *key, void *inout);
 #else
 static inline int rsa_verify(const struct rsa_public_key *key, const uint8_t *sig,
 			  const uint32_t sig_len, const uint8_t *hash,
@@ -57,6 +57,8 @@ struct of_device_id;
  * @bus: Type of bus device is on.
  * @dma_mask: DMA mask.
  * @dma_offset: DMA offset.
+ * @dma_alignment: Required alignment of DMA buffers, 0 if none.
+ * @dma_max_seg_size: Maximum length of a DMA segment, 0 if unlimited.
  * @detect: For devices which take longer to probe, this is called when the driver
  *          should actually detect client devices.
  * @rescan: Callback to rescan the device.
@@ -114,6 +116,9 @@ struct device {
 
 	unsigned long dma_offset;
 
+	unsigned int dma_alignment;
+	unsigned int dma_max_seg_size;
+
 #ifdef CONFIG_CMD_DEVINFO
 	struct list_head info_list;
 #endif
@@ -3,6 +3,7 @@
 #define __DMA_DEVICES_H
 
 #include <linux/types.h>
+#include <linux/errno.h>
 
 /**
  * enum dma_transfer_direction - dma transfer mode and direction indicator
@@ -171,4 +172,13 @@ int dma_send(struct dma *dma, dma_addr_t src, size_t len, void *metadata);
 int dma_receive(struct dma *dma, dma_addr_t *dst, void *metadata);
 int dma_release(struct dma *dma);
 
+#ifdef CONFIG_DMADEVICES
+int dma_memcpy(dma_addr_t dst, dma_addr_t src, size_t len);
+#else
+static inline int dma_memcpy(dma_addr_t dst, dma_addr_t src, size_t len)
+{
+	return -ENODEV;
+}
+#endif
+
 #endif /* __DMA_DEVICES_H */
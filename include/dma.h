@@ -9,11 +9,13 @@
 #include <malloc.h>
 #include <xfuncs.h>
 #include <linux/align.h>
+#include <linux/string.h>
 
 #include <dma-dir.h>
 #include <asm/dma.h>
 #include <asm/io.h>
 #include <device.h>
+#include <linux/scatterlist.h>
 
 #define DMA_ADDRESS_BROKEN	((dma_addr_t *)NULL)
 #define DMA_DEVICE_BROKEN	((struct device *)NULL)
@@ -65,6 +67,28 @@ static inline void dma_set_mask(struct device *dev, u64 dma_mask)
 	dev->dma_mask = dma_mask;
 }
 
+/*
+ * Buffers not fulfilling the alignment are bounced by dma_map_single()
+ * when CONFIG_DMA_BOUNCE is enabled
+ */
+static inline void dma_set_alignment(struct device *dev, unsigned int align)
+{
+	dev->dma_alignment = align;
+}
+
+static inline void dma_set_max_seg_size(struct device *dev, unsigned int size)
+{
+	dev->dma_max_seg_size = size;
+}
+
+static inline unsigned int dma_get_max_seg_size(struct device *dev)
+{
+	if (dev && dev->dma_max_seg_size)
+		return dev->dma_max_seg_size;
+
+	return SG_MAX_LENGTH;
+}
+
 #define DMA_ERROR_CODE  (~(dma_addr_t)0)
 
 static inline int dma_mapping_error(struct device *dev, dma_addr_t dma_addr)
@@ -99,6 +123,52 @@ void arch_sync_dma_for_device(void *vaddr, size_t size,
 			      enum dma_data_direction dir);
 #endif
 
+/* clean and invalidate the whole data cache, see ARCH_HAS_DMA_SYNC_ALL */
+void arch_sync_dma_all_for_device(void);
+
+enum dma_sync_target {
+	DMA_SYNC_FOR_CPU,
+	DMA_SYNC_FOR_DEVICE,
+};
+
+struct dma_sync_range {
+	dma_addr_t addr;
+	size_t size;
+	enum dma_data_direction dir;
+};
+
+#define DMA_SYNC_BATCH_MAX	16
+
+struct dma_sync_batch {
+	struct device *dev;
+	enum dma_sync_target target;
+	unsigned int nr;
+	struct dma_sync_range range[DMA_SYNC_BATCH_MAX];
+};
+
+struct dma_sync_stats {
+	u64 requests;		/* sync requests from drivers */
+	u64 ops;		/* cache maintenance operations issued */
+	u64 merged;		/* requests merged into a preceding operation */
+	u64 full_flushes;	/* operations done on the whole cache */
+	u64 bytes;
+	u64 time_ns;
+};
+
+#ifdef CONFIG_DMA_SYNC_STATS
+void dma_sync_stats_get(struct dma_sync_stats *stats);
+void dma_sync_stats_reset(void);
+#else
+static inline void dma_sync_stats_get(struct dma_sync_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+static inline void dma_sync_stats_reset(void)
+{
+}
+#endif
+
 #if IN_PROPER
 void dma_sync_single_for_cpu(struct device *dev, dma_addr_t address,
 			     size_t size, enum dma_data_direction dir);
@@ -111,6 +181,12 @@ dma_addr_t dma_map_single(struct device *dev, void *ptr,
 
 void dma_unmap_single(struct device *dev, dma_addr_t dma_addr,
 		      size_t size, enum dma_data_direction dir);
+
+void dma_sync_batch_init(struct dma_sync_batch *batch, struct device *dev,
+			 enum dma_sync_target target);
+void dma_sync_batch_add(struct dma_sync_batch *batch, dma_addr_t addr,
+			size_t size, enum dma_data_direction dir);
+void dma_sync_batch_flush(struct dma_sync_batch *batch);
 #else
 /*
  * assumes buffers are in coherent/uncached memory, e.g. because
@@ -138,8 +214,39 @@ static inline void dma_unmap_single(struct device *dev, dma_addr_t dma_addr,
 				    size_t size, enum dma_data_direction dir)
 {
 }
+
+static inline void dma_sync_batch_init(struct dma_sync_batch *batch,
+				       struct device *dev,
+				       enum dma_sync_target target)
+{
+}
+
+static inline void dma_sync_batch_add(struct dma_sync_batch *batch,
+				      dma_addr_t addr, size_t size,
+				      enum dma_data_direction dir)
+{
+	barrier_data(addr);
+}
+
+static inline void dma_sync_batch_flush(struct dma_sync_batch *batch)
+{
+}
 #endif
 
+/* Scatter-gather mappings are only available in barebox proper */
+int dma_map_sg(struct device *dev, struct scatterlist *sgl, int nents,
+	       enum dma_data_direction dir);
+void dma_unmap_sg(struct device *dev, struct scatterlist *sgl, int nents,
+		  enum dma_data_direction dir);
+void dma_sync_sg_for_cpu(struct device *dev, struct scatterlist *sgl,
+			 int nents, enum dma_data_direction dir);
+void dma_sync_sg_for_device(struct device *dev, struct scatterlist *sgl,
+			    int nents, enum dma_data_direction dir);
+int dma_map_buf_sg(struct device *dev, struct sg_table *sgt, void *buf,
+		   size_t len, enum dma_data_direction dir);
+void dma_unmap_buf_sg(struct device *dev, struct sg_table *sgt,
+		      enum dma_data_direction dir);
+
 
 #ifndef dma_alloc_coherent
 void *dma_alloc_coherent(struct device *dev, size_t size, dma_addr_t *dma_handle);
@@ -36,6 +36,8 @@
 #define O_TMPFILE	020000000	/* open as temporary file in ramfs */
 #define O_PATH		040000000	/* open as path */
 #define O_CHROOT	0100000000	/* dirfd: stay within filesystem root */
+#define O_NOVERIFY	0200000000	/* data is verified by the reader, skip
+					   device level integrity checks */
 
 #if IN_PROPER
 int openat(int dirfd, const char *pathname, int flags);
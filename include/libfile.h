@@ -57,6 +57,6 @@ int cache_file(const char *path, char **newpath);
 
 int fixup_path_case(int dirfd, const char **path);
 
-int open_fdt(const char *filename, size_t *size);
+int open_fdt(const char *filename, size_t *size, int flags);
 
 #endif /* __LIBFILE_H */
@@ -30,6 +30,7 @@
  * @ecc_buf2:   ecc parity words buffer
  * @xi_tab:     GF(2^m) base for solving degree 2 polynomial roots
  * @syn:        syndrome buffer
+ * @syn_tab:    odd syndrome byte lookup tables
  * @cache:      log-based polynomial representation buffer
  * @elp:        error locator polynomial
  * @poly_2t:    temporary polynomials of degree 2t
@@ -49,6 +50,7 @@ struct bch_control {
 	uint32_t       *ecc_buf2;
 	unsigned int   *xi_tab;
 	unsigned int   *syn;
+	uint16_t       *syn_tab;
 	int            *cache;
 	struct gf_poly *elp;
 	struct gf_poly *poly_2t[4];
@@ -63,6 +65,12 @@ void bch_free(struct bch_control *bch);
 void bch_encode(struct bch_control *bch, const uint8_t *data,
 		unsigned int len, uint8_t *ecc);
 
+void bch_syndromes(struct bch_control *bch, const uint8_t *ecc,
+		   unsigned int *syn);
+
+void bch_syndromes_bitwise(struct bch_control *bch, const uint8_t *ecc,
+			   unsigned int *syn);
+
 int bch_decode(struct bch_control *bch, const uint8_t *data, unsigned int len,
 	       const uint8_t *recv_ecc, const uint8_t *calc_ecc,
 	       const unsigned int *syn, unsigned int *errloc);
@@ -114,6 +114,12 @@ struct nand_bbt_descr {
  * entire spare area. Must be used with NAND_BBT_USE_FLASH.
  */
 #define NAND_BBT_NO_OOB_BBM	0x00080000
+/*
+ * Keep a checksummed copy of the RAM-based BBT in the last good blocks of the
+ * device so that the full bad block scan can be skipped on the next boot.
+ * Only used without NAND_BBT_USE_FLASH.
+ */
+#define NAND_BBT_BAREBOX_CACHE	0x00100000
 
 /*
  * Flag set by nand_create_default_bbt_descr(), marking that the nand_bbt_descr
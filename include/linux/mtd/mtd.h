@@ -213,6 +213,12 @@ struct mtd_info {
 
 	/* ECC status information */
 	struct mtd_ecc_stats ecc_stats;
+	/* Page read statistics (NAND) */
+	struct mtd_read_stats {
+		u32 pages;		/* pages read from the array */
+		u32 cached;		/* pages served from the read cache */
+		u32 overlapped;		/* array reads overlapped with data out */
+	} read_stats;
 	/* Subpage shift (NAND) */
 	int subpage_sft;
 
@@ -1226,6 +1226,20 @@ struct nand_manufacturer {
 	void *priv;
 };
 
+/**
+ * struct nand_readcache_entry - ECC corrected copy of a page
+ * @page: Page number, -1 if the entry is unused
+ * @bitflips: Maximum number of bitflips reported when reading the page
+ * @used: Value of the readcache clock at the last access
+ * @buf: Page data
+ */
+struct nand_readcache_entry {
+	int page;
+	unsigned int bitflips;
+	unsigned long used;
+	u8 *buf;
+};
+
 /**
  * struct nand_secure_region - NAND secure region structure
  * @offset: Offset of the start of the secure region
@@ -1266,6 +1280,7 @@ struct nand_secure_region {
  * @bbt_md: Bad block table mirror descriptor
  * @badblock_pattern: Bad block scan pattern used for initial bad block scan
  * @bbt: Bad block table pointer
+ * @bbt_cache_seq: Sequence number of the last written barebox BBT cache copy
  * @page_shift: Number of address bits in a page (column address bits)
  * @phys_erase_shift: Number of address bits in a physical eraseblock
  * @chip_shift: Number of address bits in one chip
@@ -1277,6 +1292,10 @@ struct nand_secure_region {
  * @pagecache.bitflips: Number of bitflips of the cached page
  * @pagecache.page: Page number currently in the cache. -1 means no page is
  *                  currently cached
+ * @readcache: Recently read pages, see CONFIG_NAND_READ_CACHE_PAGES
+ * @readcache.entries: Cached pages
+ * @readcache.num: Number of entries
+ * @readcache.clock: Access counter used for LRU replacement
  * @buf_align: Minimum buffer alignment required by a platform
  * @lock: Lock protecting the suspended field. Also used to serialize accesses
  *        to the NAND device
@@ -1321,6 +1340,7 @@ struct nand_chip {
 	struct nand_bbt_descr *bbt_md;
 	struct nand_bbt_descr *badblock_pattern;
 	u8 *bbt;
+	u32 bbt_cache_seq;
 
 	/* Device internal layout */
 	unsigned int page_shift;
@@ -1336,6 +1356,11 @@ struct nand_chip {
 		unsigned int bitflips;
 		int page;
 	} pagecache;
+	struct {
+		struct nand_readcache_entry *entries;
+		unsigned int num;
+		unsigned long clock;
+	} readcache;
 	unsigned long buf_align;
 
 	/* Internals */
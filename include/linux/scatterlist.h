@@ -14,8 +14,15 @@ struct scatterlist {
 #define SG_CHAIN	0x01UL
 #define SG_END		0x02UL
 	unsigned int	length:30;
+	dma_addr_t	dma_address;	/* valid after dma_map_sg() */
 };
 
+/* largest power of two that fits into the length field */
+#define SG_MAX_LENGTH	(1U << 29)
+
+#define sg_dma_address(sg)	((sg)->dma_address)
+#define sg_dma_len(sg)		((sg)->length)
+
 struct sg_table {
 	struct scatterlist *sgl;	/* the list */
 	unsigned int nents;		/* number of mapped entries */
@@ -135,4 +142,9 @@ struct scatterlist *sg_last(struct scatterlist *s, unsigned int);
 void sg_init_table(struct scatterlist *, unsigned int);
 void sg_init_one(struct scatterlist *, const void *, unsigned int);
 
+int sg_alloc_table(struct sg_table *table, unsigned int nents);
+void sg_free_table(struct sg_table *table);
+int sg_alloc_table_from_buf(struct sg_table *table, const void *buf,
+			    size_t len, size_t max_seg);
+
 #endif /* _LINUX_SCATTERLIST_H */
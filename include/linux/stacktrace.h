@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __LINUX_STACKTRACE_H
+#define __LINUX_STACKTRACE_H
+
+#ifdef CONFIG_ARCH_STACKWALK
+/*
+ * Store up to @size return addresses of the current call chain, starting
+ * with the one into the caller of stack_trace_save() and skipping the
+ * first @skipnr. Returns the number of stored entries.
+ */
+unsigned int stack_trace_save(unsigned long *store, unsigned int size,
+			      unsigned int skipnr);
+#else
+static inline unsigned int stack_trace_save(unsigned long *store,
+					    unsigned int size,
+					    unsigned int skipnr)
+{
+	return 0;
+}
+#endif
+
+#endif /* __LINUX_STACKTRACE_H */
@@ -57,6 +57,7 @@ struct stat {
 	unsigned short st_gid;
 	const char *st_cdevname; /* barebox specific */
 	loff_t  st_size;
+	time_t  st_mtime;
 };
 
 #ifdef __cplusplus
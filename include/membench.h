@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __MEMBENCH_H
+#define __MEMBENCH_H
+
+#include <linux/types.h>
+
+/**
+ * struct membench_result - results of one membench run
+ * @size: working set size in bytes
+ * @copy: bandwidth of a[i] = b[i] in (decimal) MB/s
+ * @scale: bandwidth of a[i] = q * b[i] in MB/s
+ * @add: bandwidth of a[i] = b[i] + c[i] in MB/s
+ * @triad: bandwidth of a[i] = b[i] + q * c[i] in MB/s
+ * @latency_ps: average latency of dependent loads in picoseconds
+ */
+struct membench_result {
+	size_t size;
+	u64 copy;
+	u64 scale;
+	u64 add;
+	u64 triad;
+	u64 latency_ps;
+};
+
+int membench_run(void *buf, size_t size, unsigned int loops,
+		 struct membench_result *res);
+
+#endif /* __MEMBENCH_H */
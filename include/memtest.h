@@ -19,4 +19,14 @@ struct mem_test_resource *mem_test_biggest_region(struct list_head *list);
 int mem_test_bus_integrity(resource_size_t _start, resource_size_t _end, unsigned flags);
 int mem_test_moving_inversions(resource_size_t _start, resource_size_t _end, unsigned flags);
 
+/* bandwidth in (decimal) MB/s, copy counts the bytes copied */
+struct mem_test_bandwidth {
+	u64 write;
+	u64 read;
+	u64 copy;
+};
+
+int mem_test_bandwidth(resource_size_t _start, resource_size_t _end, unsigned flags,
+		       struct mem_test_bandwidth *bw);
+
 #endif /* __MEMTEST_H */
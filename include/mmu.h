@@ -73,11 +73,17 @@ static inline int remap_range(void *start, size_t size, maptype_t map_type)
 
 #ifdef CONFIG_MMUINFO
 int mmuinfo(void *addr);
+int mmuinfo_count_tables(void);
 #else
 static inline int mmuinfo(void *addr)
 {
 	return -ENOSYS;
 }
+
+static inline int mmuinfo_count_tables(void)
+{
+	return -ENOSYS;
+}
 #endif
 
 #endif
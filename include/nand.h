@@ -3,6 +3,7 @@
 #define __NAND_H__
 
 struct nand_bb;
+struct mtd_info;
 
 #ifdef CONFIG_MTD_NAND_CORE
 int dev_add_bb_dev(const char *filename, const char *name);
@@ -28,4 +29,13 @@ static inline void mtd_del_bb(struct mtd_info *mtd)
 }
 #endif
 
+#ifdef CONFIG_MTD_RAW_NAND
+int nand_regenerate_bbt(struct mtd_info *mtd);
+#else
+static inline int nand_regenerate_bbt(struct mtd_info *mtd)
+{
+	return -ENOSYS;
+}
+#endif
+
 #endif /* __NAND_H__ */
@@ -19,9 +19,18 @@
 
 typedef u32 phandle;
 
+struct arena;
+
+/* which parts of a node or property come from an arena */
+#define OF_ARENA_STRUCT		BIT(0)
+#define OF_ARENA_NAME		BIT(1)
+#define OF_ARENA_VALUE		BIT(2)	/* value of a property */
+#define OF_ARENA_FULL_NAME	BIT(3)	/* full_name of a node */
+
 struct property {
 	const char *name;
 	int length;
+	u8 arena_flags;
 	void *value;
 	const void *value_const;
 	struct list_head list;
@@ -38,6 +47,8 @@ struct device_node {
 	struct list_head list;
 	phandle phandle;
 	struct device *dev;
+	struct arena *arena;	/* only for root nodes, see of_arena_new_node() */
+	u8 arena_flags;
 };
 
 struct of_device_id {
@@ -83,6 +94,7 @@ void fdt_add_reserve_map(void *fdt);
 void fdt_print_reserve_map(const void *fdt);
 
 int fdt_machine_is_compatible(const struct fdt_header *fdt, size_t fdt_size, const char *compat);
+int fdt_file_machine_is_compatible(const char *filename, const char *compat);
 
 
 struct device;
@@ -176,6 +188,14 @@ extern struct property *of_new_property_const(struct device_node *node,
 					      const void *data, int len);
 extern struct property *__of_new_property(struct device_node *node,
 					  const char *name, void *data, int len);
+extern struct property *of_arena_new_property(struct arena *arena,
+					      struct device_node *node,
+					      const char *name,
+					      const void *data, int len);
+extern struct property *of_arena_new_property_const(struct arena *arena,
+						    struct device_node *node,
+						    const char *name,
+						    const void *data, int len);
 extern void of_delete_property(struct property *pp);
 extern struct property *of_rename_property(struct device_node *np,
 					   const char *old_name, const char *new_name);
@@ -208,6 +228,9 @@ extern struct device_node *of_find_node_with_property(
 
 extern struct device_node *of_new_node(struct device_node *parent,
 				const char *name);
+extern struct device_node *of_arena_new_node(struct arena *arena,
+					     struct device_node *parent,
+					     const char *name);
 extern struct device_node *of_create_node(struct device_node *root,
 					const char *path);
 extern void of_merge_nodes(struct device_node *np, const struct device_node *other);
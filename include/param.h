@@ -42,6 +42,7 @@ struct param_d {
 	struct bobject *bobj;
 	void *driver_priv;
 	struct list_head list;
+	struct hlist_node hash_node;
 	enum param_type type;
 };
 
@@ -13,6 +13,8 @@
 #include <linux/sizes.h>
 
 void pbl_barebox_uncompress(void *dest, void *compressed_start, unsigned int len);
+unsigned int pbl_barebox_uncompressed_len(const void *compressed_start,
+					  unsigned int len);
 int pbl_dtbz_uncompress(void *dest, void *compressed_start, unsigned long len);
 
 void fdt_find_mem(const void *fdt, unsigned long *membase, unsigned long *memsize);
@@ -0,0 +1,26 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#include <linux/types.h>
+
+#ifdef CONFIG_PROFILER
+int profile_start(u64 period_ns, unsigned int nstacks);
+void profile_stop(void);
+void profile_free(void);
+void profile_report(unsigned int top);
+int profile_write_folded(const char *filename);
+
+void profile_sample(void);
+void profile_account(unsigned long pc, u64 ns);
+#else
+static inline void profile_sample(void)
+{
+}
+
+static inline void profile_account(unsigned long pc, u64 ns)
+{
+}
+#endif
+
+#endif /* __PROFILE_H */
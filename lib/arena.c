@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Arena allocator for short-lived object trees
+ *
+ * Parsers like the device tree unflattener create thousands of small
+ * objects which all die together. Allocating them one by one from the
+ * heap costs time and fragments small malloc areas. An arena instead
+ * carves them out of a few larger blocks and frees everything at once.
+ *
+ * The arena itself and all of its blocks are talloc chunks: the blocks
+ * are children of the arena, so arena_free() is a single talloc_free().
+ * Arenas are always top-level contexts, they are tracked in a global list
+ * which talloc_free() of a parent would not update.
+ *
+ * Block sizes start small and double up to ARENA_BLOCK_MAX so that tiny
+ * trees don't waste memory. Requests bigger than a quarter of the next
+ * block get a block of their own, so they don't throw away the free
+ * space of the current one.
+ */
+
+#define pr_fmt(fmt) "arena: " fmt
+
+#include <common.h>
+#include <arena.h>
+#include <talloc.h>
+#include <linux/list.h>
+#include <linux/sizes.h>
+#include <asm/sections.h>
+
+#define ARENA_BLOCK_MIN		SZ_512
+#define ARENA_BLOCK_MAX		SZ_64K
+#define ARENA_ALIGN		8
+
+struct arena_block {
+	struct list_head list;
+	size_t size;
+} __aligned(ARENA_ALIGN);
+
+struct arena {
+	struct list_head list;		/* in the list of all arenas */
+	struct list_head blocks;
+	char *pos, *end;		/* free space in the current block */
+	size_t next_size;
+	size_t nblocks;
+	size_t size;
+	size_t used;
+};
+
+static LIST_HEAD(arenas);
+static size_t arena_size_total, arena_size_peak;
+
+static inline void *block_start(struct arena_block *block)
+{
+	return &block[1];
+}
+
+/**
+ * arena_new() - create a new arena
+ *
+ * Return: the new arena or NULL if out of memory
+ */
+struct arena *arena_new(void)
+{
+	struct arena *arena;
+
+	arena = talloc_zero_size(NULL, sizeof(*arena));
+	if (!arena)
+		return NULL;
+
+	INIT_LIST_HEAD(&arena->blocks);
+	arena->next_size = ARENA_BLOCK_MIN;
+	list_add(&arena->list, &arenas);
+
+	return arena;
+}
+EXPORT_SYMBOL(arena_new);
+
+/**
+ * arena_free() - free an arena and all memory allocated from it
+ *
+ * @arena: the arena, may be NULL
+ */
+void arena_free(struct arena *arena)
+{
+	if (!arena)
+		return;
+
+	list_del(&arena->list);
+	arena_size_total -= arena->size;
+
+	talloc_free(arena);
+}
+EXPORT_SYMBOL(arena_free);
+
+static void *arena_grow(struct arena *arena, size_t size)
+{
+	struct arena_block *block;
+	size_t bsize = arena->next_size;
+	bool dedicated = size > bsize / 4;
+
+	if (dedicated)
+		bsize = size;
+
+	block = talloc_size(arena, sizeof(*block) + bsize);
+	if (!block)
+		return NULL;
+
+	block->size = bsize;
+	list_add(&block->list, &arena->blocks);
+
+	arena->nblocks++;
+	arena->size += bsize;
+	arena_size_total += bsize;
+	arena_size_peak = max(arena_size_peak, arena_size_total);
+
+	if (dedicated)
+		return block_start(block);
+
+	arena->pos = block_start(block) + size;
+	arena->end = block_start(block) + bsize;
+
+	if (arena->next_size < ARENA_BLOCK_MAX)
+		arena->next_size *= 2;
+
+	return block_start(block);
+}
+
+/**
+ * arena_alloc() - allocate memory from an arena
+ *
+ * @arena: the arena
+ * @size: number of bytes
+ *
+ * The memory is aligned like malloc'ed memory and stays valid until the
+ * arena is freed. It must not be passed to free() or realloc().
+ *
+ * Return: pointer to the memory or NULL if out of memory
+ */
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	void *mem;
+
+	size = ALIGN(size ?: 1, ARENA_ALIGN);
+
+	if (size <= arena->end - arena->pos) {
+		mem = arena->pos;
+		arena->pos += size;
+	} else {
+		mem = arena_grow(arena, size);
+		if (!mem)
+			return NULL;
+	}
+
+	arena->used += size;
+
+	return mem;
+}
+EXPORT_SYMBOL(arena_alloc);
+
+void *arena_zalloc(struct arena *arena, size_t size)
+{
+	void *mem;
+
+	mem = arena_alloc(arena, size);
+	if (mem)
+		memset(mem, 0, size);
+
+	return mem;
+}
+EXPORT_SYMBOL(arena_zalloc);
+
+char *arena_strdup(struct arena *arena, const char *str)
+{
+	size_t len = strlen(str) + 1;
+	char *mem;
+
+	mem = arena_alloc(arena, len);
+	if (!mem)
+		return NULL;
+
+	return memcpy(mem, str, len);
+}
+EXPORT_SYMBOL(arena_strdup);
+
+/**
+ * arena_strdup_const() - duplicate a string into an arena if not read-only
+ *
+ * @arena: the arena
+ * @str: the string
+ *
+ * Return: @str if it's in barebox rodata, otherwise a copy in @arena or
+ * NULL if out of memory
+ */
+const char *arena_strdup_const(struct arena *arena, const char *str)
+{
+	if (is_barebox_rodata((ulong)str))
+		return str;
+
+	return arena_strdup(arena, str);
+}
+EXPORT_SYMBOL(arena_strdup_const);
+
+/**
+ * arena_contains() - check if memory was allocated from any arena
+ *
+ * @mem: pointer to check
+ *
+ * This lets code that handles both heap and arena objects decide whether
+ * a pointer may be freed individually.
+ *
+ * Return: true if @mem is inside a block of a live arena
+ */
+bool arena_contains(const void *mem)
+{
+	struct arena *arena;
+	struct arena_block *block;
+
+	if (!mem)
+		return false;
+
+	list_for_each_entry(arena, &arenas, list) {
+		list_for_each_entry(block, &arena->blocks, list) {
+			const void *start = block_start(block);
+
+			if (mem >= start && mem < start + block->size)
+				return true;
+		}
+	}
+
+	return false;
+}
+EXPORT_SYMBOL(arena_contains);
+
+void arena_get_stats(struct arena_stats *stats)
+{
+	struct arena *arena;
+
+	memset(stats, 0, sizeof(*stats));
+
+	list_for_each_entry(arena, &arenas, list) {
+		stats->arenas++;
+		stats->blocks += arena->nblocks;
+		stats->size += arena->size;
+		stats->used += arena->used;
+	}
+
+	stats->peak = arena_size_peak;
+}
+EXPORT_SYMBOL(arena_get_stats);
+
+void arena_print_stats(void)
+{
+	struct arena_stats stats;
+	size_t unused;
+
+	arena_get_stats(&stats);
+
+	unused = stats.size - stats.used;
+
+	printf("arenas: %zu with %zu blocks, %zu bytes (%zu used, %zu unused = %zu%%)\n",
+	       stats.arenas, stats.blocks, stats.size, stats.used, unused,
+	       stats.size ? unused * 100 / stats.size : 0);
+	printf("arena peak: %zu bytes\n", stats.peak);
+}
+EXPORT_SYMBOL(arena_print_stats);
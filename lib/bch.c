@@ -46,7 +46,9 @@
  * remainder lookup tables.
  *
  * The final stage of decoding involves the following internal steps:
- * a. Syndrome computation
+ * a. Syndrome computation (byte-wise, using one 256-entry table per odd
+ *    syndrome; the contributions of all ecc bytes are computed independently
+ *    and summed up)
  * b. Error locator polynomial computation using Berlekamp-Massey algorithm
  * c. Error locator root finding (by far the most expensive step)
  *
@@ -93,6 +95,9 @@
 
 #define BCH_ECC_MAX_WORDS      DIV_ROUND_UP(BCH_MAX_M * BCH_MAX_T, 32)
 
+/* syndrome table entry for b(a^j) = 0, which has no log */
+#define BCH_SYN_ZERO           0xffff
+
 #ifndef dbg
 #define dbg(_fmt, args...)     do {} while (0)
 #endif
@@ -364,10 +369,11 @@ static inline int a_ilog(struct bch_control *bch, unsigned int x)
 }
 
 /*
- * compute 2t syndromes of ecc polynomial, i.e. ecc(a^j) for j=1..2t
+ * compute 2t syndromes of ecc polynomial, i.e. ecc(a^j) for j=1..2t, one bit
+ * at a time
  */
-static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
-			      unsigned int *syn)
+static void compute_syndromes_bitwise(struct bch_control *bch, uint32_t *ecc,
+				      unsigned int *syn)
 {
 	int i, j, s;
 	unsigned int m;
@@ -400,6 +406,92 @@ static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
 		syn[2*j+1] = gf_sqr(bch, syn[j]);
 }
 
+/*
+ * compute 2t syndromes of ecc polynomial, 8 bits at a time: syn_tab holds,
+ * for each odd syndrome j=2k+1 and each 8-bit polynomial b(x), the log of
+ * b(a^j). Byte q of the ecc then contributes b_q(a^j).a^(j.d_q), where d_q is
+ * the degree of its lowest bit; terms are independent of each other, which
+ * keeps table lookups off the critical path.
+ */
+static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
+			      unsigned int *syn)
+{
+	int j, k, q;
+	unsigned int m, e, l, step, exp, v;
+	const uint16_t *tab;
+	const int t = GF_T(bch);
+	const int nbytes = DIV_ROUND_UP(bch->ecc_bits, 8);
+	const unsigned int n = GF_N(bch);
+
+	/* make sure extra bits in last ecc word are cleared */
+	m = bch->ecc_bits & 31;
+	if (m)
+		ecc[bch->ecc_bits/32] &= ~((1u << (32-m))-1);
+
+	for (k = 0; k < t; k++) {
+		e = 2*k+1;
+		step = modulo(bch, 8*e);
+		tab = bch->syn_tab+256*k;
+
+		/*
+		 * ecc bytes are left-aligned: the last byte has degree
+		 * -(8*nbytes-ecc_bits), a value we start from modulo n
+		 */
+		exp = mod_s(bch, n-modulo(bch, e*(8*nbytes-bch->ecc_bits)));
+		for (q = nbytes-1, v = 0; q >= 0; q--) {
+			l = tab[(ecc[q/4] >> (24-8*(q & 3))) & 0xff];
+			if (l != BCH_SYN_ZERO)
+				v ^= bch->a_pow_tab[mod_s(bch, l+exp)];
+			exp = mod_s(bch, exp+step);
+		}
+		syn[2*k] = v;
+	}
+
+	/* v(a^(2j)) = v(a^j)^2 */
+	for (j = 0; j < t; j++)
+		syn[2*j+1] = gf_sqr(bch, syn[j]);
+}
+
+static void bch_syndromes_common(struct bch_control *bch, const uint8_t *ecc,
+				 unsigned int *syn, bool bitwise)
+{
+	load_ecc8(bch, bch->ecc_buf, ecc);
+	if (bitwise)
+		compute_syndromes_bitwise(bch, bch->ecc_buf, syn);
+	else
+		compute_syndromes(bch, bch->ecc_buf, syn);
+}
+
+/**
+ * bch_syndromes - compute the 2t syndromes of an ecc difference
+ * @bch:      BCH control structure
+ * @ecc:      received ecc XORed with calculated ecc, @ecc_bytes long
+ * @syn:      array of 2*t syndromes to fill
+ *
+ * The result can be passed to bch_decode() as @syn.
+ */
+void bch_syndromes(struct bch_control *bch, const uint8_t *ecc,
+		   unsigned int *syn)
+{
+	bch_syndromes_common(bch, ecc, syn, false);
+}
+EXPORT_SYMBOL_GPL(bch_syndromes);
+
+/**
+ * bch_syndromes_bitwise - compute syndromes without lookup tables
+ * @bch:      BCH control structure
+ * @ecc:      received ecc XORed with calculated ecc, @ecc_bytes long
+ * @syn:      array of 2*t syndromes to fill
+ *
+ * Reference implementation of bch_syndromes(), kept for testing.
+ */
+void bch_syndromes_bitwise(struct bch_control *bch, const uint8_t *ecc,
+			   unsigned int *syn)
+{
+	bch_syndromes_common(bch, ecc, syn, true);
+}
+EXPORT_SYMBOL_GPL(bch_syndromes_bitwise);
+
 static void gf_poly_copy(struct gf_poly *dst, struct gf_poly *src)
 {
 	memcpy(dst, src, GF_POLY_SZ(src->deg));
@@ -1036,6 +1128,10 @@ int bch_decode(struct bch_control *bch, const uint8_t *data, unsigned int len,
 				return -EINVAL;
 			bch_encode(bch, data, len, NULL);
 		} else {
+			/* common case: no error, skip loading ecc words */
+			if (recv_ecc &&
+			    !memcmp(recv_ecc, calc_ecc, bch->ecc_bytes))
+				return 0;
 			/* load provided calculated ecc */
 			load_ecc8(bch, bch->ecc_buf, calc_ecc);
 		}
@@ -1043,14 +1139,14 @@ int bch_decode(struct bch_control *bch, const uint8_t *data, unsigned int len,
 		if (recv_ecc) {
 			load_ecc8(bch, bch->ecc_buf2, recv_ecc);
 			/* XOR received and calculated ecc */
-			for (i = 0, sum = 0; i < (int)ecc_words; i++) {
+			for (i = 0; i < (int)ecc_words; i++)
 				bch->ecc_buf[i] ^= bch->ecc_buf2[i];
-				sum |= bch->ecc_buf[i];
-			}
-			if (!sum)
-				/* no error found */
-				return 0;
 		}
+		for (i = 0, sum = 0; i < (int)ecc_words; i++)
+			sum |= bch->ecc_buf[i];
+		if (!sum)
+			/* no error found */
+			return 0;
 		compute_syndromes(bch, bch->ecc_buf, bch->syn);
 		syn = bch->syn;
 	}
@@ -1141,6 +1237,30 @@ static void build_mod8_tables(struct bch_control *bch, const uint32_t *g)
 	}
 }
 
+/*
+ * build syndrome tables: for each odd syndrome 2k+1 and each byte b, store
+ * log(b(a^(2k+1))) where b(x) = sum(b_i.x^i), or BCH_SYN_ZERO
+ */
+static void build_syn_tables(struct bch_control *bch)
+{
+	int k, b, i;
+	unsigned int v, val[256];
+	uint16_t *tab;
+	const int t = GF_T(bch);
+
+	for (k = 0; k < t; k++) {
+		tab = bch->syn_tab+256*k;
+		val[0] = 0;
+		tab[0] = BCH_SYN_ZERO;
+		for (b = 1; b < 256; b++) {
+			i = deg(b);
+			v = val[b ^ (1 << i)] ^ a_pow(bch, (2*k+1)*i);
+			val[b] = v;
+			tab[b] = v ? a_log(bch, v) : BCH_SYN_ZERO;
+		}
+	}
+}
+
 /*
  * build a base for factoring degree 2 polynomials
  */
@@ -1345,6 +1465,7 @@ struct bch_control *bch_init(int m, int t, unsigned int prim_poly,
 	bch->ecc_buf2  = bch_alloc(words*sizeof(*bch->ecc_buf2), &err);
 	bch->xi_tab    = bch_alloc(m*sizeof(*bch->xi_tab), &err);
 	bch->syn       = bch_alloc(2*t*sizeof(*bch->syn), &err);
+	bch->syn_tab   = bch_alloc(256*t*sizeof(*bch->syn_tab), &err);
 	bch->cache     = bch_alloc(2*t*sizeof(*bch->cache), &err);
 	bch->elp       = bch_alloc((t+1)*sizeof(struct gf_poly_deg1), &err);
 	bch->swap_bits = swap_bits;
@@ -1367,6 +1488,8 @@ struct bch_control *bch_init(int m, int t, unsigned int prim_poly,
 	build_mod8_tables(bch, genpoly);
 	kfree(genpoly);
 
+	build_syn_tables(bch);
+
 	err = build_deg2_base(bch);
 	if (err)
 		goto fail;
@@ -1395,6 +1518,7 @@ void bch_free(struct bch_control *bch)
 		kfree(bch->ecc_buf2);
 		kfree(bch->xi_tab);
 		kfree(bch->syn);
+		kfree(bch->syn_tab);
 		kfree(bch->cache);
 		kfree(bch->elp);
 
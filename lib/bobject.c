@@ -68,6 +68,10 @@ void bobject_del(struct bobject *bobj)
 	list_for_each_entry_safe(p, n, &bobj->parameters, list)
 		param_remove(p);
 
+	free(bobj->param_hash);
+	bobj->param_hash = NULL;
+	bobj->param_hash_bits = 0;
+
 	free_const(bobj->name);
 }
 EXPORT_SYMBOL(bobject_del);
@@ -142,6 +142,10 @@ static inline int unlz4(u8 *input, long in_len,
 		if (!fill) {
 			inp += 4;
 			size -= 4;
+			if (size < 0 || chunksize > size) {
+				error("chunk length is longer than input");
+				goto exit_2;
+			}
 		} else {
 			if (chunksize > lz4_compressbound(uncomp_chunksize)) {
 				error("chunk length is longer than allocated");
@@ -159,7 +163,12 @@ static inline int unlz4(u8 *input, long in_len,
 			out_len -= dest_len;
 		} else
 			dest_len = out_len;
+#ifdef LZ4_PREBOOT_UNTRUSTED
+		ret = lz4_decompress_unknownoutputsize(inp, chunksize, outp,
+				&dest_len);
+#else
 		ret = lz4_decompress(inp, &chunksize, outp, dest_len);
+#endif
 #else
 		dest_len = uncomp_chunksize;
 		ret = lz4_decompress_unknownoutputsize(inp, chunksize, outp,
@@ -889,20 +889,21 @@ int fixup_path_case(int fd, const char **path)
  * open_fdt - open a flattened device tree file and determine its size
  * @filename: path to the FDT file
  * @size: returns the total size from the FDT header
+ * @flags: additional flags to open the file with
  *
  * Opens the file, reads the FDT header to determine totalsize, validates
  * it against the file size, then reopens the file for sequential reading.
  *
  * Return: file descriptor on success, negative error code on failure
  */
-int open_fdt(const char *filename, size_t *size)
+int open_fdt(const char *filename, size_t *size, int flags)
 {
 	__be32 fdt_hdr[2];
 	u32 fdt_size;
 	struct stat st;
 	int fd, ret;
 
-	fd = open(filename, O_RDONLY);
+	fd = open(filename, O_RDONLY | flags);
 	if (fd < 0)
 		return fd;
 
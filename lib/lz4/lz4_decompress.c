@@ -48,6 +48,14 @@
 
 #include "lz4defs.h"
 
+/*
+ * Called with the end of the input that is about to be consumed, so that
+ * PBL can look at the input in step with the decoder.
+ */
+#ifndef LZ4_PREBOOT_INPUT
+#define LZ4_PREBOOT_INPUT(p)	do { } while (0)
+#endif
+
 static int lz4_uncompress(const char *source, char *dest, int osize)
 {
 	const BYTE *ip = (const BYTE *) source;
@@ -78,6 +86,8 @@ static int lz4_uncompress(const char *source, char *dest, int osize)
 			length += len;
 		}
 
+		LZ4_PREBOOT_INPUT(ip + length);
+
 		/* copy literals */
 		cpy = op + length;
 		if (unlikely(cpy > oend - COPYLENGTH)) {
@@ -196,6 +206,9 @@ static int lz4_uncompress_unknownoutputsize(const char *source, char *dest,
 				length += s;
 			}
 		}
+
+		LZ4_PREBOOT_INPUT(ip + length);
+
 		/* copy literals */
 		cpy = op + length;
 		if ((cpy > oend - COPYLENGTH) ||
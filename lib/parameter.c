@@ -29,6 +29,8 @@
 #include <linux/err.h>
 #include <file-list.h>
 #include <stringlist.h>
+#include <linux/hash.h>
+#include <linux/log2.h>
 
 static const char *param_type_string[] = {
 	[PARAM_TYPE_STRING] = "string",
@@ -51,11 +53,99 @@ const char *get_param_type(struct param_d *param)
 	return param_type_string[param->type];
 }
 
+/*
+ * Objects like the global and nv devices can have hundreds of parameters,
+ * which are looked up by name all the time. Once an object has at least
+ * PARAM_HASH_MIN entries, a hashed index is maintained alongside the
+ * sorted parameter list, which stays in place for iteration.
+ */
+#define PARAM_HASH_MIN		16
+
+static u32 param_name_hash(const char *name)
+{
+	u32 hash = 2166136261U;	/* FNV-1a */
+
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static struct hlist_head *param_hash_bucket(struct bobject *bobj,
+					    const char *name)
+{
+	return &bobj->param_hash[hash_32(param_name_hash(name),
+					 bobj->param_hash_bits)];
+}
+
+static int param_hash_resize(struct bobject *bobj, unsigned int bits)
+{
+	struct hlist_head *table;
+	struct param_d *p;
+
+	table = calloc(1 << bits, sizeof(*table));
+	if (!table)
+		return -ENOMEM;
+
+	free(bobj->param_hash);
+	bobj->param_hash = table;
+	bobj->param_hash_bits = bits;
+
+	list_for_each_entry(p, &bobj->parameters, list)
+		hlist_add_head(&p->hash_node, param_hash_bucket(bobj, p->name));
+
+	return 0;
+}
+
+static void param_hash_add(struct bobject *bobj, struct param_d *param)
+{
+	unsigned int bits;
+
+	INIT_HLIST_NODE(&param->hash_node);
+
+	bobj->num_params++;
+
+	if (!bobj->param_hash && bobj->num_params < PARAM_HASH_MIN)
+		return;
+
+	if (!bobj->param_hash ||
+	    bobj->num_params > 1U << (bobj->param_hash_bits - 1)) {
+		/* (re)build the index to keep the load factor at most 1/2 */
+		bits = ilog2(roundup_pow_of_two(bobj->num_params)) + 1;
+		if (!param_hash_resize(bobj, bits))
+			return;
+	}
+
+	/* without an index, lookups fall back to walking the list */
+	if (bobj->param_hash)
+		hlist_add_head(&param->hash_node,
+			       param_hash_bucket(bobj, param->name));
+}
+
+static void param_hash_del(struct bobject *bobj, struct param_d *param)
+{
+	bobj->num_params--;
+
+	if (!hlist_unhashed(&param->hash_node))
+		hlist_del_init(&param->hash_node);
+}
+
 struct param_d *get_param_by_name(bobject_t _bobj, const char *name)
 {
 	struct bobject *bobj = _bobj.bobj;
 	struct param_d *p;
 
+	if (bobj->param_hash) {
+		hlist_for_each_entry(p, param_hash_bucket(bobj, name), hash_node) {
+			if (!strcmp(p->name, name))
+				return p;
+		}
+
+		return NULL;
+	}
+
 	list_for_each_entry(p, &bobj->parameters, list) {
 		if (!strcmp(p->name, name))
 			return p;
@@ -183,6 +273,7 @@ static int __bobject_add_param(struct param_d *param, struct bobject *bobj,
 	param->flags = flags;
 	param->bobj = bobj;
 	list_add_sort(&param->list, &bobj->parameters, compare);
+	param_hash_add(bobj, param);
 
 	if (!bobj->local)
 		dev_param_init_from_nv(bobj_to_dev(bobj), name);
@@ -1208,6 +1299,7 @@ void param_remove(struct param_d *p)
 {
 	p->set(p->bobj, p, NULL);
 	list_del(&p->list);
+	param_hash_del(p->bobj, p);
 	free_const(p->name);
 	free(p);
 }
@@ -5,9 +5,11 @@
  * Scatterlist handling helpers.
  */
 
+#include <malloc.h>
 #include <linux/export.h>
 #include <linux/scatterlist.h>
 #include <linux/errno.h>
+#include <linux/kernel.h>
 
 /**
  * sg_next - return the next scatterlist entry in a list
@@ -140,3 +142,81 @@ void sg_init_one(struct scatterlist *sg, const void *buf, unsigned int buflen)
 	sg_set_buf(sg, buf, buflen);
 }
 EXPORT_SYMBOL(sg_init_one);
+
+/**
+ * sg_alloc_table - Allocate and initialize an sg table
+ * @table:	The sg table header to use
+ * @nents:	Number of entries in sg list
+ *
+ * Returns: 0 on success, negative error code otherwise. The table must be
+ * freed with sg_free_table().
+ **/
+int sg_alloc_table(struct sg_table *table, unsigned int nents)
+{
+	memset(table, 0, sizeof(*table));
+
+	if (!nents)
+		return -EINVAL;
+
+	table->sgl = malloc(nents * sizeof(*table->sgl));
+	if (!table->sgl)
+		return -ENOMEM;
+
+	sg_init_table(table->sgl, nents);
+	table->nents = table->orig_nents = nents;
+
+	return 0;
+}
+EXPORT_SYMBOL(sg_alloc_table);
+
+/**
+ * sg_free_table - Free a previously allocated sg table
+ * @table:	The sg table to free
+ **/
+void sg_free_table(struct sg_table *table)
+{
+	free(table->sgl);
+	table->sgl = NULL;
+	table->nents = table->orig_nents = 0;
+}
+EXPORT_SYMBOL(sg_free_table);
+
+/**
+ * sg_alloc_table_from_buf - Allocate an sg table describing a buffer
+ * @table:	The sg table header to use
+ * @buf:	Start of the buffer
+ * @len:	Length of the buffer
+ * @max_seg:	Maximum length of a single entry, 0 for no limit
+ *
+ * Description:
+ *   Splits @buf into as few entries as possible which are no longer than
+ *   @max_seg, e.g. to describe a transfer for a controller with a limited
+ *   descriptor length.
+ *
+ * Returns: 0 on success, negative error code otherwise.
+ **/
+int sg_alloc_table_from_buf(struct sg_table *table, const void *buf,
+			    size_t len, size_t max_seg)
+{
+	struct scatterlist *sg;
+	unsigned int i;
+	int ret;
+
+	if (!max_seg || max_seg > SG_MAX_LENGTH)
+		max_seg = SG_MAX_LENGTH;
+
+	ret = sg_alloc_table(table, DIV_ROUND_UP(len, max_seg));
+	if (ret)
+		return ret;
+
+	for_each_sgtable_sg(table, sg, i) {
+		size_t seg = min(len, max_seg);
+
+		sg_set_buf(sg, buf, seg);
+		buf += seg;
+		len -= seg;
+	}
+
+	return 0;
+}
+EXPORT_SYMBOL(sg_alloc_table_from_buf);
@@ -13,9 +13,45 @@
 #include <asm/sections.h>
 #include <pbl.h>
 #include <debug_ll.h>
+#include <asm/unaligned.h>
 
 #define STATIC static
 
+#ifdef CONFIG_PBL_VERIFY_PIGGY_STREAMING
+/*
+ * The piggy is hashed in windows just ahead of the decompressor, so that
+ * it is read from memory only once. piggy_hashed is the end of the hashed
+ * part, or all ones when no piggy is being verified.
+ */
+#define PIGGY_HASH_WINDOW	SZ_16K
+
+static struct digest *piggy_digest;
+static const u8 *piggy_hashed = (const u8 *)-1;
+static const u8 *piggy_end;
+
+static void noinline piggy_hash_upto(const u8 *p)
+{
+	const u8 *upto = p + PIGGY_HASH_WINDOW;
+
+	if (upto > piggy_end || upto < p)
+		upto = piggy_end;
+	if (upto <= piggy_hashed)
+		return;
+
+	digest_update(piggy_digest, piggy_hashed, upto - piggy_hashed);
+	piggy_hashed = upto;
+}
+
+#define LZ4_PREBOOT_INPUT(p)					\
+	do {							\
+		if ((const u8 *)(p) > piggy_hashed)		\
+			piggy_hash_upto(p);			\
+	} while (0)
+
+/* the input is only verified afterwards, use the bounds checking decoder */
+#define LZ4_PREBOOT_UNTRUSTED
+#endif
+
 #ifdef CONFIG_IMAGE_COMPRESSION_LZ4
 #include "../../../lib/decompress_unlz4.c"
 #endif
@@ -54,22 +90,29 @@ static void noinline errorfn(char *error)
 
 extern unsigned char sha_sum[];
 extern unsigned char sha_sum_end[];
+extern unsigned char piggy_uncompressed_len[];
 
-int pbl_barebox_verify(const void *compressed_start, unsigned int len,
-		       const void *hash, unsigned int hash_len)
+/*
+ * With PBL_VERIFY_PIGGY, the piggy can't be trusted before its hash has
+ * been checked. Take the uncompressed size recorded next to the hash at
+ * link time then instead of the one appended to the piggy.
+ */
+unsigned int pbl_barebox_uncompressed_len(const void *compressed_start,
+					  unsigned int len)
 {
-	struct sha256_state sha_state = { 0 };
-	struct digest d = { .ctx = &sha_state };
-	char computed_hash[SHA256_DIGEST_SIZE];
-	int i;
-	const char *char_hash = hash;
+	if (IS_ENABLED(CONFIG_PBL_VERIFY_PIGGY))
+		return get_unaligned_le32(piggy_uncompressed_len);
 
-	if (hash_len != SHA256_DIGEST_SIZE)
-		return -1;
+	return get_unaligned_le32(compressed_start + len - 4);
+}
+
+static int pbl_barebox_hash_check(const void *compressed_start,
+				  unsigned int len, const char *computed_hash,
+				  const void *hash)
+{
+	const char *char_hash = hash;
+	int i;
 
-	sha256_init(&d);
-	sha256_update(&d, compressed_start, len);
-	sha256_final(&d, computed_hash);
 	if (IS_ENABLED(CONFIG_DEBUG_LL)) {
 		puts_ll("CH ");
 
@@ -90,6 +133,62 @@ int pbl_barebox_verify(const void *compressed_start, unsigned int len,
 	return memcmp(hash, computed_hash, SHA256_DIGEST_SIZE);
 }
 
+int pbl_barebox_verify(const void *compressed_start, unsigned int len,
+		       const void *hash, unsigned int hash_len)
+{
+	u64 ctx[DIV_ROUND_UP(PBL_SHA256_CTX_SIZE, sizeof(u64))];
+	struct digest d = { .algo = pbl_sha256_algo(), .ctx = ctx };
+	char computed_hash[SHA256_DIGEST_SIZE];
+
+	if (hash_len != SHA256_DIGEST_SIZE)
+		return -1;
+
+	digest_init(&d);
+	digest_update(&d, compressed_start, len);
+	digest_final(&d, computed_hash);
+
+	return pbl_barebox_hash_check(compressed_start, len, computed_hash, hash);
+}
+
+#ifdef CONFIG_PBL_VERIFY_PIGGY_STREAMING
+static void pbl_barebox_uncompress_verify(void *dest, void *compressed_start,
+					  unsigned int len, const void *hash,
+					  unsigned int hash_len)
+{
+	u64 ctx[DIV_ROUND_UP(PBL_SHA256_CTX_SIZE, sizeof(u64))];
+	struct digest d = { .algo = pbl_sha256_algo(), .ctx = ctx };
+	char computed_hash[SHA256_DIGEST_SIZE];
+
+	if (hash_len != SHA256_DIGEST_SIZE)
+		panic("invalid hash length, refusing to decompress");
+
+	/* the decoder takes the output size from the unverified piggy */
+	if (get_unaligned_le32(compressed_start + len - 4) >
+	    pbl_barebox_uncompressed_len(compressed_start, len))
+		panic("uncompressed size too big, refusing to decompress");
+
+	digest_init(&d);
+	piggy_digest = &d;
+	piggy_hashed = compressed_start;
+	piggy_end = compressed_start + len;
+
+	decompress((void *)compressed_start,
+			len,
+			NULL, NULL,
+			dest, NULL, errorfn);
+
+	/* hash the remainder the decompressor has not looked at */
+	piggy_hash_upto(piggy_end);
+	piggy_hashed = (const u8 *)-1;
+	digest_final(&d, computed_hash);
+
+	if (pbl_barebox_hash_check(compressed_start, len, computed_hash, hash)) {
+		putc_ll('!');
+		panic("hash mismatch, refusing to start");
+	}
+}
+#endif
+
 void pbl_barebox_uncompress(void *dest, void *compressed_start, unsigned int len)
 {
 	uint32_t pbl_hash_len;
@@ -99,11 +198,17 @@ void pbl_barebox_uncompress(void *dest, void *compressed_start, unsigned int len
 		pbl_hash_start = sha_sum;
 		pbl_hash_end = sha_sum_end;
 		pbl_hash_len = pbl_hash_end - pbl_hash_start;
+#ifdef CONFIG_PBL_VERIFY_PIGGY_STREAMING
+		pbl_barebox_uncompress_verify(dest, compressed_start, len,
+					      pbl_hash_start, pbl_hash_len);
+		return;
+#else
 		if (pbl_barebox_verify(compressed_start, len, pbl_hash_start,
 				       pbl_hash_len) != 0) {
 			putc_ll('!');
 			panic("hash mismatch, refusing to decompress");
 		}
+#endif
 	}
 
 	decompress((void *)compressed_start,
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#define pr_fmt(fmt) "arena: " fmt
+
+#include <common.h>
+#include <bselftest.h>
+#include <arena.h>
+#include <linux/sizes.h>
+
+BSELFTEST_GLOBALS();
+
+static bool __selftest_check(bool cond, const char *func, int line)
+{
+	total_tests++;
+	if (cond)
+		return true;
+
+	pr_err("assertion failure at %s:%d\n", func, line);
+
+	failed_tests++;
+	return false;
+}
+#define selftest_check(cond) __selftest_check((cond), __func__, __LINE__)
+
+#define ARENA_TEST_ALLOCS	2000
+
+static void test_arena(void)
+{
+	struct arena_stats before, stats;
+	struct arena *arena;
+	u32 **ptrs, *big = NULL;
+	const char *str;
+	u8 *small;
+	int i;
+
+	arena_get_stats(&before);
+
+	arena = arena_new();
+	if (!selftest_check(arena))
+		return;
+
+	ptrs = arena_alloc(arena, ARENA_TEST_ALLOCS * sizeof(*ptrs));
+	if (!selftest_check(ptrs))
+		goto out;
+
+	for (i = 0; i < ARENA_TEST_ALLOCS; i++) {
+		ptrs[i] = arena_alloc(arena, 1 + i % 37);
+		if (!selftest_check(ptrs[i]))
+			goto out;
+		selftest_check(IS_ALIGNED((ulong)ptrs[i], 8));
+		*ptrs[i] = i;
+	}
+
+	for (i = 0; i < ARENA_TEST_ALLOCS; i++) {
+		if (*ptrs[i] != i) {
+			selftest_check(false);
+			break;
+		}
+	}
+
+	small = arena_zalloc(arena, 100);
+	selftest_check(small && !memchr_inv(small, 0, 100));
+
+	big = arena_alloc(arena, SZ_256K);
+	selftest_check(big);
+
+	selftest_check(arena_contains(ptrs[0]));
+	selftest_check(arena_contains(ptrs[ARENA_TEST_ALLOCS - 1]));
+	selftest_check(arena_contains(big));
+	selftest_check(!arena_contains(&stats));
+
+	str = arena_strdup_const(arena, "rodata");
+	selftest_check(!arena_contains(str));
+	str = arena_strdup(arena, str);
+	selftest_check(arena_contains(str) && !strcmp(str, "rodata"));
+
+	arena_get_stats(&stats);
+	selftest_check(stats.arenas == before.arenas + 1);
+	selftest_check(stats.size - before.size >= SZ_256K);
+	selftest_check(stats.used <= stats.size);
+	selftest_check(stats.peak >= stats.size);
+
+out:
+	arena_free(arena);
+
+	selftest_check(!arena_contains(big));
+
+	arena_get_stats(&stats);
+	selftest_check(stats.arenas == before.arenas);
+	selftest_check(stats.size == before.size);
+}
+bselftest(core, test_arena);
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <common.h>
+#include <stdlib.h>
+#include <bselftest.h>
+#include <clock.h>
+#include <malloc.h>
+#include <linux/bch.h>
+#include <linux/math64.h>
+
+BSELFTEST_GLOBALS();
+
+struct bch_params {
+	int m, t;
+	unsigned int len;
+};
+
+/* typical software ECC configurations for 512 and 1024 byte ECC steps */
+static const struct bch_params params[] = {
+	{ 13, 4, 512 },
+	{ 13, 8, 512 },
+	{ 14, 16, 1024 },
+	{ 14, 24, 1024 },
+};
+
+#define BCH_TEST_LOOPS		64
+#define BCH_BENCH_LOOPS		1000
+
+static void bch_flip_bit(u8 *buf, unsigned int bit)
+{
+	buf[bit / 8] ^= 1 << (bit % 8);
+}
+
+static void test_bch_one(struct bch_control *bch, const struct bch_params *p,
+			 u8 *data)
+{
+	unsigned int syn[2 * 24], ref[2 * 24], errloc[24], bits[24];
+	u8 ecc[64], calc[64], diff[64];
+	int i, j, loop, nerr, count;
+	u64 start, ns_tab = 0, ns_bit = 0;
+
+	for (loop = 0; loop < BCH_TEST_LOOPS; loop++) {
+		for (i = 0; i < p->len; i++)
+			data[i] = prandom_u32_max(256);
+
+		/* bch_encode() accumulates into the ecc buffer */
+		memset(ecc, 0, sizeof(ecc));
+		bch_encode(bch, data, p->len, ecc);
+
+		/* flip up to t distinct bits */
+		nerr = prandom_u32_max(p->t + 1);
+		for (i = 0; i < nerr; i++) {
+again:
+			bits[i] = prandom_u32_max(8 * p->len);
+			for (j = 0; j < i; j++)
+				if (bits[j] == bits[i])
+					goto again;
+			bch_flip_bit(data, bits[i]);
+		}
+
+		memset(calc, 0, sizeof(calc));
+		bch_encode(bch, data, p->len, calc);
+
+		for (i = 0; i < bch->ecc_bytes; i++)
+			diff[i] = ecc[i] ^ calc[i];
+
+		total_tests++;
+		bch_syndromes(bch, diff, syn);
+		bch_syndromes_bitwise(bch, diff, ref);
+		if (memcmp(syn, ref, 2 * p->t * sizeof(*syn))) {
+			printf("m=%d t=%d: syndrome mismatch with %d errors\n",
+			       p->m, p->t, nerr);
+			failed_tests++;
+			continue;
+		}
+
+		total_tests++;
+		count = bch_decode(bch, data, p->len, ecc, calc, NULL, errloc);
+		if (count != nerr) {
+			printf("m=%d t=%d: decoded %d errors, expected %d\n",
+			       p->m, p->t, count, nerr);
+			failed_tests++;
+			continue;
+		}
+
+		total_tests++;
+		for (i = 0; i < count; i++)
+			if (errloc[i] < 8 * p->len)
+				bch_flip_bit(data, errloc[i]);
+		memset(calc, 0, sizeof(calc));
+		bch_encode(bch, data, p->len, calc);
+		if (memcmp(ecc, calc, bch->ecc_bytes)) {
+			printf("m=%d t=%d: correction of %d errors failed\n",
+			       p->m, p->t, nerr);
+			failed_tests++;
+		}
+	}
+
+	/* benchmark the last ecc difference, which has up to t errors */
+	start = get_time_ns();
+	for (loop = 0; loop < BCH_BENCH_LOOPS; loop++)
+		bch_syndromes_bitwise(bch, diff, ref);
+	ns_bit = get_time_ns() - start;
+
+	start = get_time_ns();
+	for (loop = 0; loop < BCH_BENCH_LOOPS; loop++)
+		bch_syndromes(bch, diff, syn);
+	ns_tab = get_time_ns() - start;
+
+	pr_info("m=%d t=%-2d syndromes: bitwise %6llu ns, table %6llu ns\n",
+		p->m, p->t, div_u64(ns_bit, BCH_BENCH_LOOPS),
+		div_u64(ns_tab, BCH_BENCH_LOOPS));
+}
+
+static void test_bch(void)
+{
+	struct bch_control *bch;
+	u8 *data;
+	int i;
+
+	data = malloc(1024);
+	if (!data) {
+		total_tests++;
+		skipped_tests++;
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(params); i++) {
+		const struct bch_params *p = &params[i];
+
+		bch = bch_init(p->m, p->t, 0, false);
+		if (!bch) {
+			total_tests++;
+			skipped_tests++;
+			continue;
+		}
+
+		test_bch_one(bch, p, data);
+
+		bch_free(bch);
+	}
+
+	free(data);
+}
+bselftest(core, test_bch);
@@ -5,12 +5,16 @@
 #include <common.h>
 #include <bselftest.h>
 #include <boot.h>
+#include <blspec.h>
 #include <envfs.h>
+#include <fs.h>
+#include <libfile.h>
 #include <init.h>
+#include <of.h>
 
 BSELFTEST_GLOBALS();
 
-static void test_blspec(void)
+static void test_blspec_scan(void)
 {
 	struct bootentries *entries;
 	struct bootentry *entry;
@@ -26,15 +30,166 @@ static void test_blspec(void)
 
 	ret = bootentry_create_from_name(entries, "/env/data/test");
 	if (!assert_inteq(ret, 4))
-		return;
+		goto out;
 
 	if (!assert_cond(!list_empty(&entries->entries)))
-		return;
+		goto out;
 
 	bootentries_for_each_entry(entries, entry) {
 		assert_streq(expected[i], entry->path);
 		i++;
 	}
+out:
+	bootentries_free(entries);
+}
+
+#define TEST_PARTUUID	"3e5b6e52-6a0f-4b4e-9a6e-0b3c5d8f1a21"
+#define OTHER_PARTUUID	"9d1c0f7a-2b8e-4c35-8f54-7e6a1d2c3b40"
+
+/*
+ * The ramfs the test entries live on has neither a partition UUID nor
+ * modification times, so exercise the cache through its lookup interface.
+ */
+static void test_blspec_cache(void)
+{
+	const char *conf = "/boot/loader/entries/a.conf";
+	const char *stale = "/boot/loader/entries/b.conf";
+	const char *dtb = "/boot/board.dtb";
+	const char *outside = "/boot2/loader/entries/a.conf";
+	struct blspec_cache_entry *c;
+
+	if (!IS_ENABLED(CONFIG_BLSPEC_CACHE)) {
+		skipped_tests += 12;
+		return;
+	}
+
+	c = blspec_cache_lookup(TEST_PARTUUID, conf, 1000, 100);
+	if (!assert_cond((c && !c->checked)))
+		return;
+	c->checked = true;
+
+	/* unchanged file: the previous result is returned */
+	c = blspec_cache_lookup(TEST_PARTUUID, conf, 1000, 100);
+	assert_cond(c->checked);
+
+	/* modification time or size changed: the entry starts over */
+	c = blspec_cache_lookup(TEST_PARTUUID, conf, 2000, 100);
+	assert_cond(!c->checked);
+	c->checked = true;
+
+	c = blspec_cache_lookup(TEST_PARTUUID, conf, 2000, 200);
+	assert_cond(!c->checked);
+	c->checked = true;
+
+	/* same path on another partition is a different file */
+	c = blspec_cache_lookup(OTHER_PARTUUID, conf, 2000, 200);
+	assert_cond(!c->checked);
+	c->checked = true;
+
+	/* devicetree verdicts only hold for the compatible they were made for */
+	blspec_cache_set_compat("barebox,test-a");
+	c = blspec_cache_lookup(TEST_PARTUUID, dtb, 1000, 100);
+	c->checked = c->compatible = true;
+
+	blspec_cache_set_compat("barebox,test-a");
+	c = blspec_cache_lookup(TEST_PARTUUID, dtb, 1000, 100);
+	assert_cond((c->checked && c->compatible));
+
+	blspec_cache_set_compat("barebox,test-b");
+	c = blspec_cache_lookup(TEST_PARTUUID, dtb, 1000, 100);
+	assert_cond(!c->checked);
+	c->checked = true;
+
+	/* entries not seen while scanning their directory are dropped */
+	c = blspec_cache_lookup(TEST_PARTUUID, stale, 1000, 100);
+	c->checked = true;
+	c = blspec_cache_lookup(TEST_PARTUUID, outside, 1000, 100);
+	c->checked = true;
+
+	blspec_cache_scan_begin(TEST_PARTUUID, "/boot");
+	blspec_cache_lookup(TEST_PARTUUID, conf, 2000, 200);
+	blspec_cache_scan_end(TEST_PARTUUID, "/boot");
+
+	c = blspec_cache_lookup(TEST_PARTUUID, conf, 2000, 200);
+	assert_cond(c->checked);
+	c = blspec_cache_lookup(TEST_PARTUUID, stale, 1000, 100);
+	assert_cond(!c->checked);
+	c = blspec_cache_lookup(TEST_PARTUUID, dtb, 1000, 100);
+	assert_cond(!c->checked);
+	c = blspec_cache_lookup(TEST_PARTUUID, outside, 1000, 100);
+	assert_cond(c->checked);
+	c = blspec_cache_lookup(OTHER_PARTUUID, conf, 2000, 200);
+	assert_cond(c->checked);
+
+	/* clean up after ourselves */
+	blspec_cache_scan_begin(TEST_PARTUUID, "/");
+	blspec_cache_scan_end(TEST_PARTUUID, "/");
+	blspec_cache_scan_begin(OTHER_PARTUUID, "/");
+	blspec_cache_scan_end(OTHER_PARTUUID, "/");
+}
+
+/*
+ * fdt_file_machine_is_compatible() only reads the parts of the file it needs,
+ * it must come to the same result as checking the whole blob.
+ */
+static void test_blspec_fdt_file_compatible(void)
+{
+	const char *file = "/blspec-test.dtb";
+	const char *compats[] = {
+		"barebox,test-board", "barebox,test-soc", "barebox,test-other",
+		"barebox,test",
+	};
+	struct device_node *root;
+	struct fdt_header *fdt;
+	size_t size;
+	int i, ret;
+
+	root = of_new_node(NULL, NULL);
+	/* properties before the compatible have to be skipped */
+	of_property_write_u32(root, "#address-cells", 1);
+	of_property_write_string(root, "model", "barebox test board");
+	of_property_write_strings(root, "compatible", "barebox,test-board",
+				  "barebox,test-soc", NULL);
+	of_new_node(root, "child");
+
+	fdt = of_flatten_dtb(root);
+	of_delete_node(root);
+	if (!assert_cond(fdt))
+		return;
+
+	size = fdt32_to_cpu(fdt->totalsize);
+
+	ret = write_file(file, fdt, size);
+	if (!assert_inteq(ret, 0))
+		goto out;
+
+	for (i = 0; i < ARRAY_SIZE(compats); i++)
+		assert_inteq(fdt_file_machine_is_compatible(file, compats[i]),
+			     fdt_machine_is_compatible(fdt, size, compats[i]));
+
+	assert_cond(fdt_file_machine_is_compatible(file, "barebox,test-board") >
+		    fdt_file_machine_is_compatible(file, "barebox,test-soc"));
+	assert_inteq(fdt_file_machine_is_compatible(file, "barebox,test-other"), 0);
+
+	/* a truncated file must not be read past its end */
+	ret = write_file(file, fdt, size / 2);
+	if (assert_inteq(ret, 0))
+		assert_inteq(fdt_file_machine_is_compatible(file, "barebox,test-board"), 0);
+
+	unlink(file);
+
+	assert_inteq(fdt_file_machine_is_compatible(file, "barebox,test-board"), 0);
+out:
+	free(fdt);
+}
+
+static void test_blspec(void)
+{
+	test_blspec_scan();
+	/* scanning again must give the same entries in the same order */
+	test_blspec_scan();
+	test_blspec_cache();
+	test_blspec_fdt_file_compatible();
 }
 bselftest(parser, test_blspec);
 
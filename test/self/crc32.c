@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <common.h>
+#include <stdlib.h>
+#include <bselftest.h>
+#include <clock.h>
+#include <crc.h>
+#include <malloc.h>
+#include <linux/sizes.h>
+#include <linux/math64.h>
+
+BSELFTEST_GLOBALS();
+
+struct crc32_impl {
+	const char *name;
+	uint32_t (*fn)(uint32_t, const void *, unsigned int);
+	bool available;
+};
+
+static struct crc32_impl impls[] = {
+	{ "bytewise",	crc32_no_comp_bytewise },
+	{ "sliceby8",	crc32_no_comp_sliceby8 },
+	{ "arch",	crc32_no_comp_arch },
+	{ "default",	crc32_no_comp },
+};
+
+#define CRC32_BENCH_SIZE	SZ_1M
+#define CRC32_BENCH_LOOPS	4
+
+static void test_crc32_known(void)
+{
+	static const char check[] = "123456789";
+
+	total_tests++;
+
+	/* CRC-32/ISO-HDLC check value */
+	if (crc32(0, check, sizeof(check) - 1) != 0xcbf43926) {
+		printf("crc32 check value mismatch: %08x\n",
+		       crc32(0, check, sizeof(check) - 1));
+		failed_tests++;
+	}
+}
+
+static void test_crc32_compare(const u8 *buf)
+{
+	unsigned int off, len;
+	uint32_t ref, crc;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(impls); i++) {
+		struct crc32_impl *impl = &impls[i];
+
+		if (!impl->available) {
+			total_tests++;
+			skipped_tests++;
+			continue;
+		}
+
+		for (off = 0; off < 16; off++) {
+			for (len = 0; len < 1024; len += 1 + prandom_u32_max(37)) {
+				total_tests++;
+
+				ref = ~__pi_crc32(0x5a5a5a5a, buf + off, len);
+				crc = impl->fn(~0x5a5a5a5a, buf + off, len);
+
+				if (crc != ref) {
+					printf("%s: mismatch at offset %u length %u: %08x != %08x\n",
+					       impl->name, off, len, crc, ref);
+					failed_tests++;
+					break;
+				}
+			}
+		}
+
+		/* all must agree on a large, odd-sized buffer */
+		total_tests++;
+		ref = crc32_no_comp_bytewise(0, buf + 3, CRC32_BENCH_SIZE - 3);
+		crc = impl->fn(0, buf + 3, CRC32_BENCH_SIZE - 3);
+		if (crc != ref) {
+			printf("%s: mismatch on large buffer: %08x != %08x\n",
+			       impl->name, crc, ref);
+			failed_tests++;
+		}
+	}
+}
+
+static void crc32_benchmark(const u8 *buf)
+{
+	u64 start, ns;
+	int i, loop;
+
+	for (i = 0; i < ARRAY_SIZE(impls); i++) {
+		struct crc32_impl *impl = &impls[i];
+
+		if (!impl->available)
+			continue;
+
+		start = get_time_ns();
+		for (loop = 0; loop < CRC32_BENCH_LOOPS; loop++)
+			impl->fn(0, buf, CRC32_BENCH_SIZE);
+		ns = get_time_ns() - start;
+
+		pr_info("%-9s %6llu KiB/s\n", impl->name,
+			div64_u64((u64)CRC32_BENCH_LOOPS * CRC32_BENCH_SIZE *
+				  NSEC_PER_SEC / SZ_1K, ns ?: 1));
+	}
+}
+
+static void test_crc32(void)
+{
+	u8 *buf;
+	int i;
+
+	impls[0].available = true;
+	impls[1].available = IS_ENABLED(CONFIG_CRC32_SLICEBY8);
+	impls[2].available = crc32_arch_available();
+	impls[3].available = true;
+
+	test_crc32_known();
+
+	buf = malloc(CRC32_BENCH_SIZE);
+	if (!buf) {
+		total_tests++;
+		skipped_tests++;
+		return;
+	}
+
+	for (i = 0; i < CRC32_BENCH_SIZE; i++)
+		buf[i] = prandom_u32_max(256);
+
+	test_crc32_compare(buf);
+	crc32_benchmark(buf);
+
+	free(buf);
+}
+bselftest(core, test_crc32);
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <common.h>
+#include <bselftest.h>
+#include <crypto/ecdsa.h>
+
+BSELFTEST_GLOBALS();
+
+/*
+ * P-256 key and SHA-256 signature of "barebox ecdsa selftest", generated
+ * with openssl. The coordinates are in the least significant word first
+ * order keytoc uses, the signature is r || s, both big endian.
+ */
+static const uint64_t ecdsa_test_p256_x[] = {
+	0xa3866e7fa2947de8, 0x62569b5e75e156e8,
+	0xb311d882ba72c165, 0xb70dc842fbeb0246,
+};
+
+static const uint64_t ecdsa_test_p256_y[] = {
+	0x0a817b9e94c1ae90, 0x3107bf3b0f8ebb2a,
+	0x281468a88d93d656, 0x77c24dd3067901a5,
+};
+
+static const struct ecdsa_public_key ecdsa_test_p256 = {
+	.curve_name = "prime256v1",
+	.x = ecdsa_test_p256_x,
+	.y = ecdsa_test_p256_y,
+};
+
+static const uint8_t ecdsa_test_p256_hash[] = {
+	0x4c, 0x74, 0xd2, 0x27, 0xfd, 0x17, 0xd6, 0xca,
+	0x60, 0x4a, 0xc3, 0x56, 0x8c, 0x12, 0x5a, 0x2a,
+	0xfb, 0x97, 0x45, 0x07, 0x44, 0xb8, 0xeb, 0x42,
+	0xd7, 0x13, 0x29, 0x2e, 0x15, 0x42, 0x34, 0xd4,
+};
+
+static const uint8_t ecdsa_test_p256_sig[] = {
+	0xa7, 0x30, 0x6b, 0x89, 0xa3, 0x37, 0x90, 0x56,
+	0x53, 0x14, 0xad, 0x54, 0x66, 0x3c, 0x08, 0xb2,
+	0xe5, 0x93, 0xa3, 0x43, 0xb9, 0x52, 0xdf, 0xbb,
+	0xda, 0x95, 0xee, 0x42, 0x3a, 0xbb, 0x3e, 0x1e,
+	0xfd, 0x41, 0x4a, 0x5c, 0xdb, 0x39, 0x19, 0x7e,
+	0xe6, 0xdd, 0x6f, 0x7e, 0x19, 0xe3, 0x2e, 0x9e,
+	0x15, 0x11, 0x26, 0xb8, 0x2f, 0xdc, 0x8e, 0x90,
+	0x8e, 0xaf, 0xeb, 0xdc, 0x30, 0xa0, 0xb2, 0x5a,
+};
+
+static void test_ecdsa_p256(void)
+{
+	const struct ecdsa_public_key *key = &ecdsa_test_p256;
+	uint8_t sig[sizeof(ecdsa_test_p256_sig)];
+	uint8_t hash[sizeof(ecdsa_test_p256_hash)];
+	uint64_t y[ARRAY_SIZE(ecdsa_test_p256_y)];
+	struct ecdsa_public_key bad_key = *key;
+	int ret;
+
+	memcpy(sig, ecdsa_test_p256_sig, sizeof(sig));
+	memcpy(hash, ecdsa_test_p256_hash, sizeof(hash));
+
+	ret = ecdsa_verify(key, sig, sizeof(sig), hash);
+	assert_inteq(ret, 0);
+
+	/* flip a bit in s */
+	sig[sizeof(sig) - 1] ^= 1;
+	ret = ecdsa_verify(key, sig, sizeof(sig), hash);
+	assert_inteq(ret, -EKEYREJECTED);
+	sig[sizeof(sig) - 1] ^= 1;
+
+	/* r == 0 is out of range */
+	memset(sig, 0, sizeof(sig) / 2);
+	ret = ecdsa_verify(key, sig, sizeof(sig), hash);
+	assert_inteq(ret, -EBADMSG);
+	memcpy(sig, ecdsa_test_p256_sig, sizeof(sig));
+
+	/* the signature doesn't match another hash */
+	hash[0] ^= 0x80;
+	ret = ecdsa_verify(key, sig, sizeof(sig), hash);
+	assert_inteq(ret, -EKEYREJECTED);
+	hash[0] ^= 0x80;
+
+	/* a public key that is not on the curve must be refused */
+	memcpy(y, ecdsa_test_p256_y, sizeof(y));
+	y[0] ^= 1;
+	bad_key.y = y;
+	ret = ecdsa_verify(&bad_key, sig, sizeof(sig), hash);
+	assert_inteq(ret, -EINVAL);
+
+	/* and the untouched inputs still verify */
+	ret = ecdsa_verify(key, sig, sizeof(sig), hash);
+	assert_inteq(ret, 0);
+}
+
+static void test_ecdsa(void)
+{
+	test_ecdsa_p256();
+}
+bselftest(core, test_ecdsa);
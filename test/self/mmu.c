@@ -179,6 +179,43 @@ static void test_remap(void)
 	free(mirror);
 }
 
+/*
+ * Remapping a single page splits the block mapping it. Once the page has
+ * the attributes of its surroundings again, the split table must be
+ * merged back so that no page tables pile up.
+ */
+static void test_coalesce(void)
+{
+	int before, after, ret;
+	u8 *buffer;
+
+	if (!arch_can_remap() || mmuinfo_count_tables() < 0) {
+		skipped_tests += 3;
+		return;
+	}
+
+	buffer = memalign(SZ_2M, SZ_2M);
+	if (!buffer) {
+		skipped_tests += 3;
+		return;
+	}
+
+	before = mmuinfo_count_tables();
+
+	ret = remap_range(buffer + SZ_1M, SZ_4K, MAP_UNCACHED);
+	expect_success(ret, "remapping single page uncached");
+
+	ret = remap_range(buffer + SZ_1M, SZ_4K, MAP_DEFAULT);
+	expect_success(ret, "remapping single page back");
+
+	after = mmuinfo_count_tables();
+	__expect(-EILSEQ, after <= before,
+		 "page tables not coalesced: %d before, %d after remap",
+		 before, after);
+
+	free(buffer);
+}
+
 static bool zero_page_access_ok(void)
 {
 	struct memory_bank *bank;
@@ -267,11 +304,12 @@ static void test_mmu(void)
 {
 	if (efi_is_payload()) {
 		pr_info("MMU was not initialized by us\n");
-		skipped_tests += 23;
+		skipped_tests += 26;
 		return;
 	}
 
 	test_zero_page();
 	test_remap();
+	test_coalesce();
 }
 bselftest(core, test_mmu);
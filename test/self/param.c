@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <common.h>
+#include <stdlib.h>
+#include <bselftest.h>
+#include <bobject.h>
+#include <param.h>
+#include <clock.h>
+
+BSELFTEST_GLOBALS();
+
+#define NUM_PARAMS	400
+#define NUM_LOOKUPS	20000
+
+#define expect(cond, fmt, ...) ({ \
+	bool __cond = (cond); \
+	total_tests++; \
+	if (!__cond) { \
+		failed_tests++; \
+		printf("%s:%d: %s failed " fmt "\n", \
+		       __func__, __LINE__, #cond, ##__VA_ARGS__); \
+	} \
+	__cond; \
+})
+
+/* The lookup as done before parameters were indexed, for comparison */
+static struct param_d *param_lookup_linear(struct bobject *bobj, const char *name)
+{
+	struct param_d *p;
+
+	list_for_each_entry(p, &bobj->parameters, list) {
+		if (!strcmp(p->name, name))
+			return p;
+	}
+
+	return NULL;
+}
+
+static void param_name(char *buf, size_t len, unsigned int i)
+{
+	/* long common prefix like typical global.* variable names */
+	snprintf(buf, len, "bootchooser.system%u.remaining_attempts", i);
+}
+
+static void test_param_lookup(struct bobject *bobj)
+{
+	const char *val, *prev = NULL;
+	struct param_d *p;
+	char name[64], expected[16];
+	unsigned int i, count = 0;
+
+	for (i = 0; i < NUM_PARAMS; i++) {
+		param_name(name, sizeof(name), i);
+		snprintf(expected, sizeof(expected), "%u", i);
+
+		val = bobject_get_param(bobj, name);
+		if (!expect(val, "%s not found", name))
+			continue;
+		expect(!strcmp(val, expected), "%s = %s", name, val);
+	}
+
+	expect(!get_param_by_name(bobj, "bootchooser.nonexistent"), "");
+
+	list_for_each_entry(p, &bobj->parameters, list) {
+		if (prev)
+			expect(strcmp(prev, p->name) < 0, "%s before %s", prev, p->name);
+		prev = p->name;
+		count++;
+	}
+
+	expect(count == bobj->num_params, "%u != %u", count, bobj->num_params);
+}
+
+static void param_benchmark(struct bobject *bobj)
+{
+	char name[64];
+	u64 start, t_linear, t_hashed;
+	unsigned int i;
+
+	start = get_time_ns();
+	for (i = 0; i < NUM_LOOKUPS; i++) {
+		param_name(name, sizeof(name), i % NUM_PARAMS);
+		param_lookup_linear(bobj, name);
+	}
+	t_linear = get_time_ns() - start;
+
+	start = get_time_ns();
+	for (i = 0; i < NUM_LOOKUPS; i++) {
+		param_name(name, sizeof(name), i % NUM_PARAMS);
+		get_param_by_name(bobj, name);
+	}
+	t_hashed = get_time_ns() - start;
+
+	pr_info("%u lookups in %u parameters: linear %llums, indexed %llums\n",
+		NUM_LOOKUPS, bobj->num_params,
+		t_linear / NSEC_PER_MSEC, t_hashed / NSEC_PER_MSEC);
+}
+
+static void test_param(void)
+{
+	struct bobject *bobj;
+	struct param_d *p;
+	char name[64];
+	unsigned int i, j;
+
+	bobj = bobject_alloc("paramtest");
+	bobj->local = 1;
+
+	/* insert in an order different from the sorted one */
+	for (i = 0; i < NUM_PARAMS; i++) {
+		j = (i * 7) % NUM_PARAMS;
+		param_name(name, sizeof(name), j);
+		p = bobject_add_param_fixed(bobj, name, "%u", j);
+		expect(!IS_ERR(p), "adding %s: %pe", name, p);
+	}
+
+	p = bobject_add_param_fixed(bobj, name, "%u", 0);
+	expect(IS_ERR(p) && PTR_ERR(p) == -EEXIST, "re-adding %s", name);
+
+	test_param_lookup(bobj);
+	param_benchmark(bobj);
+
+	for (i = 0; i < NUM_PARAMS; i += 2) {
+		param_name(name, sizeof(name), i);
+		p = get_param_by_name(bobj, name);
+		if (expect(p, "%s not found", name))
+			param_remove(p);
+	}
+
+	for (i = 0; i < NUM_PARAMS; i++) {
+		param_name(name, sizeof(name), i);
+		p = get_param_by_name(bobj, name);
+		if (i % 2)
+			expect(p, "%s not found", name);
+		else
+			expect(!p, "%s still found after removal", name);
+	}
+
+	expect(bobj->num_params == NUM_PARAMS / 2, "%u params left",
+	       bobj->num_params);
+
+	bobject_free(bobj);
+}
+bselftest(core, test_param);
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <common.h>
+#include <stdlib.h>
+#include <bselftest.h>
+#include <clock.h>
+#include <malloc.h>
+#include <crypto/rsa.h>
+#include <asm/unaligned.h>
+
+BSELFTEST_GLOBALS();
+
+/* Exponentiation only needs an odd modulus, so random ones do for testing */
+static void rsa_test_make_modulus(uint32_t *mod, uint len)
+{
+	uint i;
+
+	for (i = 0; i < len; i++)
+		mod[i] = random32();
+
+	mod[0] |= 1;
+	mod[len - 1] |= 0x80000000;
+}
+
+static bool rsa_test_ge(const uint32_t *a, const uint32_t *b, uint len)
+{
+	int i;
+
+	for (i = len - 1; i >= 0; i--) {
+		if (a[i] != b[i])
+			return a[i] > b[i];
+	}
+
+	return true;
+}
+
+static void rsa_test_sub(uint32_t *a, const uint32_t *b, uint len)
+{
+	int64_t acc = 0;
+	uint i;
+
+	for (i = 0; i < len; i++) {
+		acc += (uint64_t)a[i] - b[i];
+		a[i] = acc;
+		acc >>= 32;
+	}
+}
+
+/* R^2 mod n, with R = 2^(32 * len), by doubling R mod n another 32 * len times */
+static void rsa_test_make_rr(uint32_t *rr, const uint32_t *mod, uint len)
+{
+	uint32_t carry;
+	uint i, bit;
+
+	/* the modulus has its top bit set, so R mod n = R - n */
+	memset(rr, 0, len * sizeof(*rr));
+	rsa_test_sub(rr, mod, len);
+
+	for (bit = 0; bit < 32 * len; bit++) {
+		carry = 0;
+		for (i = 0; i < len; i++) {
+			uint32_t next = rr[i] >> 31;
+
+			rr[i] = rr[i] << 1 | carry;
+			carry = next;
+		}
+
+		if (carry || rsa_test_ge(rr, mod, len))
+			rsa_test_sub(rr, mod, len);
+	}
+}
+
+static uint32_t rsa_test_n0inv(uint32_t n)
+{
+	uint32_t x = n;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		x *= 2 - n * x;
+
+	return -x;
+}
+
+static void test_rsa_pow_mod_one(uint bits, uint64_t exponent, int loops)
+{
+	uint len = bits / 32;
+	uint32_t *mod, *rr;
+	u8 *in, *out, *ref;
+	struct rsa_public_key key = {
+		.len = len,
+		.exponent = exponent,
+	};
+	u64 start, t_generic, t_fast;
+	int i, ret;
+
+	mod = malloc(len * sizeof(*mod));
+	rr = malloc(len * sizeof(*rr));
+	in = malloc(bits / 8);
+	out = malloc(bits / 8);
+	ref = malloc(bits / 8);
+	if (!mod || !rr || !in || !out || !ref) {
+		total_tests++;
+		skipped_tests++;
+		goto out;
+	}
+
+	rsa_test_make_modulus(mod, len);
+	rsa_test_make_rr(rr, mod, len);
+
+	key.modulus = mod;
+	key.rr = rr;
+	key.n0inv = rsa_test_n0inv(mod[0]);
+
+	for (i = 0; i < bits / 8; i++)
+		in[i] = prandom_u32_max(256);
+	in[0] &= 0x7f;	/* stay below the modulus */
+
+	total_tests++;
+
+	start = get_time_ns();
+	for (i = 0; i < loops; i++) {
+		memcpy(ref, in, bits / 8);
+		ret = rsa_pow_mod_generic(&key, ref);
+	}
+	t_generic = get_time_ns() - start;
+	if (ret) {
+		printf("%u bit, e=0x%llx: generic failed: %pe\n",
+		       bits, exponent, ERR_PTR(ret));
+		failed_tests++;
+		goto out;
+	}
+
+	start = get_time_ns();
+	for (i = 0; i < loops; i++) {
+		memcpy(out, in, bits / 8);
+		ret = rsa_pow_mod(&key, out);
+	}
+	t_fast = get_time_ns() - start;
+	if (ret) {
+		printf("%u bit, e=0x%llx: failed: %pe\n",
+		       bits, exponent, ERR_PTR(ret));
+		failed_tests++;
+		goto out;
+	}
+
+	if (memcmp(out, ref, bits / 8)) {
+		printf("%u bit, e=0x%llx: result mismatch\n", bits, exponent);
+		failed_tests++;
+		goto out;
+	}
+
+	pr_info("%4u bit, e=0x%-16llx generic %8lluus default %8lluus\n",
+		bits, exponent, t_generic / loops / 1000, t_fast / loops / 1000);
+out:
+	free(mod);
+	free(rr);
+	free(in);
+	free(out);
+	free(ref);
+}
+
+static void test_rsa_pow_mod(void)
+{
+	static const uint key_bits[] = { 1024, 2048, 3072, 4096 };
+	static const uint64_t exponents[] = {
+		3, 65537, 0xc0ffee01, 0xe0ec1b8ca1ULL, 0x9ff49b7889463e85ULL
+	};
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(key_bits); i++)
+		for (j = 0; j < ARRAY_SIZE(exponents); j++)
+			test_rsa_pow_mod_one(key_bits[i], exponents[j], 4);
+}
+bselftest(core, test_rsa_pow_mod);